@@ -0,0 +1,123 @@
+/**
+ * @file Autotuner.h
+ * @brief Successive-halving search over balancer parameters (threshold, gossip period, batch)
+ *
+ * DESIGN RATIONALE:
+ * - The best load_threshold, load_tick_ms (gossip interval) and
+ *   migration_batch_size depend on the workload, and trying them by hand
+ *   costs a full run each. The tuner drives Simulation itself
+ * - Successive halving: many candidates get a short run, the best 1/eta
+ *   of them a run eta times longer, and so on. Most of the budget goes to
+ *   the few promising settings, and short runs only have to rank, not measure
+ * - Every candidate of a rung runs with the same seed (common random
+ *   numbers), so differences come from the parameters, not the workload
+ * - Runs are wall-clock (no virtual time), but nodes mostly sleep, so the
+ *   candidates of a rung run in parallel threads at little distortion
+ *
+ * OBJECTIVE:
+ * - Minimize p99 latency subject to a message budget (network messages per
+ *   node per second); runs over budget rank after every feasible one, by
+ *   message rate
+ * - The Pareto front over (p99, message rate) is reported too, so the
+ *   budget can be revisited without rerunning
+ *
+ * FINAL EVALUATION:
+ * - Runs of different lengths are not comparable (short runs see less of
+ *   the tail), so nothing is compared across rungs
+ * - The first rung's front (every candidate, same length) picks the
+ *   front members; they and the base settings are rerun for the last
+ *   rung's length unless they already reached it, and the reported front
+ *   and baseline come from those same-length runs
+ *
+ * ACADEMIC CONTEXT:
+ * - Jamieson & Talwalkar, "Non-stochastic best arm identification and
+ *   hyperparameter optimization" (AISTATS 2016)
+ * - Li et al., "Hyperband: A novel bandit-based approach to hyperparameter
+ *   optimization" (JMLR 2018)
+ */
+
+#ifndef AUTOTUNER_H
+#define AUTOTUNER_H
+
+#include "Simulation.h"
+#include <vector>
+
+/**
+ * @struct TuningParameters
+ * @brief One point of the search space (copied into SimulationConfig::node)
+ */
+struct TuningParameters {
+    int load_threshold = 10;
+    int load_tick_ms = 500;
+    int migration_batch_size = 1;
+};
+
+/**
+ * @struct AutotuneConfig
+ * @brief Search space, objective and budget of one tuning run
+ */
+struct AutotuneConfig {
+    TuningParameters min_params{1, 50, 1};      ///< Inclusive lower bounds
+    TuningParameters max_params{20, 1000, 16};  ///< Inclusive upper bounds
+    double message_budget = 0.0;  ///< Max messages per node per second (0 = unconstrained)
+    int candidates = 12;          ///< Sampled log-uniformly; the base config is one of them
+    int eta = 3;                  ///< Keep 1/eta per rung, runs eta times longer
+    int min_duration_seconds = 4; ///< First-rung run length
+    int max_rungs = 3;
+    int parallelism = 4;          ///< Simulations run at once
+    unsigned seed = 1;            ///< Candidate sampling
+};
+
+/**
+ * @struct TuningTrial
+ * @brief One simulation run of one candidate
+ */
+struct TuningTrial {
+    TuningParameters params;
+    int rung = 0;
+    int duration_seconds = 0;
+    double p99_latency_ms = 0.0;
+    double mean_latency_ms = 0.0;
+    double messages_per_node_per_sec = 0.0;
+    double goodput = 0.0;
+    bool feasible = true;         ///< Within the message budget
+};
+
+/**
+ * @struct TuningReport
+ * @brief Outcome of Autotuner::run()
+ */
+struct TuningReport {
+    std::vector<TuningTrial> trials;  ///< Every run, in rung order
+    TuningTrial best;                 ///< Winner of the last rung
+    TuningTrial baseline;             ///< Base config's parameters, run as long as best
+    std::vector<TuningTrial> pareto;  ///< Non-dominated (p99, message rate), by p99, run as long as best
+};
+
+/**
+ * @class Autotuner
+ * @brief Tunes the balancer parameters of a base SimulationConfig
+ */
+class Autotuner {
+public:
+    /**
+     * @param base Workload and every other setting; its duration is ignored
+     * @param config Search space and objective
+     */
+    Autotuner(const SimulationConfig& base, const AutotuneConfig& config);
+
+    TuningReport run();
+
+private:
+    /// Samples the candidates; the base config's own parameters come first
+    std::vector<TuningParameters> sampleCandidates();
+
+    /// Runs every candidate for one rung, config_.parallelism at a time
+    std::vector<TuningTrial> runRung(const std::vector<TuningParameters>& candidates,
+                                     int rung, int duration_seconds);
+
+    SimulationConfig base_;
+    AutotuneConfig config_;
+};
+
+#endif // AUTOTUNER_H
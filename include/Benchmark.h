@@ -0,0 +1,46 @@
+/**
+ * @file Benchmark.h
+ * @brief Registry of named experiments runnable from the command line
+ *
+ * DESIGN RATIONALE:
+ * - Each benchmark answers one evaluation question by running several
+ *   Simulation configurations and printing a comparison table
+ * - Registered by name so main() stays a thin command-line dispatcher:
+ *     ./load_balancer --benchmark overload
+ * - Logging is disabled while benchmarks run (see Logger::setEnabled) so the
+ *   measurement is not dominated by log I/O
+ *
+ * ADDING A BENCHMARK:
+ * 1. Write a static function in Benchmark.cpp returning an exit code
+ * 2. Add an entry {name, description, function} to the registry table
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @struct BenchmarkInfo
+ * @brief One registered experiment
+ */
+struct BenchmarkInfo {
+    std::string name;           ///< Command-line name
+    std::string description;    ///< One-line summary for --list-benchmarks
+    int (*run)();               ///< Entry point; returns process exit code
+};
+
+/**
+ * @brief Returns all registered benchmarks (in registration order)
+ */
+const std::vector<BenchmarkInfo>& getBenchmarks();
+
+/**
+ * @brief Runs the named benchmark
+ * @param name Benchmark name as listed by getBenchmarks()
+ * @return Exit code of the benchmark, or 1 if the name is unknown
+ */
+int runBenchmark(const std::string& name);
+
+#endif // BENCHMARK_H
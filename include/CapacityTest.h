@@ -0,0 +1,95 @@
+/**
+ * @file CapacityTest.h
+ * @brief Open-loop load sweep that finds the saturation throughput of a configuration
+ *
+ * DESIGN RATIONALE:
+ * - Capacity is where queues start growing without bound, not where
+ *   latency looks bad: below it every offered task is eventually served,
+ *   above it the backlog (or the shed count) grows linearly with time
+ * - Open loop: arrivals follow the offered rate whatever the latency, so a
+ *   slow configuration cannot hide its saturation by slowing the client
+ * - Each step is a fresh Simulation at one arrival rate, so a step never
+ *   inherits the backlog of the previous one. The ramp stops at the first
+ *   saturated step, then bisection narrows the boundary
+ *
+ * SATURATION TEST (per step):
+ * - The backlog (tasks generated but not completed: queued, running, in
+ *   flight or shed) grows faster than growth_tolerance x the offered rate
+ *   over the second half of the run; the first half is warm-up
+ * - Shed tasks count as backlog, so bounded queues and admission control
+ *   saturate too, instead of looking stable with a full queue
+ *
+ * ACADEMIC CONTEXT:
+ * - Jain, "The Art of Computer Systems Performance Analysis" (1991):
+ *   knee and usable capacity of the throughput-load curve
+ * - Schroeder, Wierman & Harchol-Balter, "Open versus closed: A cautionary
+ *   tale" (NSDI 2006)
+ */
+
+#ifndef CAPACITYTEST_H
+#define CAPACITYTEST_H
+
+#include "Simulation.h"
+#include <vector>
+
+/**
+ * @struct CapacityTestConfig
+ * @brief Ramp, bisection and saturation settings
+ */
+struct CapacityTestConfig {
+    double start_load = 0.5;         ///< First step, as a fraction of estimated capacity
+    double load_step = 0.25;         ///< Ramp increment
+    double max_load = 3.0;           ///< Ramp gives up above this
+    double resolution = 0.02;        ///< Bisection stops at this load-factor gap
+    int step_seconds = 10;           ///< Generation window of each step
+    double growth_tolerance = 0.05;  ///< Fraction of the offered rate (see SATURATION TEST)
+};
+
+/**
+ * @struct CapacityPoint
+ * @brief One step of the sweep
+ */
+struct CapacityPoint {
+    double load_factor = 0.0;         ///< Offered load / Simulation::estimateCapacity()
+    double offered_rate = 0.0;        ///< Tasks generated per second
+    double throughput = 0.0;          ///< Tasks completed per second (goodput, incl. warm-up)
+    double p50_latency_ms = 0.0;
+    double p99_latency_ms = 0.0;
+    double backlog_growth_per_sec = 0.0;  ///< Unserved tasks accumulating, per second
+    bool saturated = false;
+};
+
+/**
+ * @struct CapacityReport
+ * @brief Latency-throughput curve and the saturation point
+ */
+struct CapacityReport {
+    std::vector<CapacityPoint> curve;  ///< Every step, by load factor
+    bool found = false;                ///< A saturated step was reached below max_load
+    CapacityPoint knee;                ///< Highest unsaturated step (the usable capacity)
+};
+
+/**
+ * @class CapacityTest
+ * @brief Sweeps the arrival rate of a base SimulationConfig
+ */
+class CapacityTest {
+public:
+    /**
+     * @param base Cluster and policy under test; its arrival interval and
+     *        duration are replaced at each step
+     * @param config Sweep settings
+     */
+    CapacityTest(const SimulationConfig& base, const CapacityTestConfig& config);
+
+    CapacityReport run();
+
+private:
+    /// Runs one step at load_factor x estimated capacity
+    CapacityPoint measure(double load_factor);
+
+    SimulationConfig base_;
+    CapacityTestConfig config_;
+};
+
+#endif // CAPACITYTEST_H
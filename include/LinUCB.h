@@ -0,0 +1,70 @@
+/**
+ * @file LinUCB.h
+ * @brief Linear upper-confidence-bound contextual bandit (ridge regression + UCB)
+ *
+ * DESIGN RATIONALE:
+ * - One shared linear model per node scores every candidate peer from a
+ *   small context vector, so experience with one peer generalizes to
+ *   others in a similar state (loaded, stale, slow to acknowledge)
+ * - Score = predicted reward + alpha * uncertainty; untried regions of the
+ *   context space look optimistic and get explored
+ * - The inverse design matrix is kept directly and updated with
+ *   Sherman-Morrison, so both scoring and learning are O(d^2) with no
+ *   matrix inversion: cheap enough for every routing decision
+ *
+ * ACADEMIC CONTEXT:
+ * - Li, Chu, Langford, Schapire, "A contextual-bandit approach to
+ *   personalized news article recommendation" (WWW 2010), LinUCB
+ * - Auer, "Using confidence bounds for exploitation-exploration
+ *   trade-offs" (JMLR 2002)
+ *
+ * THREAD SAFETY: None. Owners serialize access (PeerNode holds a mutex).
+ */
+
+#ifndef LINUCB_H
+#define LINUCB_H
+
+#include <array>
+#include <cstddef>
+
+/// Context dimensions: bias, peer load, view age, ack latency, ack rate
+const size_t BANDIT_DIMS = 5;
+
+/// One routing context (features of a candidate peer at decision time)
+using BanditContext = std::array<double, BANDIT_DIMS>;
+
+/**
+ * @class LinUCB
+ * @brief Ridge-regression reward model with an upper confidence bonus
+ */
+class LinUCB {
+public:
+    /**
+     * @brief Creates an untrained model (A = I, b = prior, so theta = prior)
+     * @param alpha Exploration weight on the confidence width (>= 0)
+     * @param prior Initial weights; acts as one pseudo-observation per
+     *        dimension, so early decisions follow the prior, not noise
+     */
+    LinUCB(double alpha, const BanditContext& prior);
+
+    /**
+     * @brief Optimistic reward estimate for a context
+     * @return theta . x + alpha * sqrt(x' A^-1 x)
+     */
+    double score(const BanditContext& x) const;
+
+    /**
+     * @brief Learns from one observed reward
+     * @param x Context the decision was made in
+     * @param reward Observed reward (higher is better)
+     */
+    void update(const BanditContext& x, double reward);
+
+private:
+    double alpha_;
+    std::array<double, BANDIT_DIMS * BANDIT_DIMS> a_inv_;  ///< A^-1, row-major
+    BanditContext b_;                                      ///< Sum of reward * x
+    BanditContext theta_;                                  ///< A^-1 b (kept current)
+};
+
+#endif // LINUCB_H
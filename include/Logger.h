@@ -34,6 +34,7 @@
 #include <fstream>
 #include <mutex>
 #include <memory>
+#include <atomic>
 
 /**
  * @class Logger
@@ -128,6 +129,25 @@ public:
      */
     void setLogFile(const std::string& filename);
 
+    /**
+     * @brief Enables or disables all logging output
+     * @param enabled false = every log call returns immediately
+     *
+     * BENCHMARKING:
+     * - Per-event logging takes a global mutex and flushes a line per call
+     * - That serializes all nodes and distorts latency measurements
+     * - Benchmarks disable logging; the interactive simulation keeps it on
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Checks whether logging is enabled
+     * @return true if log calls produce output
+     *
+     * Callers building expensive messages can skip the work when disabled.
+     */
+    bool isEnabled() const;
+
     // Prevent copying and assignment (singleton must have single instance)
     Logger(const Logger&) = delete;              ///< No copy constructor
     Logger& operator=(const Logger&) = delete;    ///< No copy assignment
@@ -168,6 +188,7 @@ private:
     // Output destination
     std::ofstream log_file_;  ///< File stream for logging (optional)
     bool use_file_;           ///< Flag: true = log to file, false = log to console
+    std::atomic<bool> enabled_;  ///< Flag: false = drop all messages (lock-free check)
 
     /**
      * DESIGN NOTE: Why not use both console and file simultaneously?
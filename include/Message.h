@@ -14,13 +14,37 @@
  * - Type system prevents mixing different protocol layers (application vs. control)
  *
  * PROTOCOL DESIGN:
- * - LOAD_UPDATE: Gossip protocol for disseminating load information
+ * - LOAD_UPDATE: Gossip protocol for disseminating load information; the
+ *   copy sent to a node's buddy also carries its replica delta
  * - TASK_TRANSFER: Remote procedure call (RPC) for task migration
  * - TASK_REQUEST: Pull-based work stealing (not yet implemented)
  * - PEER_DISCOVERY: Membership protocol for dynamic topology (future work)
+ * - GOSSIP_DIGEST / GOSSIP_DIGEST_REPLY: Push-pull anti-entropy with batched,
+ *   varint-packed (node, version, load) entries (see GossipDigest.h)
+ * - TASK_COMPLETE: Executing node tells a task's last sender it finished,
+ *   letting robust routing verify peers run what they accept
+ * - TASK_RELEASED: A node that passed a task on or shed it tells the task's
+ *   previous hop, which stops counting it as outstanding there
+ * - DEPENDENCY_RESOLVED: Executing node tells the home node of a DAG task's
+ *   successors that this predecessor finished (and where its output lives)
+ * - TASK_CANCEL: Carries only a task ID; each node that forwarded the task
+ *   passes the cancel on to where it sent it
+ * - CACHE_HINT: Content keys the sender has results for, so peers can
+ *   route duplicate requests to it
+ * - TASK_WITHDRAW: Task IDs (varint payload) the sender recovered from the
+ *   receiver's mirror while it looked failed; the receiver drops the ones
+ *   it still has queued, so each task runs once
+ *
+ * HEADER PIGGYBACKING:
+ * - Every message a PeerNode sends carries the sender's current load and a
+ *   per-sender monotonic version, whatever its type
+ * - The version is the sender's Lamport clock at send time, so it is both
+ *   monotonic per sender and consistent with causality across nodes
+ * - Receivers refresh their view of the sender from any message, so task
+ *   traffic doubles as gossip at zero extra message cost
  *
  * FUTURE EXTENSIONS:
- * - Could add sequence numbers for ordering (causal or total order)
+ * - Could add sequence numbers for ordering (total order)
  * - Could add checksums or signatures for Byzantine fault tolerance
  * - Could add TTL (time-to-live) for gossip message propagation limits
  */
@@ -30,6 +54,9 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <array>
+#include <cstdint>
 #include "Task.h"
 
 /**
@@ -42,11 +69,66 @@
  */
 enum class MessageType {
     LOAD_UPDATE,     ///< Broadcast: Node announces current queue length (gossip)
-    TASK_REQUEST,    ///< Pull: Node requests work from a peer (future work)
+    TASK_REQUEST,    ///< Pull: steal up to n tasks from an overloaded peer (SOS)
     TASK_TRANSFER,   ///< Push: Node sends a task to a peer for execution
-    PEER_DISCOVERY   ///< Membership: Node announces presence (future work)
+    PEER_DISCOVERY,  ///< Membership: Node announces presence (future work)
+    GOSSIP_DIGEST,      ///< Anti-entropy push: batch of load entries the sender knows
+    GOSSIP_DIGEST_REPLY, ///< Anti-entropy pull: entries the digest's sender was missing
+    TASK_COMPLETE,      ///< Ack: a task this receiver transferred has finished
+    DEPENDENCY_RESOLVED, ///< DAG: attached predecessor finished on the sender
+    TASK_CANCEL,        ///< Cancel by task ID, forwarded along the task's migration path
+    CACHE_HINT,         ///< Content keys newly cached by the sender (varint payload)
+    TASK_BATCH,         ///< Push: several tasks in one transfer (periodic balancing)
+    EXCHANGE_OFFER,     ///< Dimension exchange: sender's load, sent to this round's partner
+    HELP_WANTED,        ///< SOS rumor: origin is overloaded (relayed up to a TTL)
+    SNAPSHOT_MARKER,    ///< Chandy-Lamport marker: closes the sender's channel for a snapshot
+    TASK_RELEASED,      ///< Ack: a task this receiver transferred was passed on or shed
+    TASK_WITHDRAW       ///< Recovered elsewhere: drop these queued task IDs (varint payload)
 };
 
+/**
+ * @enum MessageClass
+ * @brief Coarse traffic class of a MessageType, used for rate budgets
+ *
+ * A control-plane budget such as "50 gossip messages/s per node" covers
+ * every dissemination message, whichever protocol (broadcast or digest)
+ * produced it, so limits are set per class rather than per type.
+ */
+enum class MessageClass {
+    GOSSIP,      ///< LOAD_UPDATE, GOSSIP_DIGEST, GOSSIP_DIGEST_REPLY
+    TRANSFER,    ///< TASK_TRANSFER, TASK_BATCH, EXCHANGE_OFFER, TASK_COMPLETE, ...
+    MEMBERSHIP,  ///< PEER_DISCOVERY
+    COUNT        ///< Number of classes (array sizing)
+};
+
+/**
+ * @brief Maps a message type to its traffic class
+ */
+inline MessageClass messageClassOf(MessageType type) {
+    switch (type) {
+        case MessageType::LOAD_UPDATE:
+        case MessageType::GOSSIP_DIGEST:
+        case MessageType::GOSSIP_DIGEST_REPLY:
+        case MessageType::CACHE_HINT:
+        case MessageType::HELP_WANTED:
+            return MessageClass::GOSSIP;
+        case MessageType::TASK_REQUEST:
+        case MessageType::TASK_TRANSFER:
+        case MessageType::TASK_COMPLETE:
+        case MessageType::TASK_RELEASED:
+        case MessageType::TASK_WITHDRAW:
+        case MessageType::DEPENDENCY_RESOLVED:
+        case MessageType::TASK_CANCEL:
+        case MessageType::TASK_BATCH:
+        case MessageType::EXCHANGE_OFFER:
+        case MessageType::SNAPSHOT_MARKER:  // Must share the task channel's fate
+            return MessageClass::TRANSFER;
+        case MessageType::PEER_DISCOVERY:
+            return MessageClass::MEMBERSHIP;
+    }
+    return MessageClass::MEMBERSHIP;
+}
+
 /**
  * @class Message
  * @brief Encapsulates all inter-node communication in the distributed system
@@ -129,6 +211,69 @@ public:
      */
     int getLoadValue() const;
 
+    /**
+     * @brief Sets the transfer credits granted to the receiver (LOAD_UPDATE)
+     * @param credits Number of tasks the receiver may migrate to the sender
+     *
+     * CREDIT-BASED FLOW CONTROL:
+     * - Piggybacked on LOAD_UPDATE, so granting credits costs no extra messages
+     * - Each grant replaces the previous one for that link (not additive)
+     * - Similar to HTTP/2 WINDOW_UPDATE or InfiniBand link-level credits
+     */
+    void setCredits(int credits);
+
+    /**
+     * @brief Gets the transfer credits carried by a LOAD_UPDATE
+     * @return Credits granted by the sender to the receiver (0 if none)
+     */
+    int getCredits() const;
+
+    /**
+     * @brief Stamps the sender's load into the message header (any type)
+     * @param load Sender's queue size at send time
+     * @param version Sender's Lamport timestamp (strictly increasing per sender)
+     *
+     * The version lets receivers discard a header older than what they
+     * already know, since piggybacked and gossiped reports interleave.
+     */
+    void setSenderLoad(int load, long version);
+
+    /**
+     * @brief Checks whether the header carries sender load information
+     * @return true if setSenderLoad() was called
+     */
+    bool hasSenderLoad() const;
+
+    /// @brief Gets the piggybacked sender load (valid if hasSenderLoad())
+    int getSenderLoad() const;
+
+    /// @brief Gets the piggybacked load version (-1 if not stamped)
+    long getSenderLoadVersion() const;
+
+    /**
+     * @brief Marks the sender as parked (energy-aware consolidation)
+     *
+     * One header bit (carried in the type byte on the wire), so every
+     * message a parked node sends, including its heartbeat, says so.
+     */
+    void setSenderDormant(bool dormant);
+    bool isSenderDormant() const;
+
+    /**
+     * @brief Stamps the sender's per-resource pressure into the header
+     * @param pressure (in use + queued demand) / capacity per resource
+     *
+     * Quantized to one byte per resource in 2% steps (0..510%), so the
+     * summary costs RESOURCE_COUNT bytes on the wire.
+     */
+    void setResourceSummary(const ResourceVector& pressure);
+
+    /// @brief Checks whether the header carries a resource summary
+    bool hasResourceSummary() const;
+
+    /// @brief Gets the decoded resource pressure (valid if hasResourceSummary())
+    ResourceVector getResourceSummary() const;
+
     /**
      * @brief Attaches a task to TASK_TRANSFER messages
      * @param task Shared pointer to the task being transferred
@@ -158,6 +303,67 @@ public:
      */
     std::shared_ptr<Task> getTask() const;
 
+    /**
+     * @brief Attaches the tasks of a TASK_BATCH
+     * @param tasks Tasks moved together; the receiver accepts each as if it
+     *        had arrived in its own TASK_TRANSFER. On a LOAD_UPDATE to a
+     *        buddy: descriptors newly queued at the sender (replica delta)
+     */
+    void setTasks(std::vector<std::shared_ptr<Task>> tasks);
+
+    /// @brief Tasks of a TASK_BATCH (empty for other types)
+    const std::vector<std::shared_ptr<Task>>& getTasks() const;
+
+    /**
+     * @brief Tags a HELP_WANTED rumor
+     * @param origin Overloaded node (relays keep it)
+     * @param rumor_id Origin's rumor counter; receivers relay each ID once
+     * @param ttl Hops left, including the one this message makes
+     */
+    void setRumor(int origin, int rumor_id, int ttl);
+    int getRumorOrigin() const;
+    int getRumorId() const;
+    int getRumorTtl() const;
+
+    /// @brief Sets the task a TASK_CANCEL refers to (no Task object needed)
+    void setTaskId(int task_id);
+
+    /// @brief Task ID of a TASK_CANCEL, or of the attached task (-1 if none)
+    int getTaskId() const;
+
+    /**
+     * @brief Attaches an encoded payload (GOSSIP_DIGEST messages)
+     * @param payload Bytes produced by GossipDigest::encode(); for CACHE_HINT
+     *        and a buddy's LOAD_UPDATE, GossipDigest::encodeKeys() (content
+     *        keys, or IDs of tasks no longer queued at the sender)
+     */
+    void setPayload(std::vector<uint8_t> payload);
+
+    /**
+     * @brief Gets the encoded payload
+     * @return Payload bytes (empty if none)
+     */
+    const std::vector<uint8_t>& getPayload() const;
+
+    /**
+     * @brief Estimates the serialized size of this message in bytes
+     * @return Header + type-specific fields + payload
+     *
+     * SIZE MODEL (what a binary encoding would need):
+     * - Header: type (1) + sender (4) + receiver (4) + load (4) + version (8)
+     * - LOAD_UPDATE: load (4) + credits (4) [+ replica delta: count (4) +
+     *   12 per added task + payload of removed IDs]
+     * - TASK_TRANSFER: task descriptor (id, complexity, migrations: 12)
+     * - TASK_BATCH: count (4) + 12 per task
+     * - EXCHANGE_OFFER, TASK_REQUEST, SNAPSHOT_MARKER: load, count or
+     *   snapshot ID (4)
+     * - HELP_WANTED: origin (4) + rumor ID (4) + TTL (1) + load (4)
+     * - GOSSIP_DIGEST*: credits (4) + payload
+     * - Any type: + RESOURCE_COUNT bytes if a resource summary is attached
+     * Used by NetworkManager for bandwidth accounting.
+     */
+    size_t getWireSize() const;
+
     /**
      * @brief Generates a human-readable string representation for logging
      * @return String describing message type, sender, receiver, and relevant data
@@ -175,10 +381,22 @@ private:
     MessageType type_;                     ///< Discriminator for message contents
     int sender_id_;                        ///< Origin node ID
     int receiver_id_;                      ///< Destination node ID (-1 = broadcast)
+    int sender_load_;                      ///< Header: sender's load at send time
+    long sender_load_version_;             ///< Header: version of sender_load_ (-1 = none)
+    bool sender_dormant_;                  ///< Header: sender is parked
+    bool has_resource_summary_;            ///< Header: resource_summary_ is valid
+    std::array<uint8_t, RESOURCE_COUNT> resource_summary_;  ///< Header: pressure, 2% units
 
     // Optional data fields (valid based on type_)
     int load_value_;                       ///< For LOAD_UPDATE messages
+    int credits_;                          ///< For LOAD_UPDATE: transfer credits granted
     std::shared_ptr<Task> task_;           ///< For TASK_TRANSFER messages
+    std::vector<std::shared_ptr<Task>> tasks_;  ///< For TASK_BATCH messages
+    int task_id_;                          ///< For TASK_CANCEL messages
+    int rumor_origin_;                     ///< For HELP_WANTED messages
+    int rumor_id_;
+    int rumor_ttl_;
+    std::vector<uint8_t> payload_;         ///< For GOSSIP_DIGEST* messages
 
     /**
      * PROTOCOL INVARIANTS (enforced by convention):
@@ -0,0 +1,294 @@
+/**
+ * @file Metrics.h
+ * @brief Thread-safe collector of task-level performance metrics for one simulation run
+ *
+ * DESIGN RATIONALE:
+ * - Logger records *events* as text; Metrics records *numbers* for analysis
+ * - One Metrics instance per simulation run (not a singleton) so that several
+ *   configurations can be benchmarked back-to-back in the same process
+ * - Nodes receive a non-owning pointer, mirroring how NetworkManager is injected
+ *
+ * WHAT IS MEASURED:
+ * - End-to-end latency of every completed task (creation -> completion)
+ * - Counts of completed, rejected (by reason) and redirected tasks
+ *
+ * ACADEMIC CONTEXT:
+ * - Tail latency (p99) rather than mean is the metric that matters for
+ *   user-facing services (Dean & Barroso, "The Tail at Scale", CACM 2013)
+ * - Goodput = useful completed work per second, as opposed to offered load
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include "Snapshot.h"
+
+/**
+ * @class Metrics
+ * @brief Aggregates completion latencies and admission counters across all nodes
+ *
+ * THREAD SAFETY:
+ * - Counters are atomics (hot path, incremented by worker threads)
+ * - Latency samples are appended under a mutex (one push_back per task)
+ * - Percentile queries copy and sort the samples (only called at report time)
+ */
+class Metrics {
+public:
+    Metrics();
+
+    /**
+     * @brief Records a completed task
+     * @param created Task creation time (Task::getCreationTime())
+     *
+     * @param work_ms Task size (complexity), for per-size-class percentiles
+     *
+     * Latency is measured against the steady clock at the moment of the call.
+     */
+    void recordCompletion(std::chrono::steady_clock::time_point created, int work_ms = 0);
+
+    /// @brief Records a task refused by cluster-level admission control
+    void recordAdmissionReject();
+
+    /// @brief Records a task dropped because a bounded queue was full
+    void recordOverflowReject();
+
+    /// @brief Records a task forwarded to a peer because the local queue was full
+    void recordRedirect();
+
+    /**
+     * @brief Records a task received through TASK_TRANSFER
+     * @param overshoot true if accepting it pushed the receiver's queue above
+     *        its load threshold (the receiver became overloaded by migration)
+     */
+    void recordTransfer(bool overshoot);
+
+    /**
+     * @brief Records the age of the load entry a routing decision relied on
+     * @param age_ms Time since the chosen peer's entry was last refreshed
+     */
+    void recordViewAge(double age_ms);
+
+    /**
+     * @brief Records an applied update to some node's peer load view
+     * @param piggybacked true if it came from a message header rather than
+     *        a LOAD_UPDATE
+     */
+    void recordViewUpdate(bool piggybacked);
+
+    /// @brief Records time a producer spent blocked on a full queue
+    void recordBlocked(std::chrono::steady_clock::duration waited);
+
+    /// @brief Records a task silently discarded by a misbehaving node, or
+    ///        queued/running/in flight on a node when it crashed
+    void recordLostTask();
+
+    /**
+     * @brief Records a finished DAG job (called when its sink completes)
+     * @param created Job submission time (the sink's creation time)
+     * @param critical_path_ms Sum of task sizes on the job's longest chain
+     */
+    void recordJobCompletion(std::chrono::steady_clock::time_point created, int critical_path_ms);
+
+    /// @brief Records worker time spent pulling DAG inputs from other nodes
+    void recordInputFetch(int ms);
+
+    /**
+     * @brief Records a task discarded before (re)running
+     * @param expired true = past its deadline, false = cancelled by ID
+     * @param remaining_work_ms Work the workers were spared
+     */
+    void recordDiscarded(bool expired, int remaining_work_ms);
+
+    /// @brief Records a task that finished after its deadline (work wasted)
+    void recordLateCompletion(int work_ms);
+
+    /**
+     * @brief Records a task completed without running it
+     * @param cache_hit true = answered from the result cache, false =
+     *        coalesced with an identical task that did run
+     * @param work_ms Work it would have taken
+     */
+    void recordDeduplicated(bool cache_hit, int work_ms);
+
+    /// @brief Records a duplicate sent to a peer advertising its result
+    void recordHintRouted();
+
+    /**
+     * @brief Records one routing decision's regret
+     * @param tasks True queue length of the chosen peer minus the shortest
+     *        true queue among known peers at decision time (>= 0)
+     */
+    void recordRoutingRegret(int tasks);
+
+    /// @brief Records an SOS raised by an overloaded node
+    void recordSosRaised();
+
+    /// @brief Records HELP_WANTED messages sent (first hop or relay)
+    void recordRumorMessages(int count);
+
+    /// @brief Records a TASK_REQUEST steal sent in answer to an SOS
+    void recordStealRequest();
+
+    /// @brief Records a node parking (consolidation)
+    void recordPark();
+
+    /// @brief Records a parked node waking up
+    void recordWake();
+
+    /// @brief Records replica delta bytes piggybacked on gossip to a buddy
+    void recordReplicaBytes(size_t bytes);
+
+    /**
+     * @brief Records a failed peer's mirrored backlog being requeued
+     * @param tasks Tasks put back into the cluster
+     */
+    void recordRecovery(int tasks);
+
+    /**
+     * @brief Records queued tasks dropped at their origin because a peer
+     *        recovered them while the origin looked failed (TASK_WITHDRAW)
+     */
+    void recordRecoveryWithdrawn(int tasks);
+
+    /**
+     * @brief Records a crashed node coming back
+     * @param restored_tasks Backlog requeued from its journal
+     * @param seconds Journal open + replay + requeue time
+     */
+    void recordRestart(int restored_tasks, double seconds);
+
+    /// @brief Adds a node's finished part of a snapshot to the global one
+    void recordLocalSnapshot(const LocalSnapshot& local);
+
+    /**
+     * @brief Gets a snapshot once every node has reported its part
+     * @param snapshot_id Snapshot to look up
+     * @param nodes Nodes taking part
+     * @param snapshot Filled in if complete
+     * @return false while reports are missing (or the ID is unknown)
+     */
+    bool getSnapshot(int snapshot_id, int nodes, GlobalSnapshot& snapshot) const;
+
+    int getCompleted() const;
+    int getAdmissionRejects() const;
+    int getOverflowRejects() const;
+    int getRedirects() const;
+    double getBlockedSeconds() const;
+    int getTransfers() const;
+    int getTransferOvershoots() const;
+    double getMeanViewAge() const;
+    int getViewUpdates() const;
+    int getPiggybackedViewUpdates() const;
+    int getLostTasks() const;
+    int getJobsCompleted() const;
+    double getInputFetchSeconds() const;
+    int getCancelledTasks() const;
+    int getExpiredTasks() const;
+    double getWorkAvoidedSeconds() const;  ///< Remaining work of discarded tasks
+    int getLateCompletions() const;
+    double getLateWorkSeconds() const;     ///< Work spent on late completions
+    int getCoalescedTasks() const;
+    int getCacheHits() const;
+    double getDedupSavedSeconds() const;   ///< Work of tasks completed without running
+    int getHintRoutedTasks() const;
+    int getRoutingDecisions() const;
+    long long getCumulativeRegret() const;  ///< Sum of per-decision regret (tasks)
+    double getMeanRegret() const;           ///< Per decision (tasks)
+    int getSosRaised() const;
+    int getRumorMessages() const;
+    int getStealRequests() const;
+    int getParks() const;
+    int getWakeups() const;
+    long long getReplicaBytes() const;
+    int getRecoveredTasks() const;
+    int getWithdrawnTasks() const;
+    /// @brief When the latest recovery happened (epoch if none)
+    std::chrono::steady_clock::time_point getLastRecoveryTime() const;
+    int getRestoredTasks() const;
+    double getRestoreSeconds() const;  ///< Summed over restarts
+
+    /// @brief Mean DAG job makespan (submission -> sink completion), ms
+    double getMeanMakespan() const;
+
+    /// @brief DAG job makespan percentile, ms (nearest rank)
+    double getMakespanPercentile(double p) const;
+
+    /// @brief Mean critical-path length of completed DAG jobs, ms
+    double getMeanCriticalPath() const;
+
+    /**
+     * @brief Returns the given latency percentile in milliseconds
+     * @param p Percentile in [0, 100] (e.g., 99 for p99)
+     * @return Latency in ms, or 0 if no task has completed yet
+     *
+     * Uses the nearest-rank method on a sorted copy of all samples.
+     */
+    double getLatencyPercentile(double p) const;
+
+    /**
+     * @brief Latency percentile over tasks whose size lies in [min_work_ms, max_work_ms]
+     *
+     * Separates short-task tail latency (head-of-line blocking victims)
+     * from long tasks in mixed workloads.
+     */
+    double getLatencyPercentile(double p, int min_work_ms, int max_work_ms) const;
+
+    /// @brief Returns the mean latency in milliseconds (0 if no samples)
+    double getMeanLatency() const;
+
+private:
+    std::atomic<int> completed_;
+    std::atomic<int> admission_rejects_;
+    std::atomic<int> overflow_rejects_;
+    std::atomic<int> redirects_;
+    std::atomic<long long> blocked_ns_;
+    std::atomic<int> transfers_;
+    std::atomic<int> transfer_overshoots_;
+    std::atomic<long long> view_age_us_sum_;
+    std::atomic<int> view_age_samples_;
+    std::atomic<int> view_updates_;
+    std::atomic<int> piggybacked_view_updates_;
+    std::atomic<int> lost_tasks_;
+    std::atomic<long long> input_fetch_ms_;
+    std::atomic<int> cancelled_tasks_;
+    std::atomic<int> expired_tasks_;
+    std::atomic<long long> work_avoided_ms_;
+    std::atomic<int> late_completions_;
+    std::atomic<long long> late_work_ms_;
+    std::atomic<int> coalesced_tasks_;
+    std::atomic<int> cache_hits_;
+    std::atomic<long long> dedup_saved_ms_;
+    std::atomic<int> hint_routed_tasks_;
+    std::atomic<int> routing_decisions_;
+    std::atomic<long long> routing_regret_;
+    std::atomic<int> sos_raised_;
+    std::atomic<int> rumor_messages_;
+    std::atomic<int> steal_requests_;
+    std::atomic<int> parks_;
+    std::atomic<int> wakeups_;
+    std::atomic<long long> replica_bytes_;
+    std::atomic<int> recovered_tasks_;
+    std::atomic<int> withdrawn_tasks_;
+    std::atomic<long long> recovered_at_ns_;  ///< steady_clock time since epoch (0 = none)
+    std::atomic<int> restored_tasks_;
+    std::atomic<long long> restore_ns_;
+
+    std::vector<double> latencies_ms_;    ///< One sample per completed task
+    std::vector<int> latency_work_ms_;    ///< Task size of each sample (same index)
+    std::vector<double> makespans_ms_;    ///< One sample per completed DAG job
+    std::vector<int> critical_paths_ms_;  ///< Critical path of each job (same index)
+
+    std::map<int, GlobalSnapshot> snapshots_;  ///< Snapshot ID -> sum so far
+    mutable std::mutex snapshot_mutex_;        ///< Protects snapshots_
+
+    /// Nearest-rank percentile of unsorted samples (0 if empty)
+    static double percentile(std::vector<double> samples, double p);
+    mutable std::mutex latency_mutex_;    ///< Protects all sample vectors
+};
+
+#endif // METRICS_H
@@ -17,9 +17,9 @@
  * SIMULATION vs. REALITY:
  * CURRENT (Simulation):
  * - In-memory message queues (no actual network I/O)
- * - Instant delivery (no latency)
+ * - Instant delivery unless link latency/bandwidth is configured (see LinkProfile)
  * - Perfect reliability (no packet loss)
- * - Unbounded bandwidth
+ * - Unbounded bandwidth unless rate limits are configured (see RateLimit)
  *
  * FUTURE (Real Network):
  * - TCP sockets for actual inter-process communication
@@ -46,12 +46,55 @@
 
 #include <map>
 #include <mutex>
+#include <atomic>
+#include <queue>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <condition_variable>
 #include <memory>
+#include <vector>
+#include <array>
+#include <utility>
 #include "Message.h"
+#include "TokenBucket.h"
 
 // Forward declaration to break circular dependency
 class PeerNode;
 
+/**
+ * @struct LinkProfile
+ * @brief One-way properties of a directed link
+ *
+ * Delivery time = queueing behind earlier messages on the same link
+ *               + wire size / bandwidth + latency.
+ */
+struct LinkProfile {
+    double latency_ms = 0.0;               ///< Propagation delay (0 = instant)
+    double bandwidth_bytes_per_sec = 0.0;  ///< Link capacity (0 = unlimited)
+};
+
+/**
+ * @enum RateLimitAction
+ * @brief What the network does with a message that finds its bucket empty
+ */
+enum class RateLimitAction {
+    DROP,   ///< Police: discard the message (sender is told via return value)
+    QUEUE   ///< Shape: hold the message in the network until its token is due
+};
+
+/**
+ * @struct RateLimit
+ * @brief Token-bucket budget for one link or one sender's message class
+ *
+ * A rate of 0 disables the limit. Burst defaults to one second of traffic.
+ */
+struct RateLimit {
+    double rate_per_sec = 0.0;   ///< Sustained messages/second (0 = unlimited)
+    double burst = 0.0;          ///< Bucket depth (0 = rate_per_sec)
+    RateLimitAction action = RateLimitAction::DROP;
+};
+
 /**
  * @class NetworkManager
  * @brief Central hub for routing messages between peer nodes
@@ -66,6 +109,27 @@ class PeerNode;
  * - Thread-safe: Mutex protects nodes_ map
  * - Multiple nodes can send messages concurrently
  * - Message delivery is synchronous (sendMessage blocks until delivered)
+ *   unless a link delay or a QUEUE rate limit moves it to the delivery thread
+ *
+ * LINK MODEL (geo-distributed clusters):
+ * - Nodes carry a zone label; links carry a LinkProfile, either set
+ *   directly, loaded from a matrix file, or derived from zones by the caller
+ * - Messages on links with a non-zero delay go through a delivery thread
+ *   that releases them at their due time; zero-delay links stay synchronous
+ *   unless a QUEUE rate limit is configured (see RATE LIMITING)
+ * - Per link, messages serialize behind each other at the link's bandwidth
+ *   and arrive in send order; across links they may be reordered
+ *
+ * RATE LIMITING:
+ * - Optional token buckets per directed link (sender -> receiver) and per
+ *   sender per MessageClass (e.g., 50 gossip messages/s per node)
+ * - A message must pass every configured bucket. DROP limits are checked
+ *   first, so a dropped message never spends tokens elsewhere
+ * - QUEUE limits reserve a token and the message waits on the delivery
+ *   thread until it is due, like a send queue: the sender returns at once.
+ *   Once any QUEUE limit is set every message goes through that thread,
+ *   so a held message is never overtaken on its link (FIFO, which
+ *   snapshot markers rely on)
  *
  * REAL-WORLD ANALOGUE:
  * - Like a network switch/router in physical networks
@@ -129,13 +193,17 @@ public:
      * ATOMICITY:
      * - Message delivery is atomic (either delivered or not, no partial)
      * - No message duplication or reordering (in simulation)
+     *
+     * @return true if delivered; false if the receiver is unknown or a DROP
+     *         rate limit discarded the message (caller still owns its task)
      */
-    void sendMessage(const Message& message);
+    bool sendMessage(const Message& message);
 
     /**
      * @brief Broadcasts a message to all nodes except sender (one-to-many)
      * @param sender_id ID of the node sending the broadcast
      * @param message The message to broadcast (receiver_id is ignored)
+     * @param except_id Another node to skip, e.g. one sent its own copy (-1 = none)
      *
      * ALGORITHM:
      * 1. Acquire lock on nodes_ map
@@ -155,8 +223,79 @@ public:
      * OPTIMIZATION:
      * - For large networks: Use multicast IP or pub/sub system
      * - For epidemic protocols: Random k-subset instead of all nodes
+     *
+     * RATE LIMITS: Each delivery is one message against the budgets. The
+     * starting receiver rotates per broadcast so a budget that covers only
+     * part of the fan-out does not always starve the same peers.
+     */
+    void broadcastMessage(int sender_id, const Message& message, int except_id = -1);
+
+    /**
+     * @brief Limits every directed link to the given budget
+     * @param limit Budget per (sender, receiver) pair; rate 0 removes it
+     *
+     * Call before traffic starts; buckets are created lazily on first use.
+     */
+    void setLinkRateLimit(const RateLimit& limit);
+
+    /**
+     * @brief Limits each sender's messages of one class to the given budget
+     * @param message_class Traffic class to budget
+     * @param limit Budget per (sender, class) pair; rate 0 removes it
      */
-    void broadcastMessage(int sender_id, const Message& message);
+    void setClassRateLimit(MessageClass message_class, const RateLimit& limit);
+
+    /**
+     * @brief Assigns a node to a zone (datacenter/region)
+     * @param node_id Node to label
+     * @param zone Zone label (nodes default to zone 0)
+     */
+    void setNodeZone(int node_id, int zone);
+
+    /// @brief Zone label of a node (0 if never set)
+    int getNodeZone(int node_id) const;
+
+    /**
+     * @brief Sets the one-way profile of the link from -> to
+     *
+     * Starts the delivery thread the first time a delaying link is set.
+     */
+    void setLinkProfile(int from, int to, const LinkProfile& profile);
+
+    /// @brief Profile of the link from -> to (instant if never set)
+    LinkProfile getLinkProfile(int from, int to) const;
+
+    /**
+     * @brief Ground-truth queue length of a registered node (-1 if unknown)
+     *
+     * SIMULATION ONLY: a real node cannot see this. Used for the ORACLE
+     * routing baseline and to score every routing decision's regret.
+     */
+    int getNodeLoad(int node_id) const;
+
+    /// @brief Registered nodes, crashed or not
+    size_t getNodeCount() const;
+
+    /// @brief Registered nodes not crashed right now (a snapshot expects a
+    ///        marker from each of these)
+    std::vector<int> getLiveNodeIds() const;
+
+    /**
+     * @brief Loads link profiles from a whitespace-separated matrix file
+     * @param path File with N rows of N latencies (ms), optionally followed
+     *             by N rows of N bandwidths (bytes/s, 0 = unlimited)
+     * @return true if at least the latency matrix was read
+     *
+     * Row i, column j describes the link from node i to node j.
+     */
+    bool loadLinkMatrix(const std::string& path);
+
+    /**
+     * @brief Stops the delivery thread, discarding messages still in flight
+     *
+     * Call before the nodes are destroyed; the destructor calls it too.
+     */
+    void stop();
 
     /**
      * @brief Gets list of all registered node IDs
@@ -175,6 +314,39 @@ public:
      */
     std::vector<int> getAllNodeIds() const;
 
+    /**
+     * @brief Gets the number of messages delivered so far
+     * @return Count of deliveries (a broadcast counts once per receiver)
+     */
+    long long getMessagesSent() const;
+
+    /// @brief Messages of one class delivered so far
+    long long getMessagesSent(MessageClass message_class) const;
+
+    /**
+     * @brief Gets the number of bytes delivered so far
+     * @return Sum of Message::getWireSize() over all deliveries
+     *
+     * Lets experiments compare protocols by bandwidth, not just message count.
+     */
+    long long getBytesSent() const;
+
+    /// @brief Messages discarded by DROP rate limits (all classes)
+    long long getMessagesDropped() const;
+
+    /// @brief Messages of one class discarded by DROP rate limits
+    long long getMessagesDropped(MessageClass message_class) const;
+
+    /// @brief Messages that waited for a token under a QUEUE rate limit
+    long long getMessagesDelayed() const;
+
+    /// @brief Total time messages were held for QUEUE rate limits (seconds)
+    double getRateLimitDelaySeconds() const;
+
+    /// @brief Tasks migrated between different zones (TASK_TRANSFER and
+    ///        every task of a TASK_BATCH)
+    long long getCrossZoneTransfers() const;
+
 private:
     /**
      * MEMBER VARIABLES: Network state and synchronization
@@ -198,6 +370,75 @@ private:
     /// - Could use std::shared_mutex (C++17) for better performance
     mutable std::mutex nodes_mutex_;
 
+    /// Network-level traffic counters (lock-free, updated on every delivery)
+    std::atomic<long long> messages_sent_;
+    std::atomic<long long> bytes_sent_;
+
+    /**
+     * @brief Charges one delivery against the configured budgets
+     * @param hold Set to how long QUEUE limits hold the message (zero if none)
+     * @return false if a DROP limit discarded it
+     */
+    bool admit(int sender_id, int receiver_id, MessageType type,
+               std::chrono::steady_clock::duration& hold);
+
+    static constexpr size_t CLASS_COUNT = static_cast<size_t>(MessageClass::COUNT);
+
+    /// Rate limit configuration and lazily created buckets (under limits_mutex_)
+    RateLimit link_limit_;
+    std::array<RateLimit, CLASS_COUNT> class_limits_;
+    std::map<std::pair<int, int>, TokenBucket> link_buckets_;   ///< (sender, receiver)
+    std::map<std::pair<int, int>, TokenBucket> class_buckets_;  ///< (sender, class)
+    std::mutex limits_mutex_;
+    std::atomic<bool> rate_limited_;  ///< Fast path: skip admit() when nothing is configured
+    std::atomic<bool> shaping_;       ///< A QUEUE limit exists: every delivery is asynchronous
+    std::atomic<int> broadcast_round_;
+
+    /**
+     * @brief Hands a message to its receiver now or at its link's due time
+     * @param receiver_id Receiver's node ID (broadcasts carry receiver -1)
+     * @param profile Link profile looked up together with the receiver
+     * @param hold Rate-limit shaping delay before the message may leave
+     */
+    void deliver(int receiver_id, PeerNode* receiver, const Message& message,
+                 const LinkProfile& profile, std::chrono::steady_clock::duration hold);
+
+    /// Starts the delivery thread if it is not running yet
+    void startDelivery();
+
+    /// Delivery thread: releases delayed messages in due-time order
+    void deliveryLoop();
+
+    /// Zone labels and link profiles (under nodes_mutex_)
+    std::map<int, int> zones_;
+    std::map<std::pair<int, int>, LinkProfile> links_;
+
+    /// A message waiting for its link's due time
+    struct PendingDelivery {
+        std::chrono::steady_clock::time_point due;
+        long long sequence;   ///< Tie-breaker: FIFO among equal due times
+        PeerNode* receiver;
+        Message message;
+        bool operator>(const PendingDelivery& other) const {
+            return due != other.due ? due > other.due : sequence > other.sequence;
+        }
+    };
+    std::priority_queue<PendingDelivery, std::vector<PendingDelivery>,
+                        std::greater<PendingDelivery>> pending_;
+    std::map<std::pair<int, int>, std::chrono::steady_clock::time_point> link_free_at_;
+    long long delivery_sequence_ = 0;
+    bool delivering_ = false;             ///< Delivery thread running
+    std::mutex delivery_mutex_;           ///< Protects pending_, link_free_at_, delivering_
+    std::condition_variable delivery_cv_;
+    std::thread delivery_thread_;
+    std::atomic<long long> cross_zone_transfers_;
+
+    /// Per-class delivery and rate limit counters
+    std::array<std::atomic<long long>, CLASS_COUNT> sent_by_class_;
+    std::array<std::atomic<long long>, CLASS_COUNT> dropped_by_class_;
+    std::atomic<long long> messages_delayed_;
+    std::atomic<long long> delay_us_;
+
     /**
      * DESIGN NOTES:
      *
@@ -0,0 +1,320 @@
+/**
+ * @file NodeConfig.h
+ * @brief Per-node tuning knobs for queueing, admission and balancing policy
+ *
+ * DESIGN RATIONALE:
+ * - Gathers every policy parameter of a PeerNode in one plain struct
+ * - Default values reproduce the original behavior (unbounded FIFO, 2 workers)
+ * - Passed by value at construction: nodes never share mutable configuration
+ * - Simulation and benchmark code build variants by copying and tweaking a base config
+ *
+ * ACADEMIC CONTEXT:
+ * - Bounded queues + overflow policy = admission control in queueing theory
+ *   (M/M/c/K systems: arrivals finding K tasks in system are lost)
+ * - Backpressure (blocking the producer) is the flow-control approach used by
+ *   TCP windows, Reactive Streams and bounded channels in Go/Rust
+ * - Load shedding at ingress is how production front-ends (e.g., Google's
+ *   "Handling Overload" SRE chapter) keep tail latency bounded under overload
+ */
+
+#ifndef NODECONFIG_H
+#define NODECONFIG_H
+
+#include <string>
+#include "Resources.h"
+
+/**
+ * @enum OverflowPolicy
+ * @brief What a node does with a task that arrives while its queue is full
+ *
+ * Only consulted when NodeConfig::queue_capacity > 0 (bounded queue).
+ */
+enum class OverflowPolicy {
+    REJECT,     ///< Drop the task and count it as rejected (load shedding)
+    REDIRECT,   ///< Forward the task to the least-loaded peer; reject if none
+    BLOCK       ///< Block the producer until a worker frees a slot (backpressure)
+};
+
+/**
+ * @brief Human-readable name of an overflow policy (for logs and reports)
+ */
+inline std::string overflowPolicyName(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::REJECT:   return "reject";
+        case OverflowPolicy::REDIRECT: return "redirect";
+        case OverflowPolicy::BLOCK:    return "block";
+    }
+    return "unknown";
+}
+
+/**
+ * @enum GossipMode
+ * @brief How nodes disseminate load information
+ */
+enum class GossipMode {
+    BROADCAST,  ///< Every node sends LOAD_UPDATE to every peer each round (O(n^2))
+    DIGEST      ///< Each node sends a delta digest to gossip_fanout random peers (push-pull)
+};
+
+/**
+ * @brief Human-readable name of a gossip mode (for logs and reports)
+ */
+inline std::string gossipModeName(GossipMode mode) {
+    switch (mode) {
+        case GossipMode::BROADCAST: return "broadcast";
+        case GossipMode::DIGEST:    return "digest";
+    }
+    return "unknown";
+}
+
+/**
+ * @enum Misbehavior
+ * @brief Fault model for a buggy or misconfigured node (for robustness experiments)
+ */
+enum class Misbehavior {
+    NONE,        ///< Honest node
+    LIAR,        ///< Always advertises load 0, but processes tasks normally
+    FLAPPER,     ///< Advertises 0 and its true load on alternate reports
+    BLACK_HOLE   ///< Advertises load 0 and silently discards transferred tasks
+};
+
+/**
+ * @brief Human-readable name of a misbehavior (for logs and reports)
+ */
+inline std::string misbehaviorName(Misbehavior misbehavior) {
+    switch (misbehavior) {
+        case Misbehavior::NONE:       return "none";
+        case Misbehavior::LIAR:       return "liar";
+        case Misbehavior::FLAPPER:    return "flapper";
+        case Misbehavior::BLACK_HOLE: return "black-hole";
+    }
+    return "unknown";
+}
+
+/**
+ * @enum RoutingPolicy
+ * @brief How selectBestPeer() picks among peers that look less loaded
+ */
+enum class RoutingPolicy {
+    GREEDY,  ///< Lowest advertised (possibly stale) load
+    BANDIT,  ///< LinUCB over peer context, trained on completion-time feedback
+    ORACLE   ///< Lowest true load, read from every node (simulation-only baseline)
+};
+
+/**
+ * @brief Human-readable name of a routing policy (for logs and reports)
+ */
+inline std::string routingPolicyName(RoutingPolicy policy) {
+    switch (policy) {
+        case RoutingPolicy::GREEDY: return "greedy";
+        case RoutingPolicy::BANDIT: return "bandit";
+        case RoutingPolicy::ORACLE: return "oracle";
+    }
+    return "unknown";
+}
+
+/**
+ * @enum BalancingScheme
+ * @brief How the load monitor moves queued work between nodes each tick
+ */
+enum class BalancingScheme {
+    GREEDY,             ///< Above load_threshold, push a batch to the least-loaded peer
+    DIFFUSION,          ///< Send every less-loaded neighbor 1/(degree+1) of the difference
+    DIMENSION_EXCHANGE  ///< Round r: equalize with the partner across hypercube dimension r
+};
+
+/**
+ * @brief Human-readable name of a balancing scheme (for logs and reports)
+ */
+inline std::string balancingSchemeName(BalancingScheme scheme) {
+    switch (scheme) {
+        case BalancingScheme::GREEDY:             return "greedy";
+        case BalancingScheme::DIFFUSION:          return "diffusion";
+        case BalancingScheme::DIMENSION_EXCHANGE: return "dim-exchange";
+    }
+    return "unknown";
+}
+
+/**
+ * @struct NodeConfig
+ * @brief Static configuration of a single PeerNode
+ *
+ * All fields have defaults matching the original simulator, so
+ * NodeConfig{} behaves exactly like PeerNode(id, 10, network).
+ */
+struct NodeConfig {
+    /// Queue size triggering task offloading (see PeerNode constructor docs)
+    int load_threshold = 10;
+
+    /// Number of worker threads (models CPU cores)
+    int num_workers = 2;
+
+    /// Maximum queued tasks; 0 means unbounded (original behavior)
+    int queue_capacity = 0;
+
+    /// Action taken when a task arrives at a full queue
+    OverflowPolicy overflow_policy = OverflowPolicy::REJECT;
+
+    /// Maximum times a task may be redirected before it is rejected.
+    /// Prevents a task from bouncing forever between full nodes.
+    int max_redirects = 3;
+
+    /// Cluster-level admission control: refuse new ingress tasks when the
+    /// gossip-estimated average queue length per node reaches this value.
+    /// 0 disables admission control.
+    double admission_max_avg_load = 0.0;
+
+    /// Load monitor period (ms): gossip, offloading and balancing rounds
+    /// run once per tick, so this is also the gossip interval
+    int load_tick_ms = 500;
+
+    /// Maximum tasks offloaded per load-monitor tick while above threshold
+    int migration_batch_size = 1;
+
+    /// Periodic balancing. DIFFUSION and DIMENSION_EXCHANGE move tasks in
+    /// TASK_BATCH messages whatever the threshold; DIMENSION_EXCHANGE
+    /// expects a power-of-two cluster with node IDs 0..n-1 (a missing
+    /// partner just skips that round)
+    BalancingScheme balancing_scheme = BalancingScheme::GREEDY;
+
+    /// Overload SOS: on reaching this queue length, send a HELP_WANTED rumor
+    /// at once (sos_fanout random peers per hop, sos_ttl hops) instead of
+    /// waiting for gossip. Peers whose load is more than load_threshold
+    /// below the sender's answer with TASK_REQUEST steals. 0 = off
+    int sos_watermark = 0;
+    int sos_ttl = 2;
+    int sos_fanout = 2;
+
+    /// Energy-aware consolidation: ingress is packed first-fit onto the
+    /// lowest-ID awake node with fewer than num_workers queued tasks, and a
+    /// node idle for dormant_after_ms parks (workers held, gossip reduced
+    /// to one heartbeat per heartbeat_interval_ms) as long as a lower-ID
+    /// node is awake. Parked nodes wake on work, on an SOS, or by steal-back
+    /// when every awake node is full; the first task after a wake waits
+    /// wake_latency_ms (resume from a low-power state)
+    bool consolidation = false;
+    int dormant_after_ms = 2000;
+    int heartbeat_interval_ms = 2000;
+    int wake_latency_ms = 300;
+
+    /// Buddy replication: each node mirrors the descriptors of its queued
+    /// tasks on its buddy (next live peer ID, wrapping) as a delta of added
+    /// tasks and removed IDs piggybacked on the load gossip sent to that
+    /// peer each tick. A peer silent for failure_timeout_ms is declared
+    /// failed and dropped from the view; its buddy requeues the mirrored
+    /// backlog across the survivors. Running tasks and tasks queued since
+    /// the last tick are lost; ones finished since then run twice
+    /// (at-least-once). Parked nodes heartbeat at least twice per timeout,
+    /// whatever heartbeat_interval_ms says. A failed peer is readmitted
+    /// when it sends a load update itself (it was slow, or restarted)
+    bool buddy_replication = false;
+    int failure_timeout_ms = 3000;
+
+    /// Durable queue: every enqueue, dequeue and transfer is journaled to
+    /// <journal_dir>/node-<id>.journal (see TaskJournal: mmap'd, group
+    /// commit every journal_commit_us, compacted once past
+    /// journal_compact_bytes and mostly dead). A node constructed over an
+    /// existing journal, or restart()ed after crash(), requeues the backlog
+    /// it holds. Empty = off
+    std::string journal_dir;
+    int journal_commit_us = 2000;
+    size_t journal_compact_bytes = 1 << 20;
+
+    /// Credit-based flow control for TASK_TRANSFER: receivers grant each
+    /// peer a number of transfer credits (piggybacked on LOAD_UPDATE) and
+    /// senders migrate only within the credits they hold.
+    bool credit_flow_control = false;
+
+    /// Refresh the peer load view from the load header piggybacked on every
+    /// message (TASK_TRANSFER, ...), not only from LOAD_UPDATE gossip.
+    bool piggyback_load = false;
+
+    /// Load dissemination protocol
+    GossipMode gossip_mode = GossipMode::BROADCAST;
+
+    /// DIGEST mode: peers contacted per gossip round
+    int gossip_fanout = 1;
+
+    /// DIGEST mode: every this many rounds, send all entries instead of the
+    /// delta, repairing any entry a receiver missed (0 = never)
+    int digest_full_sync_rounds = 10;
+
+    /// Staleness-aware routing: ignore peer load entries older than this
+    /// (measured from when the peer sampled its load). 0 = no limit.
+    int max_view_age_ms = 0;
+
+    /// Staleness-aware routing: inflate a peer's reported load by this many
+    /// tasks per second of entry age, since an idle-looking peer has likely
+    /// been picked by others since it reported. 0 = use raw load.
+    double staleness_penalty_per_sec = 0.0;
+
+    /// Geo-distributed clusters: rank peers by link latency + expected
+    /// queueing delay rather than by load alone (see PeerNode::selectBestPeer)
+    bool zone_aware_routing = false;
+
+    /// Robust routing: acknowledge completed transfers (TASK_COMPLETE) and
+    /// keep a trust score per peer, cutting it whenever a peer's advertised
+    /// load is below what we know is still outstanding there
+    bool robust_routing = false;
+
+    /// Robust routing: peers whose trust falls below this are not selected
+    double min_peer_trust = 0.1;
+
+    /// Multi-resource model: node capacity per resource. cpu 0 = num_workers;
+    /// memory/io 0 = not modelled (unlimited). A task starts only when its
+    /// demand fits next to the tasks already running.
+    ResourceVector resource_capacity = {0.0, 0.0, 0.0};
+
+    /// Route by dominant resource pressure (DRF) instead of queue length, and
+    /// stamp a per-resource summary into every message header
+    bool drf_balancing = false;
+
+    /// DRF admission: shed ingress when the mean dominant pressure the node
+    /// knows of reaches this (e.g. 1.5 = 150% of the scarcest resource). 0 = off
+    double admission_max_dominant_pressure = 0.0;
+
+    /// Preemptive time slicing: workers run tasks in quanta of this many ms
+    /// and requeue unfinished ones at the back. 0 = run to completion
+    int time_slice_ms = 0;
+
+    /// Multi-level feedback queue (needs time_slice_ms > 0): a task that uses
+    /// its whole quantum drops one level; level k gets quantum time_slice_ms * 2^k
+    /// and runs only when all higher levels are empty
+    bool mlfq = false;
+    int mlfq_levels = 3;
+
+    /// MLFQ priority boost: every this many ms, queued tasks go back to level 0
+    /// so a steady stream of short tasks cannot starve demoted ones. 0 = off
+    int mlfq_boost_ms = 0;
+
+    /// DAG scheduling: when placing a released task, add the time to pull
+    /// its inputs to each candidate node's cost (false = queue length only)
+    bool dag_locality = false;
+
+    /// Discard a task whose deadline has passed when a worker dequeues it,
+    /// rather than running it for a result nobody will use
+    bool drop_expired_tasks = true;
+
+    /// Duplicate suppression for tasks with a content key: run one of the
+    /// identical tasks queued or running here and complete the rest with it
+    bool coalesce_duplicates = false;
+    /// Results kept per node, LRU (0 = no memoization)
+    int result_cache_size = 0;
+    /// Advertise newly cached keys to peers (CACHE_HINT, each load tick) and
+    /// route incoming duplicates to a peer known to hold the result
+    bool cache_hints = false;
+
+    /// Peer selection for offloads and redirects. BANDIT learns from
+    /// TASK_COMPLETE acks (sent whenever the policy is BANDIT)
+    RoutingPolicy routing_policy = RoutingPolicy::GREEDY;
+    double bandit_alpha = 0.5;  ///< LinUCB exploration weight
+    /// Score each routing decision against the true queues (Metrics regret).
+    /// Reads every peer's queue per decision, so it is always on for BANDIT
+    /// and ORACLE and opt-in for GREEDY baselines
+    bool measure_regret = false;
+
+    /// Fault injection: how this node misbehaves (NONE = honest)
+    Misbehavior misbehavior = Misbehavior::NONE;
+};
+
+#endif // NODECONFIG_H
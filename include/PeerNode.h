@@ -37,7 +37,8 @@
  * 4. Message Processor: Handles incoming messages from peers (event-driven)
  *
  * SYNCHRONIZATION:
- * - Task queue: Mutex + condition variable (producer-consumer pattern)
+ * - Task queue: Mutex + two condition variables (producer-consumer pattern;
+ *   queue_cv_ signals "not empty", space_cv_ signals "not full" for BLOCK mode)
  * - Peer load map: Mutex (read-write lock could be more efficient)
  * - Message queue: Mutex + condition variable
  * - Task counter: Atomic (lock-free for performance)
@@ -48,18 +49,29 @@
 
 #include <queue>
 #include <map>
+#include <set>
+#include <list>
+#include <deque>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
 #include <atomic>
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <random>
 #include "Task.h"
 #include "Message.h"
+#include "NodeConfig.h"
+#include "LinUCB.h"
+#include "TaskJournal.h"
+#include "Snapshot.h"
 
 // Forward declaration to break circular dependency
 // (PeerNode uses NetworkManager, NetworkManager uses PeerNode)
 class NetworkManager;
+class Metrics;
+class TaskAudit;
 
 /**
  * @class PeerNode
@@ -100,6 +112,19 @@ public:
      */
     PeerNode(int id, int load_threshold, NetworkManager* network_manager);
 
+    /**
+     * @brief Constructs a PeerNode with a full policy configuration
+     * @param id Unique identifier for this node (0 to N-1)
+     * @param config Queueing, admission and balancing parameters (copied)
+     * @param network_manager Pointer to shared network layer (not owned)
+     * @param metrics Optional run-wide metrics collector (not owned, may be null)
+     *
+     * The three-argument constructor is shorthand for a default NodeConfig
+     * with the given load threshold.
+     */
+    PeerNode(int id, const NodeConfig& config, NetworkManager* network_manager,
+             Metrics* metrics = nullptr);
+
     /**
      * @brief Destructor - ensures clean shutdown
      *
@@ -142,21 +167,102 @@ public:
     void stop();
 
     /**
-     * @brief Adds a new task to this node's queue
+     * @brief Fail-stop crash (failure injection for simulations)
+     *
+     * The node goes silent at once: queued tasks and the duplicates waiting
+     * on them are dropped, the result cache is emptied, tasks running
+     * on its workers are dropped when they finish, and every message still
+     * queued or arriving later is discarded. All of these count as lost
+     * (Metrics::recordLostTask). Peers notice only through missing gossip
+     * (buddy_replication). Journal records not yet group-committed are
+     * lost as well. Threads keep idling until stop() or restart().
+     */
+    void crash();
+
+    /// @brief true once crash() has been called (until restart())
+    bool isCrashed() const;
+
+    /**
+     * @brief Comes back after crash(), as a restarted process would
+     *
+     * Reopens the journal (config.journal_dir) and requeues the tasks it
+     * still holds as queued; forwarding records are restored too, so
+     * cancels keep following tasks migrated before the crash. Without a
+     * journal the node restarts empty. Restored tasks count their latency
+     * from the restart (creation times are not persisted).
+     */
+    void restart();
+
+    /// @brief Journal file of node_id under dir (config.journal_dir)
+    static std::string journalPath(const std::string& dir, int node_id);
+
+    /**
+     * @brief Submits a new task to this node (cluster ingress)
      * @param task Shared pointer to task to be processed
+     * @return true if the task was queued here or redirected to a peer,
+     *         false if it was shed (admission control or full queue)
      *
      * THREAD SAFETY: Queue is protected by mutex
      * SIGNALING: Wakes up one worker thread (condition variable)
      *
      * USED BY:
-     * - Main thread: Initial task assignment
-     * - Peer nodes: Task offloading (TASK_TRANSFER messages)
+     * - Main thread / task generator: Initial task assignment
+     * (Tasks arriving from peers go through TASK_TRANSFER handling instead,
+     *  which never blocks the message processor thread.)
+     *
+     * ADMISSION CONTROL (config.admission_max_avg_load > 0):
+     * - Estimates cluster load as own queue + gossiped peer loads
+     * - Refuses the task if the estimated per-node average is at the limit
+     * - Cheap: uses only local state, no extra messages
+     *
+     * BOUNDED QUEUE (config.queue_capacity > 0), when full:
+     * - REJECT: drop the task (load shedding)
+     * - REDIRECT: forward to the least-loaded peer (reject if none is lighter)
+     * - BLOCK: wait until a worker frees a slot (backpressure on the producer)
      *
      * ENQUEUEING POLICY: FIFO (First-In-First-Out)
      * - Could be extended to priority queue for different task types
      * - Could be extended to LIFO (Last-In-First-Out) for better cache locality
      */
-    void addTask(std::shared_ptr<Task> task);
+    bool addTask(std::shared_ptr<Task> task);
+
+    /**
+     * @brief Parks a DAG task here until all its predecessors complete
+     * @param task Task with at least one dependency; this node is its home
+     *
+     * DISTRIBUTED DEPENDENCY TRACKING:
+     * - Predecessors may run anywhere; whichever node completes one sends
+     *   DEPENDENCY_RESOLVED to this (home) node
+     * - When the last one arrives the task is released through the balancer
+     *   (see placeReleasedTask()), which with dag_locality favours nodes
+     *   that already hold its inputs
+     * - Parked tasks are not load: they cannot run and are not offloaded
+     *
+     * ORDERING: Successors must be parked before their predecessors are
+     * submitted, so a completion can never overtake its registration.
+     */
+    void submitDependentTask(std::shared_ptr<Task> task);
+
+    /// @brief Number of DAG tasks parked here waiting for predecessors
+    int getParkedTaskCount() const;
+
+    /**
+     * @brief Cancels a task by ID, wherever it has migrated to
+     * @param task_id Task to cancel
+     *
+     * LAZY TOMBSTONES:
+     * - Queues are FIFOs, so nothing is searched or removed here; the ID is
+     *   recorded and a worker discards the task when it reaches the head
+     *   (a preempted time-sliced task is caught on its next dequeue)
+     * - If this node forwarded the task, TASK_CANCEL follows it to the
+     *   peer, which repeats the same steps, so the cancel walks the
+     *   task's migration path
+     * - A task still in flight towards this node is dropped on arrival
+     * - Tombstones and forwarding records expire after a few seconds, so
+     *   cancelling a finished or unknown task costs nothing lasting
+     * - A parked DAG task is dropped at once; its successors stay parked
+     */
+    void cancelTask(int task_id);
 
     /**
      * @brief Returns current queue size (load)
@@ -172,6 +278,15 @@ public:
      */
     int getCurrentLoad() const;
 
+    /// @brief Queued plus running tasks (number in system, as queueing theory counts it)
+    int getTasksInSystem() const;
+
+    /// @brief Robust routing: this node's trust in a peer (1.0 if it has no evidence)
+    double getPeerTrust(int peer_id) const;
+
+    /// @brief Tasks on a worker right now (num_workers minus this = idle workers)
+    int getRunningTasks() const;
+
     /**
      * @brief Returns total tasks completed by this node
      * @return Cumulative task count
@@ -185,6 +300,52 @@ public:
      */
     int getTasksProcessed() const;
 
+    /**
+     * @brief Starts a consistent global snapshot with this node as initiator
+     * @param snapshot_id Larger than the ID of any earlier snapshot
+     *
+     * Returns at once. Every node reports its part to Metrics when its
+     * last marker arrives; Metrics::getSnapshot() has the sum once all
+     * have (see Snapshot.h). Only live nodes take part: no marker is
+     * awaited from a node crashed at the cut or declared failed by the
+     * detector, before or during the snapshot. A node that crashes while
+     * its part is open abandons it and never reports, so that snapshot
+     * stays incomplete.
+     */
+    void initiateSnapshot(int snapshot_id);
+
+    /// @brief This node's task ledger right now (not part of any cut)
+    LocalSnapshot getLedger() const;
+
+    /**
+     * @brief Reports task creation-to-completion events to an audit
+     * @param audit Run-wide exactly-once audit (not owned; null = off)
+     *
+     * Call before start(). Marks completions, deliberate sheds, and every
+     * task that leaves or reaches this node in a message.
+     */
+    void setAudit(TaskAudit* audit);
+
+    /// @brief IDs of tasks queued, coalesced or parked here (for the end-of-run audit)
+    std::vector<int> getHeldTaskIds() const;
+
+    /**
+     * @brief Per-resource pressure: (in use + queued demand) / capacity
+     * @return Pressure per resource (0 for resources without a capacity)
+     *
+     * Above 1.0 on any resource means work is waiting for that resource.
+     */
+    ResourceVector getResourcePressure() const;
+
+    /**
+     * @brief Per-resource utilization: in use / capacity
+     * @return Utilization per resource in [0, 1] (0 if not modelled)
+     */
+    ResourceVector getResourceUtilization() const;
+
+    /// @brief Seconds this node has spent awake (not parked) since construction
+    double getAwakeSeconds() const;
+
     /**
      * @brief Handles an incoming message from a peer
      * @param message The message to process
@@ -197,7 +358,9 @@ public:
      * CALLED BY: NetworkManager when message is delivered
      *
      * MESSAGE TYPES:
-     * - LOAD_UPDATE: Update peer_loads_ map
+     * - Any message: Refresh sender's load from the header (piggyback_load)
+     * - LOAD_UPDATE: Update peer_loads_ map (and transfer credits)
+     * - GOSSIP_DIGEST(_REPLY): Merge batched entries, reply to pushes
      * - TASK_TRANSFER: Add task to local queue
      * - PEER_DISCOVERY: Add to peers_ list (future)
      */
@@ -233,6 +396,12 @@ public:
      */
     int getId() const;
 
+    /**
+     * @brief Gets this node's configuration
+     * @return Reference to the immutable NodeConfig
+     */
+    const NodeConfig& getConfig() const;
+
 private:
     /**
      * PRIVATE METHODS: Thread entry points and internal logic
@@ -263,12 +432,14 @@ private:
     /**
      * @brief Load monitor thread: Implements gossip protocol and offloading
      *
-     * ALGORITHM (every 500ms):
+     * ALGORITHM (every load_tick_ms, default 500ms):
      * 1. Get current load (queue size)
-     * 2. Broadcast LOAD_UPDATE to all peers (gossip)
+     * 2. Broadcast LOAD_UPDATE to all peers (gossip); with credit flow
+     *    control, send one LOAD_UPDATE per peer carrying its credit grant.
+     *    In DIGEST mode, push a delta digest to gossip_fanout random peers.
      * 3. Log metrics (for performance analysis)
-     * 4. If load > threshold: Offload one task to least-loaded peer
-     * 5. Sleep 500ms, repeat
+     * 4. While load > threshold: Offload up to migration_batch_size tasks
+     * 5. Sleep load_tick_ms, repeat
      *
      * GOSSIP PROTOCOL:
      * - All-to-all broadcast every 500ms
@@ -279,7 +450,8 @@ private:
      * WHY 500ms?
      * - Fast enough to react to load changes
      * - Slow enough to avoid message storms
-     * - Could be tuned based on task complexity (fast tasks = faster gossip)
+     * - Tunable per workload (NodeConfig::load_tick_ms, see Autotuner):
+     *   fast tasks want faster gossip
      */
     void loadMonitorLoop();
 
@@ -305,6 +477,7 @@ private:
     /**
      * @brief Offloads a task to a less-loaded peer
      * @param task Task to offload
+     * @return true if the task was sent, false if it was kept locally
      *
      * ALGORITHM:
      * 1. Select best peer (least loaded, excluding self)
@@ -319,10 +492,235 @@ private:
      *
      * STALE INFORMATION:
      * - Routing decision based on peer_loads_ map
-     * - Map updated by gossip (may be 100-500ms stale)
-     * - Could cause suboptimal routing but system still converges
+     * - Map updated by gossip (may be 100-500ms stale, more when relayed)
+     * - selectBestPeer() can discount or skip old entries (see NodeConfig)
+     */
+    bool offloadTask(std::shared_ptr<Task> task);
+
+    /**
+     * @brief Moves up to count queued tasks to a peer in one TASK_BATCH
+     * @return Tasks sent (0 if the queue was empty or the send failed, in
+     *         which case the tasks are requeued here)
+     *
+     * Expired or cancelled tasks met on the way are discarded, not sent.
+     * Batches bypass transfer credits: the receiver's load report (gossip
+     * or EXCHANGE_OFFER) already bounds what is sent.
+     */
+    int sendTaskBatch(int peer_id, int count);
+
+    /**
+     * @brief One first-order diffusion step (BalancingScheme::DIFFUSION)
+     * @param current_load Own queue length this tick
+     *
+     * Every neighbor j that looks less loaded receives
+     * round((own - load_j) / (degree + 1)) tasks, from the gossiped view.
+     * The 1/(degree + 1) weight keeps the step from overshooting even when
+     * all neighbors are empty. The view entry is bumped by what was sent.
+     */
+    void diffuseLoad(int current_load);
+
+    /**
+     * @brief Starts this tick's dimension-exchange round
+     * @param current_load Own queue length this tick
+     *
+     * Round r pairs each node with id ^ 2^(r mod d), d = log2(cluster
+     * size), and sends it an EXCHANGE_OFFER with our load. On a hypercube
+     * of n = 2^d nodes, d rounds of pairwise averaging leave every queue
+     * within d tasks of the mean, with one partner per node per round.
+     */
+    void sendExchangeOffer(int current_load);
+
+    /// @brief Heavier side of a pair ships half the difference (TASK_BATCH)
+    void handleExchangeOffer(const Message& message);
+
+    /**
+     * @brief Sends a HELP_WANTED rumor if we are over sos_watermark
+     * @param periodic true on the load tick: also re-arm if we are still
+     *        more than load_threshold above the mean load in our view
+     *
+     * Edge-triggered: one rumor per crossing of the watermark, re-armed
+     * when the load drops below it, when a peer answers with a steal, or
+     * by the periodic check above (so a rumor nobody can help with is not
+     * repeated on every ingress). At most one rumor per SOS_MIN_INTERVAL.
+     * Called on ingress, on each load tick and after a stolen batch lands
+     * here (so a helper that took a large share passes it on in turn).
+     */
+    void raiseSos(bool periodic);
+
+    /// @brief Relays a rumor once (TTL - 1) and adopts its origin as a help target
+    void handleHelpWanted(const Message& message);
+
+    /**
+     * @brief Sends one steal request if we are well below a help target
+     *
+     * Targets the most loaded origin whose last known load exceeds ours by
+     * more than load_threshold, asking for half the difference. One
+     * request is in flight at a time; each reply triggers the next, so a
+     * helper keeps stealing until it is level with the origin.
+     */
+    void requestWork();
+
+    /**
+     * @brief Answers a steal: ships min(wanted, half the difference)
+     *
+     * The grant is recomputed from our load now, so helpers that asked on
+     * the same stale report do not overdraw us. An empty TASK_BATCH tells
+     * the thief we have nothing to spare.
+     */
+    void handleTaskRequest(const Message& message);
+
+    /// @brief Steal bookkeeping for a TASK_BATCH that answers our request
+    void handleStealReply(const Message& message);
+
+    /// @brief sos_fanout random neighbors, excluding up to two IDs
+    std::vector<int> pickRumorTargets(int exclude_a, int exclude_b);
+
+    /**
+     * @brief Consolidation: where new work should go
+     * @return Lowest-ID awake node (this one included) with fewer than
+     *         num_workers queued tasks, or -1 if every awake node is full
+     */
+    int packingTarget();
+
+    /**
+     * @brief Parks the node if it has been idle long enough (load tick)
+     * @return true if the node is parked after the call
+     */
+    bool maybePark();
+
+    /**
+     * @brief Leaves the parked state; work can start after wake_latency_ms
+     * PRECONDITION: queue_mutex_ is held by the caller
      */
-    void offloadTask(std::shared_ptr<Task> task);
+    void wakeLocked(const std::string& reason);
+
+    /// @brief wakeLocked() taking the lock; no-op if awake
+    void wake(const std::string& reason);
+
+    /// @brief Parked load tick: heartbeat, and steal-back if every awake node is full
+    void dormantTick();
+
+    /**
+     * @brief Opens this node's journal and requeues the backlog it holds
+     * PRECONDITION: queue_mutex_ is held by the caller
+     * @return Tasks restored (0 if journaling is off or the file is empty)
+     */
+    int openJournalLocked();
+
+    /// @brief Lowest live peer ID above ours, else the lowest one (-1 if none)
+    int currentBuddy() const;
+
+    /**
+     * @brief Adds the replica delta to a LOAD_UPDATE addressed to the buddy
+     *
+     * Diffs the queued tasks against what the receiver already mirrors:
+     * snapshots of new tasks go in the task list, IDs no longer queued
+     * (started, migrated, discarded) in the payload. A new buddy starts
+     * from an empty mirror. Nothing is attached if nothing changed.
+     */
+    void attachReplicaDelta(Message& message);
+
+    /**
+     * @brief Applies a replica delta from the sender to our mirror of it
+     * PRECONDITION: peer_loads_mutex_ is held by the caller
+     */
+    void applyReplicaDeltaLocked(const Message& message);
+
+    /**
+     * @brief Declares peers silent for failure_timeout_ms failed (load tick)
+     *
+     * A failed peer leaves the load view, the peer list and the buddy
+     * ring, and later reports relayed about it are ignored until it sends
+     * us a LOAD_UPDATE itself (e.g. after restart()), which readmits it.
+     * If we mirror its backlog, recoverBacklog() requeues it, and
+     * withdrawRecovered() reconciles that if the peer comes back.
+     */
+    void detectFailures();
+
+    /**
+     * @brief A readmitted peer was only silent (or restarted from its
+     *        journal): sends it TASK_WITHDRAW with every task we requeued
+     *        for it, so the recovered copy is the one that runs
+     *
+     * Best effort: tasks it ran or forwarded meanwhile stay duplicated
+     * (at-least-once).
+     */
+    void withdrawRecovered(int origin);
+
+    /// @brief TASK_WITHDRAW: drops the listed tasks still queued here
+    void handleWithdraw(const Message& message);
+
+    /**
+     * @brief Sends a TASK_TRANSFER or TASK_BATCH and counts it as sent
+     * @return NetworkManager::sendMessage()'s result
+     *
+     * Every task leaving this node goes through here: holding cut_mutex_
+     * keeps a send from overtaking the markers of a snapshot being recorded.
+     */
+    bool sendTasks(const Message& message);
+
+    /**
+     * @brief Robust routing: TASK_RELEASED to the hop a task came from
+     * @param task_id Task passed on or shed here
+     * @param upstream Node that transferred it to us (ignored if < 0 or us)
+     *
+     * Without it, the upstream node would count a relayed or dropped task
+     * as outstanding here forever and eventually distrust an honest relay.
+     */
+    void releaseUpstream(int task_id, int upstream);
+
+    /// @brief Ledger: tasks entered the system at this node
+    void countAdmitted(int tasks);
+
+    /// @brief Ledger: tasks left the system here (done, shed, discarded, lost)
+    void countFinished(int tasks);
+
+    /// @brief countFinished() for a completion, marked in the audit
+    void countCompleted(const Task& task);
+
+    /// @brief countFinished() for a task refused or discarded on purpose
+    void countShed(const Task& task);
+
+    /// @brief Ledger: tasks a message brought in; counted in the channel
+    ///        too while a snapshot still waits for the sender's marker
+    void countReceived(const Message& message);
+
+    /**
+     * @brief Records the ledger as this node's part of snapshot_id
+     * @param queued Queue length sampled by the caller (breakdown only)
+     * @param others Nodes a marker is expected from (snapshotChannels())
+     * PRECONDITION: cut_mutex_ and ledger_mutex_ are held by the caller
+     */
+    void recordSnapshotLocked(int snapshot_id, int queued, std::set<int> others);
+
+    /// @brief Live nodes other than us that we have not declared failed
+    ///        (taken before cut_mutex_)
+    std::set<int> snapshotChannels() const;
+
+    /// @brief Stops waiting for a failed peer's marker (detectFailures())
+    void closeSnapshotChannel(int peer_id);
+
+    /**
+     * @brief Reports the snapshot once every channel has its marker
+     * PRECONDITION: ledger_mutex_ is held by the caller
+     */
+    void finishSnapshotLocked();
+
+    /// @brief Sends a marker for snapshot_id to every other node (cut_mutex_ held)
+    void sendMarkers(int snapshot_id);
+
+    /// @brief SNAPSHOT_MARKER: record on the first one, close its channel
+    void handleSnapshotMarker(const Message& message);
+
+    /**
+     * @brief Requeues a failed peer's mirrored tasks across the survivors
+     * @param origin Failed node
+     * @param tasks Its mirrored descriptors
+     *
+     * Tasks are dealt round-robin starting from the least-loaded known
+     * awake node (this one included), one TASK_BATCH per peer.
+     */
+    void recoverBacklog(int origin, std::vector<std::shared_ptr<Task>> tasks);
 
     /**
      * @brief Selects the least-loaded peer for task routing
@@ -339,8 +737,344 @@ private:
      * EMPTY PEER MAP:
      * - Returns -1 if no peers registered yet
      * - Returns -1 if all peers more loaded than self
+     *
+     * FLOW CONTROL: With credit_flow_control, peers holding no credits
+     * for this node are skipped.
+     *
+     * STALENESS: Entries older than max_view_age_ms are skipped; the rest
+     * compete on load + staleness_penalty_per_sec * age.
+     *
+     * DRF: With drf_balancing, load is replaced by the dominant pressure
+     * over the resources the task actually uses (see dominantPressure), so
+     * a memory-heavy task avoids memory-starved peers even if their queues
+     * are short. Peers that have not sent a resource summary yet fall back
+     * to their queue length.
+     *
+     * TRUST: With robust_routing, peers below min_peer_trust are skipped
+     * and the rest compete on (load + 1) / trust - 1, so a distrusted peer
+     * advertising 0 looks as busy as an honest one advertising 1/trust - 1.
+     *
+     * ZONE AWARENESS: With zone_aware_routing, candidates compete on
+     * expected completion time instead of raw load:
+     *   cost(peer) = link latency + load * (avg service time / workers)
+     *   cost(self) = my_load * (avg service time / workers)
+     * so a remote zone wins only when its queueing gain exceeds the transfer
+     * delay, and same-zone peers are preferred at equal load.
+     */
+    int selectBestPeer(const std::shared_ptr<Task>& task);
+
+    /**
+     * @brief Queue push/pop that keep queued_demand_ in step
+     * PRECONDITION: queue_mutex_ is held by the caller
+     *
+     * MLFQ: pushTask files a task under its priority level; popTask takes
+     * from the highest non-empty level. Without mlfq there is one level.
+     */
+    void pushTask(std::shared_ptr<Task> task);
+    std::shared_ptr<Task> popTask();
+
+    /**
+     * @brief MLFQ priority boost: moves every queued task back to level 0
+     *
+     * Lower levels are appended behind level 0 in level order, so tasks
+     * keep their relative order. Without it, demotion only goes down and
+     * a long task can wait forever behind a steady stream of short ones.
+     */
+    void boostPriorities();
+
+    /// @brief Next task popTask() would return (null if none); caller holds queue_mutex_
+    const std::shared_ptr<Task>& peekTaskLocked() const;
+
+    /**
+     * @brief Whether a task's demand fits next to the running tasks
+     * PRECONDITION: queue_mutex_ is held by the caller
+     *
+     * An idle node always fits, so an oversized task cannot starve.
+     */
+    bool fitsLocked(const Task& task) const;
+
+    /**
+     * @brief Whether a task should be discarded instead of run
+     * PRECONDITION: queue_mutex_ is held by the caller
+     * @return true if it is tombstoned, or expired with drop_expired_tasks
+     */
+    bool isDeadLocked(const Task& task) const;
+
+    /**
+     * @brief Like isDeadLocked(), and consumes the tombstone if there is one
+     * PRECONDITION: queue_mutex_ is held by the caller
+     * @param task Task just taken off the queue (or just received)
+     * @param expired Set to true if the reason is the deadline
+     */
+    bool reapLocked(const Task& task, bool& expired);
+
+    /// @brief Metrics and logging for a task discarded by reapLocked()
+    void recordDiscard(const Task& task, bool expired);
+
+    /// @brief Remembers where a task was sent, for forwarding cancels
+    void rememberForward(int task_id, int peer_id);
+
+    /// @brief Drops tombstones and forwarding records past their lifetime
+    void purgeCancellations();
+
+    /**
+     * @brief Duplicate suppression for a task arriving at this node
+     * PRECONDITION: queue_mutex_ is held by the caller
+     * @param task Task about to be queued
+     * @param cache_hit Set to true if the result cache answered it
+     * @return true if the task needs no execution of its own: its result is
+     *         cached, or an identical task is queued or running here and it
+     *         has been attached to that one (coalesce_duplicates)
+     */
+    bool absorbDuplicateLocked(const std::shared_ptr<Task>& task, bool& cache_hit);
+
+    /// @brief Completes a task without running it (cache hit, or follower
+    ///        of a leader that just ran)
+    void completeAbsorbed(const std::shared_ptr<Task>& task, bool cache_hit);
+
+    /**
+     * @brief After a content-keyed task ran here: caches its result and
+     *        completes the identical tasks coalesced with it
+     */
+    void completeDuplicates(const Task& task);
+
+    /**
+     * @brief A coalescing leader left without running (transferred or
+     *        discarded); its followers are re-admitted, so one of them
+     *        becomes the new leader
+     */
+    void releaseFollowers(const Task& task);
+
+    /**
+     * @brief Sends a duplicate to a peer that advertised its result
+     * @return true if the task was handed off
+     */
+    bool routeToCacheHolder(std::shared_ptr<Task> task);
+
+    /// @brief Broadcasts keys cached since the last call (CACHE_HINT)
+    void sendCacheHints();
+
+    /// @brief Applies a peer's CACHE_HINT to key_hints_
+    void handleCacheHint(const Message& message);
+
+    /// @brief TASK_COMPLETE to the task's last sender (robust routing or bandit)
+    void acknowledgeCompletion(const std::shared_ptr<Task>& task);
+
+    /**
+     * @brief Bandit features of one candidate peer
+     * PRECONDITION: peer_loads_mutex_ is held by the caller
+     * @param load Peer's last reported queue length
+     * @param age_ms Age of that report
+     * @return {1, load / load_threshold, view age (s), ack latency EWMA (s),
+     *          ack rate EWMA}, each capped so one outlier cannot dominate
+     */
+    BanditContext banditContextLocked(int peer_id, int load, double age_ms) const;
+
+    /**
+     * @brief Remembers the context of a transfer the bandit chose
+     * @param task_id Transferred task; its TASK_COMPLETE is the feedback
+     * @param peer_id Receiver
+     */
+    void recordBanditDecision(int task_id, int peer_id);
+
+    /**
+     * @brief Trains the bandit on one outcome
+     * PRECONDITION: peer_loads_mutex_ is held by the caller
+     * @param task_id Task whose outcome is known
+     * @param completion_s Transfer to acknowledgement time (or the timeout)
+     * @param acked false if the ack never came
+     */
+    void applyBanditFeedbackLocked(int task_id, double completion_s, bool acked);
+
+    /// @brief Scores decisions whose ack is overdue as failures
+    void expireBanditFeedback();
+
+    /// @brief getResourcePressure() body; caller holds queue_mutex_
+    ResourceVector pressureLocked() const;
+
+    /**
+     * @brief DRF routing score: max pressure over resources the task uses
+     * @param pressure A node's per-resource pressure
+     * @param demand The task being placed
+     */
+    static double dominantPressure(const ResourceVector& pressure, const ResourceVector& demand);
+
+    /**
+     * @brief Spends one transfer credit on the link to a peer
+     * @param peer_id Destination of the migration
+     * @return true if allowed (flow control off, or a credit was available)
+     *
+     * Called right before every TASK_TRANSFER this node originates.
+     */
+    bool consumeCredit(int peer_id);
+
+    /**
+     * @brief Stamps this node's current load and a fresh version into a message
+     * @param message Outgoing message (any type)
+     * @return The load value that was stamped
+     *
+     * Load is sampled and the Lamport clock ticked under queue_mutex_, so
+     * version order always matches sampling order across sender threads.
+     */
+    int stampLoadHeader(Message& message);
+
+    /**
+     * @brief Applies a load report about a peer to the local view
+     * @param peer_id Node the report is about
+     * @param load Reported queue size
+     * @param version Report version (-1 = unversioned, always applied)
+     * @param age_ms Age of the report on arrival (0 for first-hand reports)
+     * @param piggybacked true if taken from a non-LOAD_UPDATE header
+     * @return true if applied, false if older than the entry already held
+     * PRECONDITION: peer_loads_mutex_ is held by the caller
+     *
+     * ORDERING: Delayed or reordered reports carry a lower version than the
+     * entry already held and are discarded, never overwriting newer data.
+     */
+    bool updatePeerView(int peer_id, int load, long version, int age_ms, bool piggybacked);
+
+    /**
+     * @brief Advances the Lamport clock past a received timestamp
+     * @param timestamp Version from a received message header
+     *
+     * clock = max(clock, timestamp); the next send then ticks past it.
+     */
+    void observeLamport(long timestamp);
+
+    /**
+     * @brief Load value this node puts in its reports
+     * @param true_load Actual queue size
+     * @param version Version of the report being stamped
+     * @return true_load for honest nodes; the lie for misbehaving ones
+     */
+    int advertisedLoad(int true_load, long version) const;
+
+    /**
+     * @brief Robust routing: notes a transfer we just sent to a peer
+     */
+    void recordOutstanding(int peer_id, int task_id);
+
+    /**
+     * @brief Robust routing: compares a peer's advertised load with evidence
+     * @param peer_id Peer whose report was just applied
+     * @param load Advertised load
+     * @param sampled When the peer measured it
+     * PRECONDITION: peer_loads_mutex_ is held by the caller
+     *
+     * If load + num_workers + 1 < outstanding tasks sent well before the
+     * report was sampled, the peer is hiding work we gave it: trust is
+     * halved. Acknowledgements (TASK_COMPLETE) slowly restore it, so a peer
+     * that recovers regains traffic.
+     */
+    void checkPeerReport(int peer_id, int load, std::chrono::steady_clock::time_point sampled);
+
+    /**
+     * @brief Tells the home nodes of a finished task's successors
+     * @param task Task that just completed on this node
+     */
+    void notifySuccessors(const std::shared_ptr<Task>& task);
+
+    /**
+     * @brief Home-node side of DEPENDENCY_RESOLVED
+     * @param predecessor Completed task
+     * @param executed_on Node that ran it (where its output lives)
+     */
+    void resolveDependency(const Task& predecessor, int executed_on);
+
+    /**
+     * @brief Places a task whose dependencies are all met
+     *
+     * Offers it to the best peer by selectBestPeer() (which, with
+     * dag_locality, charges each candidate for fetching remote inputs) and
+     * enqueues locally if no peer is cheaper or the send fails.
      */
-    int selectBestPeer();
+    void placeReleasedTask(std::shared_ptr<Task> task);
+
+    /**
+     * @brief Broadcasts this node's load, with per-link credits if enabled
+     * @param current_load Queue size to advertise
+     *
+     * CREDIT GRANTS:
+     * - Free capacity = (queue_capacity, or load_threshold if unbounded) - load
+     *   + tasks the workers are expected to finish before the next grant
+     *   (num_workers * load_tick_ms / observed mean service time)
+     * - Split evenly across peers; the remainder rotates between rounds
+     * - Sum of grants never exceeds free capacity, so simultaneous offloads
+     *   from every peer cannot overshoot this node (with instant delivery)
+     */
+    void sendLoadUpdate(int current_load);
+
+    /**
+     * @brief Computes how many more tasks this node can absorb before the next grant
+     * @param current_load Queue size the grant is based on
+     * @return Free transfer slots (>= 0), to be split across peers
+     */
+    int freeTransferSlots(int current_load) const;
+
+    /**
+     * @brief Sends an anti-entropy digest to one peer
+     * @param peer_id Receiver
+     * @param type GOSSIP_DIGEST (push, expects a reply) or GOSSIP_DIGEST_REPLY
+     * @param full_sync true = include every known entry, not just the delta
+     *
+     * DELTA: Includes only entries whose version is newer than what we last
+     * sent or received on this link (digest_sent_), plus our own entry.
+     * The receiver never gets an entry about itself.
+     */
+    void sendDigest(int peer_id, MessageType type, bool full_sync);
+
+    /**
+     * @brief Merges a received digest and answers pushes with a reply
+     * @param message GOSSIP_DIGEST or GOSSIP_DIGEST_REPLY
+     *
+     * Every entry the sender reported is recorded as known by the sender, so
+     * the reply carries only what the sender is missing (push-pull).
+     */
+    void handleDigest(const Message& message);
+
+    /**
+     * @brief Pushes a task onto the local queue without any capacity check
+     * @param task Task to enqueue
+     *
+     * Used for tasks the node already owns (e.g., an offload that found no
+     * peer) and by the admission paths once they have decided to accept.
+     */
+    void enqueueTask(std::shared_ptr<Task> task);
+
+    /**
+     * @brief Accepts a task migrated from a peer (TASK_TRANSFER)
+     * @param task Migrated task
+     * @param sender_id Node that sent it (for logging)
+     *
+     * A full bounded queue redirects (REDIRECT policy) or rejects the task.
+     * BLOCK is not honored here: stalling the message processor would also
+     * stall gossip, and two full nodes blocking on each other would deadlock.
+     */
+    void acceptTransferredTask(std::shared_ptr<Task> task, int sender_id);
+
+    /**
+     * @brief Forwards a task that does not fit locally to the least-loaded peer
+     * @param task Task to forward
+     * @return true if forwarded, false if rejected (no lighter peer, or the
+     *         task exhausted config_.max_redirects)
+     */
+    bool redirectTask(std::shared_ptr<Task> task);
+
+    /**
+     * @brief Cluster-level admission decision for a new ingress task
+     * @return true if the gossip-estimated average load is below the limit
+     *
+     * ESTIMATE: (own queue + sum of peer_loads_) / (known peers + 1)
+     * Stale by up to one gossip period, which is acceptable for shedding.
+     */
+    bool admitTask();
+
+    /**
+     * @brief Checks whether the bounded queue is at capacity
+     * @return false if the queue is unbounded
+     * PRECONDITION: queue_mutex_ is held by the caller
+     */
+    bool isQueueFull() const;
 
     /**
      * MEMBER VARIABLES: Node state and synchronization primitives
@@ -349,19 +1083,160 @@ private:
 
     // Identity and configuration
     int id_;                              ///< Unique node identifier (immutable)
-    int load_threshold_;                  ///< Queue size triggering offloading
+    NodeConfig config_;                   ///< Policy parameters (immutable)
 
     // Performance metrics
     std::atomic<int> tasks_processed_;    ///< Total tasks completed (lock-free)
+    std::atomic<double> avg_service_ms_;  ///< EWMA of task execution time (0 = unknown)
 
     // Task queue (producer-consumer pattern)
-    std::queue<std::shared_ptr<Task>> task_queue_;  ///< FIFO task queue
-    mutable std::mutex queue_mutex_;                ///< Protects task_queue_
+    /// One FIFO per MLFQ level, highest priority first (a single FIFO
+    /// unless config_.mlfq). Always accessed through pushTask/popTask.
+    std::vector<std::queue<std::shared_ptr<Task>>> task_queues_;
+    int queued_tasks_;                              ///< Tasks across all levels
+    std::chrono::steady_clock::time_point last_boost_;  ///< Last MLFQ boost (load monitor only)
+    int running_tasks_;                             ///< Tasks on workers (under queue_mutex_)
+    mutable std::mutex queue_mutex_;                ///< Protects task_queues_ and queued_tasks_
     std::condition_variable queue_cv_;              ///< Signals new task arrival
+    std::condition_variable space_cv_;              ///< Signals a freed slot (BLOCK mode)
+
+    // Multi-resource occupancy (under queue_mutex_)
+    ResourceVector capacity_;       ///< Resolved capacity (cpu = num_workers if unset)
+    ResourceVector in_use_;         ///< Sum of demands of running tasks
+    ResourceVector queued_demand_;  ///< Sum of demands of queued tasks
+
+    // Cancellation state (under queue_mutex_)
+    std::map<int, std::chrono::steady_clock::time_point> tombstones_;  ///< Cancelled ID -> when
+    /// Task ID -> (peer it was sent to, when); lets cancels follow the task
+    std::map<int, std::pair<int, std::chrono::steady_clock::time_point>> forwarded_to_;
+
+    // Duplicate suppression (under queue_mutex_)
+    struct CoalescedGroup {
+        int leader_id;                                  ///< The copy that runs
+        std::vector<std::shared_ptr<Task>> followers;   ///< Completed with it
+    };
+    std::map<uint64_t, CoalescedGroup> coalesced_;     ///< Content key -> group here
+    std::list<uint64_t> cache_lru_;                    ///< Cached keys, most recent first
+    std::map<uint64_t, std::list<uint64_t>::iterator> result_cache_;  ///< Key -> LRU slot
+    std::vector<uint64_t> unadvertised_keys_;          ///< Cached since the last CACHE_HINT
+
+    // Power state for consolidation (under queue_mutex_)
+    bool dormant_;                                       ///< Parked: not taking work
+    std::chrono::steady_clock::time_point idle_since_;   ///< Empty and idle since (epoch = busy)
+    std::chrono::steady_clock::time_point wake_ready_at_; ///< Workers resume after this
+    std::chrono::steady_clock::time_point awake_since_;  ///< Start of the current awake period
+    double awake_seconds_;                               ///< Completed awake periods
+    int dormant_ticks_;                                  ///< Load ticks since parking (load monitor only)
+
+    // Buddy replication, primary side (under queue_mutex_)
+    std::map<int, std::shared_ptr<Task>> queued_by_id_;  ///< Queued tasks by ID (buddy_replication only)
+    std::set<int> replicated_ids_;                       ///< IDs the buddy mirrors
+    int replica_buddy_;                                  ///< Receiver of the last delta (-1 = none)
+
+    // Durable queue (pointer under queue_mutex_; null when off or crashed)
+    std::unique_ptr<TaskJournal> journal_;
+
+    // Task ledger and snapshot state (under ledger_mutex_)
+    LocalSnapshot ledger_;          ///< Running counts (snapshot_id unused)
+    LocalSnapshot snapshot_;        ///< Latest snapshot recorded here (-1 = none)
+    std::set<int> markers_from_;    ///< Channels closed for snapshot_
+    std::set<int> markers_pending_; ///< Live nodes whose marker snapshot_ still awaits
+    bool snapshot_open_;            ///< Still counting channel tasks
+    mutable std::mutex ledger_mutex_;
+    std::mutex cut_mutex_;          ///< Orders task sends against marker sends
+
+    /**
+     * @struct PeerLoadEntry
+     * @brief What this node believes about one peer's load
+     */
+    struct PeerLoadEntry {
+        int load = 0;                                   ///< Reported queue size
+        long version = -1;                              ///< Reporter's Lamport timestamp
+        std::chrono::steady_clock::time_point sampled;  ///< When the peer measured it
+                                                        ///< (arrival time - reported age)
+        ResourceVector pressure{};                      ///< Header resource summary
+        long pressure_version = -1;                     ///< Version of pressure (-1 = none)
+        bool dormant = false;                           ///< Parked (consolidation)
+    };
 
     // Peer load tracking (gossip protocol state)
-    std::map<int, int> peer_loads_;       ///< Map: peer_id -> queue_size
-    mutable std::mutex peer_loads_mutex_; ///< Protects peer_loads_
+    /**
+     * @struct PeerTrust
+     * @brief Robust routing evidence about one peer
+     *
+     * outstanding counts tasks we transferred to the peer that it has not
+     * yet acknowledged with TASK_COMPLETE (ran it) or TASK_RELEASED (passed
+     * it on or shed it). An honest peer holds them in its queue or its
+     * workers, so it cannot advertise much less than that.
+     */
+    struct PeerTrust {
+        double trust = 1.0;   ///< 0..1, scales the peer's selection weight
+        std::map<int, std::chrono::steady_clock::time_point> outstanding;  ///< Task ID -> sent, not yet acknowledged
+    };
+
+    std::map<int, PeerLoadEntry> peer_loads_;  ///< Map: peer_id -> latest load report
+    std::map<int, int> peer_credits_;     ///< Map: peer_id -> transfer credits it granted us
+    std::map<int, PeerTrust> peer_trust_; ///< Map: peer_id -> trust (robust_routing only)
+    mutable std::mutex peer_loads_mutex_; ///< Protects peer_loads_, peer_credits_, peer_trust_
+    int credit_round_;                    ///< Rotates remainder credits (load monitor only)
+    std::atomic<long> lamport_clock_;     ///< Lamport clock; stamps our load reports
+
+    // Digest gossip state (DIGEST mode)
+    /// Map: peer_id -> (node_id -> newest version that peer is known to hold);
+    /// protected by peer_loads_mutex_
+    std::map<int, std::map<int, long>> digest_sent_;
+    int digest_round_;                    ///< Gossip round counter (load monitor only)
+    int balance_round_;                   ///< Dimension-exchange round (load monitor only)
+    std::mt19937 gossip_rng_;             ///< Picks digest targets (load monitor only)
+
+    // Cache hints from peers (under peer_loads_mutex_). Bounded FIFO: each
+    // hint has a sequence number, and the order queue evicts a key only if
+    // its entry has not been refreshed since.
+    std::map<uint64_t, std::pair<int, long>> key_hints_;  ///< Key -> (holder, seq)
+    std::deque<std::pair<uint64_t, long>> key_hint_order_;
+    long key_hint_seq_;
+
+    // Bandit routing state (under peer_loads_mutex_)
+    struct PeerFeedback {
+        double ack_latency_s = 0.0;  ///< EWMA of transfer -> TASK_COMPLETE time
+        double ack_rate = 1.0;       ///< EWMA of acked (1) vs timed out (0)
+    };
+    struct PendingFeedback {
+        int peer;
+        BanditContext context;                      ///< Features at decision time
+        std::chrono::steady_clock::time_point sent;
+    };
+    std::map<int, PeerFeedback> peer_feedback_;       ///< Map: peer_id -> ack statistics
+    std::map<int, PendingFeedback> pending_feedback_; ///< Map: task_id -> open decision
+    LinUCB bandit_;                                   ///< Shared model over all peers
+
+    // SOS help recruitment (under peer_loads_mutex_)
+    struct HelpTarget {
+        int load;                                       ///< Origin's last known load
+        std::chrono::steady_clock::time_point expires;  ///< Forgotten after this
+    };
+    std::map<int, HelpTarget> help_targets_;  ///< Map: overloaded origin -> last report
+    std::map<int, int> rumors_seen_;          ///< Map: origin -> newest rumor ID relayed
+    int steal_from_;                          ///< Origin of the steal in flight (-1 = none)
+    std::chrono::steady_clock::time_point steal_sent_;
+    int sos_id_;                              ///< Our rumor counter
+    bool sos_armed_;                          ///< Next crossing may raise an SOS
+    std::chrono::steady_clock::time_point last_sos_;
+    std::mt19937 rumor_rng_;                  ///< Picks rumor targets
+
+    // Buddy replication, mirror side (under peer_loads_mutex_)
+    std::map<int, std::map<int, std::shared_ptr<Task>>> replicas_;  ///< Origin -> task ID -> descriptor
+    std::set<int> failed_peers_;                                    ///< Declared failed, until a direct LOAD_UPDATE
+    std::map<int, std::vector<int>> recovered_ids_;                 ///< Failed peer -> task IDs we requeued for it
+
+    // DAG dependency tracker (tasks homed here)
+    struct ParkedTask {
+        std::shared_ptr<Task> task;
+        int pending;                      ///< Predecessors not yet completed
+    };
+    std::map<int, ParkedTask> parked_;                ///< Successor ID -> parked task
+    std::map<int, std::vector<int>> waiting_on_;      ///< Predecessor ID -> successor IDs
+    mutable std::mutex dag_mutex_;                    ///< Protects parked_ and waiting_on_
 
     // Topology information
     std::vector<int> peers_;              ///< List of known peer IDs
@@ -377,11 +1252,14 @@ private:
     std::thread load_monitor_thread_;          ///< Gossip + offloading thread
     std::thread message_processor_thread_;     ///< Message handling thread
 
-    // Control flag
+    // Control flags
     std::atomic<bool> running_;           ///< Signals threads to continue/stop
+    std::atomic<bool> crashed_;           ///< Fail-stop injected; drop everything
 
     // External dependencies
     NetworkManager* network_manager_;     ///< Network layer (not owned)
+    Metrics* metrics_;                    ///< Run-wide metrics (not owned, may be null)
+    TaskAudit* audit_;                    ///< Exactly-once audit (not owned, may be null)
 
     /**
      * SYNCHRONIZATION DESIGN NOTES:
@@ -401,7 +1279,11 @@ private:
      *
      * Deadlock prevention:
      * - Lock ordering: Always acquire in same order if multiple locks needed
-     * - Currently: Each method locks only one mutex (no deadlock possible)
+     * - Currently: selectBestPeer() takes peer_loads_mutex_ then its own
+     *   queue_mutex_; nothing takes them in the opposite order. Other
+     *   nodes' queues (ORACLE, regret) are read without peer_loads_mutex_
+     * - cut_mutex_ is taken before ledger_mutex_, and with no other lock
+     *   held; ledger_mutex_ is a leaf
      * - If adding cross-lock code: Document lock order carefully
      */
 };
@@ -0,0 +1,69 @@
+/**
+ * @file QueueingModel.h
+ * @brief Closed-form and mean-field predictions for validating the simulator
+ *
+ * DESIGN RATIONALE:
+ * - Benchmark numbers are only as good as the simulator's timing. Runs
+ *   whose answer is known (Poisson arrivals, exponential service) let a
+ *   numeric check catch a change that skews service times, dispatch or
+ *   latency accounting (see the "validate" benchmark)
+ * - Everything is computed in seconds from rates; callers convert
+ * - At rho >= 1 there is no steady state: the queue grows without bound.
+ *   Predictions are then flagged unstable with infinite figures rather
+ *   than a negative wait or a tail sum that never terminates
+ *
+ * MODELS:
+ * - M/M/c: one node with c workers fed at rate lambda; Erlang C gives the
+ *   waiting probability, waiting time is exponential given a wait
+ * - Power-of-d (JSQ(d)): each arrival joins the shortest of d queues sampled
+ *   from N single-worker nodes. As N grows, the fraction of queues holding
+ *   at least k tasks tends to s_k = rho^((d^k - 1) / (d - 1)) (d = 1 is
+ *   M/M/1). An arrival sees k tasks with probability s_k^d - s_(k+1)^d and
+ *   then waits for k + 1 exponential services
+ *
+ * ACADEMIC CONTEXT:
+ * - Erlang C: Kleinrock, "Queueing Systems, Volume 1: Theory" (1975)
+ * - Mitzenmacher, "The power of two choices in randomized load balancing"
+ *   (IEEE TPDS 2001); Vvedenskaya, Dobrushin & Karpelevich, "Queueing
+ *   system with selection of the shortest of two queues" (1996)
+ */
+
+#ifndef QUEUEINGMODEL_H
+#define QUEUEINGMODEL_H
+
+/**
+ * @struct QueuePrediction
+ * @brief Steady-state figures of one model (finite only when rho < 1)
+ */
+struct QueuePrediction {
+    bool stable = true;            ///< false if rho >= 1: every figure is infinite
+    double mean_response_s = 0.0;  ///< Arrival -> completion
+    double p99_response_s = 0.0;
+    double mean_queued = 0.0;      ///< Waiting tasks per node, excluding those in service
+};
+
+/**
+ * @brief Erlang C: probability an arrival has to wait
+ * @param servers Workers c
+ * @param offered_load lambda / mu
+ * @return 1 when offered_load >= servers (every arrival waits)
+ */
+double erlangC(int servers, double offered_load);
+
+/**
+ * @brief M/M/c node
+ * @param arrival_rate lambda, tasks/s into this node
+ * @param service_rate mu, tasks/s per worker
+ * @param servers Workers c
+ */
+QueuePrediction predictMMc(double arrival_rate, double service_rate, int servers);
+
+/**
+ * @brief Power-of-d dispatch over single-worker nodes, mean-field limit
+ * @param utilization rho = per-node arrival rate / service rate (< 1)
+ * @param service_rate mu, tasks/s
+ * @param choices d (1 = random dispatch, i.e. M/M/1 per node)
+ */
+QueuePrediction predictPowerOfD(double utilization, double service_rate, int choices);
+
+#endif // QUEUEINGMODEL_H
@@ -0,0 +1,63 @@
+/**
+ * @file Resources.h
+ * @brief Multi-resource demand/capacity vectors and dominant-share helpers
+ *
+ * DESIGN RATIONALE:
+ * - Jobs need CPU, memory and I/O, and nodes saturate on different ones;
+ *   queue length alone cannot tell a memory-starved node from an idle one
+ * - A fixed three-slot array keeps vectors cheap to copy and to gossip
+ * - A node's "pressure" on a resource is (in use + queued demand) / capacity;
+ *   its dominant pressure is the maximum over resources
+ *
+ * ACADEMIC CONTEXT:
+ * - Dominant Resource Fairness: Ghodsi et al., "Dominant Resource Fairness:
+ *   Fair allocation of multiple resource types" (NSDI 2011)
+ * - Multi-dimensional bin packing for cluster placement: Grandl et al.,
+ *   "Multi-resource packing for cluster schedulers" (Tetris, SIGCOMM 2014)
+ */
+
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+/// Resource dimensions (indices into ResourceVector)
+const size_t RESOURCE_CPU = 0;     ///< Cores (one worker thread = one core)
+const size_t RESOURCE_MEMORY = 1;  ///< GB
+const size_t RESOURCE_IO = 2;      ///< MB/s of disk/network bandwidth
+const size_t RESOURCE_COUNT = 3;
+
+/// Amount of each resource (a task's demand or a node's capacity)
+using ResourceVector = std::array<double, RESOURCE_COUNT>;
+
+/**
+ * @brief Human-readable name of a resource dimension
+ */
+inline std::string resourceName(size_t resource) {
+    switch (resource) {
+        case RESOURCE_CPU:    return "cpu";
+        case RESOURCE_MEMORY: return "memory";
+        case RESOURCE_IO:     return "io";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Largest share of any capacity a demand takes
+ * @param demand Amount requested per resource
+ * @param capacity Amount available per resource (<= 0 = unlimited, ignored)
+ * @return max over limited resources of demand / capacity
+ */
+inline double dominantShare(const ResourceVector& demand, const ResourceVector& capacity) {
+    double share = 0.0;
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        if (capacity[r] > 0.0 && demand[r] / capacity[r] > share) {
+            share = demand[r] / capacity[r];
+        }
+    }
+    return share;
+}
+
+#endif // RESOURCES_H
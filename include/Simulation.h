@@ -0,0 +1,253 @@
+/**
+ * @file Simulation.h
+ * @brief Reusable driver that builds a cluster, generates load and collects results
+ *
+ * DESIGN RATIONALE:
+ * - Separates "run one experiment" from main()'s command-line handling
+ * - A SimulationConfig fully describes a run; a SimulationResult summarizes it
+ * - Benchmarks compare policies by running several configs back-to-back
+ *
+ * EXPERIMENT LIFECYCLE (Simulation::run):
+ * 1. Create NetworkManager + N PeerNodes (fully connected mesh), start them
+ * 2. Generate tasks at a fixed rate onto random nodes for duration_seconds
+ * 3. Stop generation, let the cluster drain for drain_seconds
+ * 4. Snapshot per-node counters and latency percentiles, stop all nodes
+ *
+ * ACADEMIC CONTEXT:
+ * - Open-loop arrivals (fixed rate regardless of completions) expose overload
+ *   behavior; closed-loop generators hide it (Schroeder et al., NSDI 2006)
+ * - Offered load is expressed relative to estimateCapacity() so experiments
+ *   scale with node count and task sizes
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include "NodeConfig.h"
+#include "NetworkManager.h"
+#include "TaskAudit.h"
+
+/**
+ * @struct SimulationConfig
+ * @brief Everything needed to reproduce one simulation run
+ */
+struct SimulationConfig {
+    int num_nodes = 5;                          ///< Cluster size
+    int duration_seconds = 30;                  ///< Task generation window
+    int drain_seconds = 3;                      ///< Processing time after generation stops
+    double task_generation_interval_ms = 100.0; ///< Time between task arrivals (0 = no arrivals)
+    int min_task_complexity = 50;               ///< Min processing time (ms)
+    int max_task_complexity = 200;              ///< Max processing time (ms)
+    double long_task_fraction = 0.0;            ///< Share of arrivals that are long tasks
+    int long_task_complexity = 1000;            ///< Processing time of a long task (ms)
+    int hot_nodes = 1;                          ///< Nodes 0..hot_nodes-1 form the hot set
+    double hot_node_fraction = 0.0;             ///< Share of arrivals sent to the hot set (0 = uniform)
+    unsigned int seed = 0;                      ///< RNG seed (0 = nondeterministic)
+    bool poisson_arrivals = false;              ///< Exponential gaps (mean = interval) instead of fixed
+    bool exponential_service = false;           ///< Task sizes ~ Exp, mean (min + max) / 2 complexity
+    /// Dispatch each arrival to the node with the fewest tasks in system
+    /// among this many sampled at random (JSQ(d); >= num_nodes = JSQ;
+    /// 0 = random/hot-set target as configured)
+    int dispatch_choices = 0;
+    bool verbose = false;                       ///< Print per-second progress and per-node table
+    NodeConfig node;                            ///< Configuration applied to every node
+    std::map<int, Misbehavior> misbehaving_nodes;  ///< Fault injection: node ID -> behavior
+
+    /// Multi-resource workload: each task draws one demand vector uniformly
+    /// from this list (empty = CPU-only tasks, {1 core, 0, 0})
+    std::vector<ResourceVector> task_demand_mix;
+    /// Heterogeneous nodes: node i gets node_capacities[i % size] as its
+    /// resource_capacity (empty = node.resource_capacity everywhere)
+    std::vector<ResourceVector> node_capacities;
+    RateLimit link_rate_limit;                  ///< Budget per directed link (default unlimited)
+
+    /// Geo model: nodes are dealt round-robin into num_zones zones (node i
+    /// is in zone i % num_zones). zone_latency_ms[a][b] is the
+    /// one-way latency from zone a to zone b; empty = all links instant.
+    int num_zones = 1;
+    std::vector<std::vector<double>> zone_latency_ms;
+    double link_bandwidth_bytes_per_sec = 0.0;  ///< Every link's bandwidth (0 = unlimited)
+    std::string link_matrix_file;               ///< Per-node-pair matrix; overrides zone latencies
+    std::map<MessageClass, RateLimit> class_rate_limits;  ///< Budget per node per traffic class
+
+    /// DAG workload: each arrival becomes a split -> dag_fanout maps ->
+    /// reduce job homed at the target node (0 = independent tasks)
+    int dag_fanout = 0;
+    int dag_input_transfer_ms = 0;              ///< Cost per input fetched from another node
+
+    int task_deadline_ms = 0;                   ///< Relative deadline of every task (0 = none)
+    /// Share of tasks the client cancels cancel_after_ms after submitting
+    /// them (sent to the node it submitted to; cancels follow migrations)
+    double cancel_fraction = 0.0;
+    int cancel_after_ms = 200;
+
+    /// Identical-request workload: each task gets a content key drawn from
+    /// 1..key_space with Zipf(key_zipf_s) popularity, and its size is a
+    /// function of the key (0 = every task unique)
+    int key_space = 0;
+    double key_zipf_s = 1.0;
+
+    /// Balancing convergence: this many tasks land on node 0 when the run
+    /// starts, and the queue spread (max - min) is sampled every 20ms until
+    /// it is at most balance_tolerance
+    int initial_tasks = 0;
+    int balance_tolerance = 4;
+    /// Connect node i only to the nodes whose ID differs in one bit
+    /// (log2(n) neighbors) instead of the full mesh
+    bool hypercube_overlay = false;
+
+    /// Load step: from surge_at_seconds into the run, arrivals come
+    /// surge_factor times faster (0 = no step)
+    int surge_at_seconds = 0;
+    double surge_factor = 1.0;
+
+    /// Fail-stop crash of node crash_node crash_at_seconds into the run
+    /// (-1 = none); arrivals aimed at it go to the next node instead
+    int crash_node = -1;
+    int crash_at_seconds = 0;
+    /// Restart the crashed node this long after the crash (0 = stays down);
+    /// with node.journal_dir set it requeues its journaled backlog
+    int restart_after_seconds = 0;
+
+    /// Take a consistent global snapshot (Chandy-Lamport) every second; the
+    /// progress line then reports exact in-system totals incl. in-flight tasks
+    bool snapshots = false;
+
+    /// Exactly-once audit: track every task ID in bitmaps and report lost,
+    /// duplicated and in-flight tasks after shutdown (TaskAudit)
+    bool audit = false;
+};
+
+/**
+ * @struct SimulationResult
+ * @brief Aggregate outcome of one run
+ */
+struct SimulationResult {
+    int tasks_generated = 0;        ///< Tasks offered by the generator
+    int tasks_processed = 0;        ///< Tasks executed by all nodes
+    int tasks_remaining = 0;        ///< Tasks still queued at the end
+    int admission_rejects = 0;      ///< Tasks refused by admission control
+    int overflow_rejects = 0;       ///< Tasks dropped by full queues
+    int redirects = 0;              ///< Overflow redirects to peers
+    double blocked_seconds = 0.0;   ///< Producer time spent blocked (BLOCK mode)
+    int transfers = 0;              ///< Tasks accepted through TASK_TRANSFER
+    int transfer_overshoots = 0;    ///< Transfers that left the receiver above threshold
+    int peak_node_load = 0;         ///< Largest single queue seen (sampled each second)
+    double mean_queued_per_node = 0.0;  ///< Time-average queue length (sampled every 50 ms)
+    double backlog_growth_per_sec = 0.0;  ///< Slope of generated - completed over the window's second half
+    double idle_while_waiting_seconds = 0.0;  ///< Worker time idle while another node had tasks queued (sampled)
+    double work_conservation = 100.0;   ///< Busy / (busy + idle while waiting) worker time, percent
+    double mean_view_age_ms = 0.0;  ///< Mean age of the peer load entry behind each routing decision
+    int view_updates = 0;           ///< Peer load view refreshes applied (all sources)
+    int piggybacked_view_updates = 0;  ///< ...of which came from message headers
+    double messages_per_node_per_sec = 0.0;  ///< Network messages during generation
+    double bytes_per_node_per_sec = 0.0;     ///< Network bytes during generation
+    long long messages_dropped = 0;          ///< Discarded by DROP rate limits
+    long long messages_delayed = 0;          ///< Held back by QUEUE rate limits
+    double rate_limit_delay_seconds = 0.0;   ///< Time messages were held waiting for tokens
+    int cross_zone_transfers = 0;            ///< Migrated tasks that crossed zones
+    int tasks_lost = 0;                      ///< Swallowed by black-hole nodes or a crash
+    ResourceVector mean_utilization{};       ///< Per resource, averaged over nodes and seconds
+
+    double goodput = 0.0;           ///< Tasks completed per second during generation
+    double mean_latency_ms = 0.0;   ///< Mean end-to-end latency of completed tasks
+    double p50_latency_ms = 0.0;    ///< Median latency
+    double p99_latency_ms = 0.0;    ///< Tail latency
+    double short_p99_latency_ms = 0.0;  ///< p99 of regular tasks (<= max_task_complexity)
+    double long_p99_latency_ms = 0.0;   ///< p99 of long tasks (0 if none)
+    int jobs_completed = 0;             ///< DAG jobs whose sink finished
+    double mean_makespan_ms = 0.0;      ///< DAG job submission -> sink completion
+    double p99_makespan_ms = 0.0;       ///< Tail makespan
+    double mean_critical_path_ms = 0.0; ///< Lower bound on makespan (sum of the longest chain)
+    double input_fetch_seconds = 0.0;   ///< Worker time spent pulling remote DAG inputs
+    int tasks_parked = 0;               ///< DAG tasks still waiting for predecessors at the end
+    int tasks_cancelled = 0;            ///< Discarded by ID before running to completion
+    int tasks_expired = 0;              ///< Discarded past their deadline
+    double work_avoided_seconds = 0.0;  ///< Remaining work of discarded tasks
+    int late_completions = 0;           ///< Ran to completion after their deadline
+    double late_work_seconds = 0.0;     ///< Worker time spent on late completions
+    double on_time_goodput = 0.0;       ///< Completions within deadline per second
+    int tasks_coalesced = 0;            ///< Completed by an identical task's execution
+    int cache_hits = 0;                 ///< Completed from a node's result cache
+    int hint_routed = 0;                ///< Duplicates routed to an advertised cache holder
+    double dedup_saved_seconds = 0.0;   ///< Work not executed thanks to the above
+    int routing_decisions = 0;          ///< selectBestPeer() calls that picked a peer
+    long long cumulative_regret = 0;    ///< vs true-load oracle, in queued tasks
+    double mean_regret = 0.0;           ///< Per decision
+    double convergence_ms = -1.0;       ///< initial_tasks burst -> spread within tolerance (-1 = never)
+    long long convergence_messages = 0; ///< TRANSFER-class messages sent until then
+    int convergence_transfers = 0;      ///< Tasks moved until then
+    int final_spread = 0;               ///< Queue spread at the end of the generation window
+    int sos_raised = 0;                 ///< HELP_WANTED rumors started
+    int rumor_messages = 0;             ///< HELP_WANTED messages incl. relays
+    int steal_requests = 0;             ///< TASK_REQUESTs sent in answer
+    double awake_node_seconds = 0.0;    ///< Sum over nodes of time not parked (generation window)
+    double cpu_seconds = 0.0;           ///< awake_node_seconds * workers: cores kept powered
+    int parks = 0;                      ///< Nodes going dormant
+    int wakeups = 0;                    ///< Dormant nodes woken
+    int tasks_recovered = 0;            ///< Requeued from a failed node's buddy mirror
+    int tasks_withdrawn = 0;            ///< ...then dropped at the origin when it came back
+    double recovery_ms = -1.0;          ///< Crash -> mirrored backlog requeued (-1 = never)
+    double replica_bytes_per_node_per_sec = 0.0;  ///< Replica deltas piggybacked on gossip
+    int tasks_restored = 0;             ///< Requeued from a journal on restart
+    double restore_ms = 0.0;            ///< Journal open + replay + requeue
+    int snapshots_completed = 0;        ///< Snapshots every node reported
+    int snapshots_inconsistent = 0;     ///< ...whose channels disagreed with the ledgers
+    double snapshot_ms = 0.0;           ///< Mean initiation -> last report
+    double mean_in_channel = 0.0;       ///< Tasks in flight per snapshot
+    double mean_naive_error = 0.0;      ///< |sum of per-node reads - snapshot total|, tasks
+    AuditReport audit;                  ///< Exactly-once verdicts (all zero unless config.audit)
+
+    std::vector<int> processed_per_node;  ///< Indexed by node ID
+    std::vector<double> min_trust_per_node;  ///< Lowest trust any peer holds in each node at the end
+    std::vector<int> remaining_per_node;  ///< Indexed by node ID
+};
+
+/**
+ * @class Simulation
+ * @brief Runs one configured experiment on a fresh cluster
+ *
+ * Each run() builds its own network, nodes and metrics, so a Simulation
+ * object can be run repeatedly and runs never share state.
+ */
+class Simulation {
+public:
+    /**
+     * @brief Creates a simulation with the given configuration
+     * @param config Run parameters (copied)
+     */
+    explicit Simulation(const SimulationConfig& config);
+
+    /**
+     * @brief Executes the run (blocks for duration + drain seconds)
+     * @return Aggregate statistics
+     */
+    SimulationResult run();
+
+    /**
+     * @brief Estimates the cluster's service capacity
+     * @param config Run parameters
+     * @return Sustainable arrival rate in tasks/second
+     *
+     * capacity = nodes * workers / mean task time, where the mean includes
+     * the long-task share. Used to express offered load as a multiple of
+     * capacity (e.g., 2x overload).
+     */
+    static double estimateCapacity(const SimulationConfig& config);
+
+    /**
+     * @brief Computes the arrival interval that offers a given load factor
+     * @param config Run parameters
+     * @param load_factor Offered load / capacity (1.0 = saturation)
+     * @return Interval between task arrivals in milliseconds
+     */
+    static double intervalForLoad(const SimulationConfig& config, double load_factor);
+
+private:
+    SimulationConfig config_;
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,90 @@
+/**
+ * @file Snapshot.h
+ * @brief Records of a consistent global snapshot (Chandy-Lamport)
+ *
+ * DESIGN RATIONALE:
+ * - Summing getCurrentLoad() over nodes reads each queue at a different
+ *   instant and misses every task inside a TASK_TRANSFER or TASK_BATCH, so
+ *   the totals drift from what was generated minus what finished
+ * - Each node keeps a task ledger instead: tasks admitted at its ingress,
+ *   received from and sent to peers, and finished (completed, shed,
+ *   discarded or lost). admitted + received - sent - finished is what it
+ *   holds, queued, running or parked, without touching queue_mutex_
+ * - A snapshot records every ledger at a consistent cut and counts the
+ *   tasks caught in channels, so in system = held + in channels exactly
+ * - Self-check: sum(sent) - sum(received) over the cut must equal the
+ *   tasks counted in channels. A mismatch means a channel was not FIFO or
+ *   lost a task, and the snapshot is flagged rather than trusted
+ *
+ * PROTOCOL (PeerNode::initiateSnapshot / SNAPSHOT_MARKER):
+ * 1. The initiator records its ledger and sends a marker to every node
+ * 2. A node's first marker makes it record its ledger and send markers
+ *    before any further task leaves it; the marker's channel is empty
+ * 3. Until a channel's marker arrives, tasks received on it were in that
+ *    channel at the cut and are counted
+ * 4. With a marker from every other live node the local record is final
+ *    and is reported (Metrics::recordLocalSnapshot). Nodes crashed at the
+ *    cut, or declared failed by the detector, are not waited for; a node
+ *    that crashes mid-snapshot abandons its part
+ * Nothing is paused: workers, balancing and gossip keep running.
+ *
+ * ACADEMIC CONTEXT:
+ * - Chandy & Lamport, "Distributed snapshots: Determining global states of
+ *   distributed systems" (ACM TOCS 1985)
+ * - Consistent cuts: Mattern, "Virtual time and global states of
+ *   distributed systems" (1989)
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <chrono>
+
+/**
+ * @struct LocalSnapshot
+ * @brief One node's part of a snapshot
+ */
+struct LocalSnapshot {
+    int snapshot_id = -1;
+    int node_id = -1;
+    long long admitted = 0;       ///< Ledger at the cut: entered at this node
+    long long received = 0;       ///< Ledger at the cut: arrived from peers
+    long long sent = 0;           ///< Ledger at the cut: handed to the network
+    long long finished = 0;       ///< Ledger at the cut: left the system here
+    long long channel_tasks = 0;  ///< In flight to this node at the cut
+    int queued = 0;               ///< Queue length when recorded (breakdown only)
+
+    /// @brief Tasks this node held at the cut (queued, running or parked)
+    long long held() const {
+        return admitted + received - sent - finished;
+    }
+};
+
+/**
+ * @struct GlobalSnapshot
+ * @brief Sum of the local snapshots of every node
+ */
+struct GlobalSnapshot {
+    int snapshot_id = -1;
+    int nodes = 0;                ///< Local snapshots reported so far
+    long long admitted = 0;
+    long long received = 0;
+    long long sent = 0;
+    long long finished = 0;
+    long long held = 0;           ///< Sum of LocalSnapshot::held()
+    long long in_channel = 0;     ///< Sum of LocalSnapshot::channel_tasks
+    int queued = 0;
+    std::chrono::steady_clock::time_point completed_at;  ///< Last report
+
+    /// @brief Tasks in the system at the cut
+    long long inSystem() const {
+        return held + in_channel;
+    }
+
+    /// @brief Channels recorded exactly what the ledgers say was in flight
+    bool consistent() const {
+        return sent - received == in_channel;
+    }
+};
+
+#endif // SNAPSHOT_H
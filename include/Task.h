@@ -25,6 +25,10 @@
 
 #include <string>
 #include <chrono>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "Resources.h"
 
 /**
  * @class Task
@@ -47,6 +51,14 @@ public:
      */
     Task(int id, int complexity);
 
+    /**
+     * @brief Constructs a task with an explicit multi-resource demand
+     * @param id Unique identifier for this task
+     * @param complexity Processing time in milliseconds
+     * @param demand CPU/memory/I/O held for the whole execution
+     */
+    Task(int id, int complexity, const ResourceVector& demand);
+
     /**
      * @brief Gets the unique identifier for this task
      * @return Task ID
@@ -76,6 +88,31 @@ public:
      */
     std::chrono::steady_clock::time_point getCreationTime() const;
 
+    /**
+     * @brief Restores the original creation time of a task rebuilt from a
+     *        journal, so its latency still counts from first admission
+     */
+    void setCreationTime(std::chrono::steady_clock::time_point created);
+
+    /**
+     * @brief Gets the resources this task holds while executing
+     * @return Demand vector ({1 core, 0, 0} for CPU-only tasks)
+     */
+    const ResourceVector& getDemand() const;
+
+    /**
+     * @brief Tags the task with what it computes
+     * @param key Content key (0 = unique task, never deduplicated)
+     *
+     * Tasks with equal keys are identical requests: same work, same
+     * result. Nodes may run one of them for all (coalescing) or answer
+     * from a cache of earlier results (memoization).
+     */
+    void setContentKey(uint64_t key);
+
+    /// @brief Content key (0 = none)
+    uint64_t getContentKey() const;
+
     /**
      * @brief Simulates task execution by sleeping for the complexity duration
      *
@@ -88,16 +125,178 @@ public:
      * LIMITATION: This doesn't model I/O wait, memory access patterns, or
      * resource contention. Future work could use more sophisticated workload
      * models (e.g., exponential distribution for service times).
+     *
+     * Runs whatever work remains, so a task preempted by executeSlice()
+     * finishes with execute() without redoing finished slices.
      */
     void execute();
 
+    /**
+     * @brief Runs at most one scheduling quantum of the remaining work
+     * @param quantum_ms Slice length in milliseconds
+     * @return Milliseconds of work actually done (< quantum_ms on the last slice)
+     *
+     * PREEMPTION: The caller requeues the task (or migrates it) when
+     * isFinished() is still false, so long tasks stop monopolizing a worker.
+     */
+    int executeSlice(int quantum_ms);
+
+    /// @brief Milliseconds of work left (complexity minus executed slices)
+    int getRemainingWork() const;
+
+    /// @brief true once all work has been executed
+    bool isFinished() const;
+
+    /**
+     * @brief Gets the multi-level feedback queue level
+     * @return 0 (highest priority, all new tasks) and up
+     */
+    int getPriorityLevel() const;
+
+    /**
+     * @brief Moves the task one MLFQ level down
+     *
+     * Called when the task used its whole quantum without finishing: it has
+     * shown itself to be long, so it yields to newer (likely short) work.
+     */
+    void demote();
+
+    /// @brief Moves the task back to MLFQ level 0 (periodic priority boost)
+    void resetPriority();
+
+    /**
+     * DAG DEPENDENCIES:
+     * A task with predecessors is parked at its home node until every
+     * predecessor has completed (anywhere in the cluster). Predecessors
+     * carry (successor, home node) pairs so the executing node knows whom
+     * to notify; the home node records where each input was produced and
+     * may place the released task next to its inputs.
+     */
+
+    /// @brief Declares that this task needs predecessor_id's output
+    void addDependency(int predecessor_id);
+
+    /// @brief IDs of the tasks this one waits for
+    const std::vector<int>& getDependencies() const;
+
+    /**
+     * @brief Registers a task that waits for this one
+     * @param successor_id The dependent task
+     * @param home_node Node where the successor is parked
+     */
+    void addSuccessor(int successor_id, int home_node);
+
+    /// @brief (successor ID, home node) pairs to notify on completion
+    const std::vector<std::pair<int, int>>& getSuccessors() const;
+
+    /// @brief Records the node where one of this task's inputs was produced
+    void addInputNode(int node_id);
+
+    /// @brief Nodes holding this task's inputs (one entry per input)
+    const std::vector<int>& getInputNodes() const;
+
+    /**
+     * @brief Sets the cost of pulling one input from another node
+     * @param ms Transfer time per remote input (0 = inputs are free to move)
+     */
+    void setInputTransferMs(int ms);
+
+    /**
+     * @brief Time this task would spend pulling inputs if run on node_id
+     * @param node_id Candidate execution node
+     * @return Remote inputs times the per-input transfer cost, in ms
+     */
+    int inputFetchCost(int node_id) const;
+
+    /**
+     * @brief Simulates fetching inputs produced on other nodes (once)
+     * @param node_id Node the task is about to run on
+     * @return Milliseconds spent fetching
+     */
+    int fetchInputs(int node_id);
+
+    /**
+     * @brief Sets the time after which the result is no longer wanted
+     * @param deadline Absolute steady_clock time (default: none)
+     */
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+
+    /// @brief true if setDeadline() was called
+    bool hasDeadline() const;
+
+    /// @brief Absolute deadline (time_point::max() if none)
+    std::chrono::steady_clock::time_point getDeadline() const;
+
+    /// @brief true if the task has a deadline and now is past it
+    bool isExpired(std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Marks this task as a DAG sink
+     * @param ms Critical-path length of its job (sum of task sizes on the
+     *        longest dependency chain): the job's makespan lower bound
+     */
+    void setCriticalPath(int ms);
+
+    /// @brief Critical-path length of the job this sink ends (0 = not a sink)
+    int getCriticalPath() const;
+
+    /**
+     * @brief Records that this task was moved to another node
+     * @param from_node ID of the sending node
+     *
+     * Called by the sending node just before a TASK_TRANSFER (offload or
+     * overflow redirect). Bounds redirect chains so a task cannot bounce
+     * forever between full nodes, and lets experiments count migrations.
+     */
+    void recordMigration(int from_node);
+
+    /**
+     * @brief Gets how many times this task has changed nodes
+     * @return Number of migrations (0 = executed where it was submitted)
+     */
+    int getMigrationCount() const;
+
+    /**
+     * @brief Gets the node that last transferred this task
+     * @return Sender of the latest migration, or -1 if never migrated
+     *
+     * The executing node reports completion back to this node (TASK_COMPLETE)
+     * so senders can check peers actually run what they accept.
+     */
+    int getLastSender() const;
+
+    /**
+     * @brief Gets the sender of the migration before the latest one
+     * @return -1 if the task has migrated at most once
+     *
+     * A node passing a task on releases it upstream (TASK_RELEASED to this
+     * node), since the previous hop stops tracking it as outstanding.
+     */
+    int getPreviousSender() const;
+
 private:
     int id_;                  ///< Unique task identifier
     int complexity_;          ///< Processing time in milliseconds
+    int migrations_;          ///< Number of node-to-node transfers so far
+    int last_sender_;         ///< Node that sent the latest migration (-1 = none)
+    int previous_sender_;     ///< Node that sent the migration before (-1 = none)
+    ResourceVector demand_;   ///< Resources held during execution
+    int remaining_ms_;        ///< Work left; complexity_ until a slice runs
+    int priority_level_;      ///< MLFQ level (0 = highest)
+    uint64_t content_key_;    ///< Identical-request key (0 = none)
+
+    // DAG state
+    std::vector<int> dependencies_;                 ///< Predecessor IDs
+    std::vector<std::pair<int, int>> successors_;   ///< (successor ID, home node)
+    std::vector<int> input_nodes_;                  ///< Where inputs were produced
+    int input_transfer_ms_;                         ///< Fetch cost per remote input
+    bool inputs_fetched_;                           ///< fetchInputs() already ran
+    int critical_path_ms_;                          ///< > 0 on DAG sinks
 
     /// Creation timestamp for measuring queuing delay and end-to-end latency
     /// This is crucial for evaluating Quality of Service (QoS) metrics
     std::chrono::steady_clock::time_point creation_time_;
+    std::chrono::steady_clock::time_point deadline_;  ///< time_point::max() = none
 };
 
 #endif // TASK_H
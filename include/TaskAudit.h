@@ -0,0 +1,109 @@
+/**
+ * @file TaskAudit.h
+ * @brief Exactly-once audit: per-task-ID atomic bitmaps of what happened to each task
+ *
+ * DESIGN RATIONALE:
+ * - "Are tasks completed exactly once?" needs an answer per task, not per
+ *   counter: a lost task and a duplicated one cancel out in every total
+ * - One bit per task ID and event, set with a single atomic fetch_or (or
+ *   fetch_xor), so marking costs a few nanoseconds and never takes a lock;
+ *   cheap enough to leave on during performance runs
+ * - Bitmaps are split into 64K-ID chunks allocated on first touch
+ *   (compare-and-swap into a fixed directory), so memory follows the IDs
+ *   actually used and no resize ever moves a bitmap under a writer
+ * - Migrations flip an in-transit bit on send and again on receipt: a set
+ *   bit at the end means the task is inside a message, whatever the number
+ *   of hops
+ *
+ * VERDICT PER CREATED TASK (report()):
+ * - completed: done once; duplicated: completed more than once
+ * - shed: refused or discarded on purpose (admission, overflow, cancel, deadline)
+ * - in flight: neither, but still queued/parked (markHeld) or in transit
+ * - lost: none of the above; the system dropped it without a trace
+ *
+ * ACADEMIC CONTEXT:
+ * - Exactly-once processing and its audit in stream systems: Akidau et al.,
+ *   "MillWheel: Fault-tolerant stream processing at internet scale" (VLDB 2013)
+ * - Bitmap indexes: O'Neil & Quass, "Improved query performance with
+ *   variant indexes" (SIGMOD 1997)
+ */
+
+#ifndef TASKAUDIT_H
+#define TASKAUDIT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @struct AuditReport
+ * @brief Verdict over every created task ID
+ */
+struct AuditReport {
+    long long created = 0;
+    long long completed = 0;     ///< Completed at least once
+    long long duplicated = 0;    ///< ...of which more than once
+    long long shed = 0;          ///< Refused or discarded on purpose
+    long long in_flight = 0;     ///< Still queued, parked or in a message
+    long long lost = 0;          ///< Vanished without a verdict
+    std::vector<int> lost_ids;        ///< First few, for the log
+    std::vector<int> duplicated_ids;  ///< First few, for the log
+};
+
+/**
+ * @class TaskAudit
+ * @brief Lock-free bitmaps indexed by task ID (IDs >= 0; others are ignored)
+ *
+ * THREAD SAFETY: all mark*() calls may race with each other; report() is
+ * meant for the end of a run, once the cluster is quiescent.
+ */
+class TaskAudit {
+public:
+    TaskAudit();
+    ~TaskAudit();
+
+    TaskAudit(const TaskAudit&) = delete;
+    TaskAudit& operator=(const TaskAudit&) = delete;
+
+    void markCreated(int task_id);
+    void markCompleted(int task_id);  ///< A second call marks a duplicate
+    void markShed(int task_id);
+
+    /// @brief Task handed to or taken from the network (call on both ends)
+    void markTransit(int task_id);
+
+    /// @brief End of run: the task is still queued or parked somewhere
+    void markHeld(int task_id);
+
+    AuditReport report() const;
+
+    /// @brief Bytes of bitmap allocated so far
+    size_t getAllocatedBytes() const;
+
+private:
+    static constexpr int CHUNK_SHIFT = 16;  ///< 64K task IDs per chunk
+    static constexpr size_t CHUNK_WORDS = (size_t(1) << CHUNK_SHIFT) / 64;
+    static constexpr size_t MAX_CHUNKS = size_t(1) << (31 - CHUNK_SHIFT);
+
+    enum Bitmap { CREATED, COMPLETED, DUPLICATED, SHED, TRANSIT, HELD, BITMAP_COUNT };
+
+    struct Chunk {
+        std::atomic<uint64_t> words[BITMAP_COUNT][CHUNK_WORDS];
+    };
+
+    /// Chunk holding task_id, allocated on first use (null if task_id < 0)
+    Chunk* chunkFor(int task_id);
+
+    /// Word and bit of task_id in a bitmap (null if task_id < 0)
+    std::atomic<uint64_t>* wordFor(Bitmap bitmap, int task_id, uint64_t& bit);
+
+    /// Sets the task's bit in a bitmap; returns whether it was already set
+    bool setBit(Bitmap bitmap, int task_id);
+
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks_;  ///< Directory, MAX_CHUNKS slots
+    std::atomic<size_t> allocated_chunks_;
+};
+
+#endif // TASKAUDIT_H
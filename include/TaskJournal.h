@@ -0,0 +1,202 @@
+/**
+ * @file TaskJournal.h
+ * @brief Append-only memory-mapped journal of a node's queue (crash restart)
+ *
+ * DESIGN RATIONALE:
+ * - Every change to the queue is one fixed-size record: ENQUEUE carries
+ *   the task descriptor, DEQUEUE (started, migrated or discarded) and
+ *   TRANSFER (forwarded to a peer) carry its ID. Replaying the file from
+ *   the start rebuilds the backlog
+ * - Group commit: append() only serializes into an in-memory buffer and
+ *   returns, so the enqueue path pays well under a microsecond. A
+ *   background committer copies the whole buffer into the mapping and
+ *   msyncs it every commit interval (or sooner once a group fills), so
+ *   one sync covers many records
+ * - The price is a window of commit_interval_us: records appended since
+ *   the last group commit die with the process (abandon())
+ * - Compaction also runs on the committer: once the file is mostly dead
+ *   records, the live descriptors are rewritten to a fresh file that is
+ *   renamed over the old one. Appenders never wait for it
+ * - Each record carries a checksum, so a torn tail left by a crash mid
+ *   commit ends replay instead of corrupting it
+ *
+ * - Compaction copies the live set under the appenders' mutex but encodes
+ *   and writes it outside, so an append never waits for a whole rewrite
+ * - Append latency tails (p999, max) are scheduling, not the journal: with
+ *   more appenders plus the committer than cores, a thread preempted
+ *   between its clock reads, or while holding the mutex, waits a full
+ *   scheduler slice (milliseconds)
+ *
+ * FILE FORMAT:
+ *   8-byte magic "LBJRNL02", 8 reserved bytes, then 64-byte records:
+ *   checksum (4) | type (1) | pad (3) | task ID (4) | work ms (4) |
+ *   peer (4) | reserved (4) | content key (8) | demand cpu/mem/io (3 x 4,
+ *   float) | reserved (4) | created (8) | deadline (8). Times are
+ *   microseconds since the Unix epoch (wall clock, so they survive a
+ *   process restart); deadline 0 = none. Little-endian host layout; the
+ *   zero-filled space past the last record reads as type 0 (end)
+ *
+ * ACADEMIC CONTEXT:
+ * - Write-ahead logging and group commit: Gray & Reuter, "Transaction
+ *   Processing: Concepts and Techniques" (1993); DeWitt et al.,
+ *   "Implementation techniques for main memory database systems" (SIGMOD 1984)
+ * - Log compaction as in log-structured storage: Rosenblum & Ousterhout,
+ *   "The design and implementation of a log-structured file system" (SOSP 1991)
+ *
+ * PLATFORM: POSIX (open/ftruncate/mmap/msync). Errors are logged and leave
+ * the journal closed (isOpen() == false); appends are then ignored.
+ */
+
+#ifndef TASKJOURNAL_H
+#define TASKJOURNAL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Resources.h"
+
+/**
+ * @enum JournalRecordType
+ * @brief What a journal record says happened to a task
+ */
+enum class JournalRecordType : uint8_t {
+    ENQUEUE = 1,   ///< Task queued here (descriptor attached)
+    DEQUEUE = 2,   ///< Left the queue: started, discarded, or about to migrate
+    TRANSFER = 3   ///< Forwarded to peer (lets cancels follow it after a restart)
+};
+
+/**
+ * @struct JournalRecord
+ * @brief One decoded journal record
+ */
+struct JournalRecord {
+    JournalRecordType type = JournalRecordType::ENQUEUE;
+    int task_id = 0;
+    int work_ms = 0;            ///< Remaining work (ENQUEUE)
+    int peer = -1;              ///< Destination (TRANSFER)
+    uint64_t content_key = 0;   ///< Identical-request key (ENQUEUE)
+    ResourceVector demand{};    ///< Resources held while running (ENQUEUE)
+    int64_t created_us = 0;     ///< First admission, us since the Unix epoch (ENQUEUE)
+    int64_t deadline_us = 0;    ///< Same clock; 0 = none (ENQUEUE)
+};
+
+/**
+ * @class TaskJournal
+ * @brief One node's durable queue log with asynchronous group commit
+ *
+ * THREAD SAFETY: append() may be called from any thread; it takes a short
+ * internal mutex. The committer is the only thread touching the file.
+ */
+class TaskJournal {
+public:
+    static constexpr size_t RECORD_BYTES = 64;
+    static constexpr size_t HEADER_BYTES = 16;
+
+    /**
+     * @brief Opens (or creates) the journal and replays what it holds
+     * @param path Journal file
+     * @param commit_interval_us Group commit period
+     * @param compact_bytes Compact once the file holds this many bytes and
+     *        at least half of them are dead (0 = never compact)
+     */
+    TaskJournal(const std::string& path, int commit_interval_us, size_t compact_bytes);
+
+    /// @brief Commits what is buffered, stops the committer, unmaps
+    ~TaskJournal();
+
+    TaskJournal(const TaskJournal&) = delete;
+    TaskJournal& operator=(const TaskJournal&) = delete;
+
+    /// @brief false if the file could not be opened or mapped
+    bool isOpen() const;
+
+    /**
+     * @brief Buffers one record; durable after the next group commit
+     *
+     * Also updates the in-memory live set, so compaction and liveTasks()
+     * reflect it at once.
+     */
+    void append(const JournalRecord& record);
+
+    /**
+     * @brief Simulated process crash: drops uncommitted records and stops
+     *        the committer without a final commit. Committed records stay
+     *        in the file (page cache); the object is closed afterwards
+     */
+    void abandon();
+
+    /// @brief Commits everything buffered now and waits for it
+    void sync();
+
+    /// @brief ENQUEUE records of tasks still queued, oldest ID first
+    std::vector<JournalRecord> liveTasks() const;
+
+    /// @brief Task ID -> peer, for TRANSFER records since the last compaction
+    std::map<int, int> transfers() const;
+
+    int getReplayedRecords() const;   ///< Valid records found when opened
+    double getReplaySeconds() const;  ///< Time spent opening and replaying
+    long long getCommits() const;     ///< Group commits (msync calls)
+    long long getCommittedRecords() const;
+    int getCompactions() const;
+    size_t getFileBytes() const;      ///< Header + committed records
+
+private:
+    /// Maps the file, validates the header and replays the records
+    bool openAndReplay();
+
+    /// Grows the file (and the mapping) to hold at least bytes
+    bool ensureCapacity(size_t bytes);
+
+    /// Committer thread body
+    void commitLoop();
+
+    /// Copies a group into the mapping and msyncs the touched pages
+    void commitGroup(const std::vector<uint8_t>& group);
+
+    /// Rewrites the live set to a new file and swaps it in (committer thread)
+    void compact();
+
+    /// Applies a record to live_ / transfers_ (caller holds buffer_mutex_ or is replaying)
+    void applyLocked(const JournalRecord& record);
+
+    static void encode(const JournalRecord& record, uint8_t* out);
+    static bool decode(const uint8_t* in, JournalRecord& record);
+
+    std::string path_;
+    int commit_interval_us_;
+    size_t compact_bytes_;
+
+    // File state (committer thread only, after construction)
+    int fd_;
+    uint8_t* map_;
+    size_t mapped_bytes_;
+    std::atomic<size_t> used_bytes_;
+
+    // Pending group and live set
+    std::vector<uint8_t> buffer_;
+    std::map<int, JournalRecord> live_;   ///< Task ID -> ENQUEUE record
+    std::map<int, int> transfers_;        ///< Task ID -> peer
+    mutable std::mutex buffer_mutex_;     ///< Protects buffer_, live_, transfers_, stopping_
+    std::condition_variable commit_cv_;
+    std::condition_variable synced_cv_;
+    bool flush_requested_;                ///< sync() is waiting
+    bool stopping_;
+    bool abandoned_;
+    long long appended_;                  ///< Records appended (under buffer_mutex_)
+    std::atomic<long long> committed_;
+
+    int replayed_records_;
+    double replay_seconds_;
+    std::atomic<long long> commits_;
+    std::atomic<int> compactions_;
+    std::thread committer_;
+};
+
+#endif // TASKJOURNAL_H
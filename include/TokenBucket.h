@@ -0,0 +1,64 @@
+/**
+ * @file TokenBucket.h
+ * @brief Token-bucket rate limiter used to model a link or message budget
+ *
+ * DESIGN RATIONALE:
+ * - Tokens accrue at rate_per_sec up to burst; each message costs one token
+ * - tryConsume() is the policing form (drop when empty)
+ * - reserve() is the shaping form: it always takes a token, letting the
+ *   balance go negative, and returns how long the caller must wait before
+ *   sending. Later reservations queue behind earlier ones, so a burst of
+ *   senders is paced out at exactly rate_per_sec
+ *
+ * ACADEMIC CONTEXT:
+ * - Token bucket / leaky bucket traffic shaping: Turner, "New directions in
+ *   communications" (IEEE Comm. Magazine 1986); RFC 2697 (srTCM)
+ * - Policing vs shaping as in DiffServ traffic conditioners (RFC 2475)
+ *
+ * THREAD SAFETY: None. Owners serialize access (NetworkManager holds a mutex).
+ */
+
+#ifndef TOKENBUCKET_H
+#define TOKENBUCKET_H
+
+#include <chrono>
+
+/**
+ * @class TokenBucket
+ * @brief Refill-on-demand token bucket (no background thread)
+ */
+class TokenBucket {
+public:
+    /**
+     * @brief Creates a full bucket
+     * @param rate_per_sec Token refill rate (> 0)
+     * @param burst Bucket depth; also the initial balance (>= 1)
+     */
+    TokenBucket(double rate_per_sec, double burst);
+
+    /**
+     * @brief Takes one token if available
+     * @return true if the token was taken, false if the bucket is empty
+     */
+    bool tryConsume();
+
+    /**
+     * @brief Takes one token unconditionally
+     * @return Time until the reservation is covered (zero if a token was available)
+     */
+    std::chrono::steady_clock::duration reserve();
+
+    /// @brief true if tryConsume() would succeed right now
+    bool available();
+
+private:
+    /// Adds tokens for the time elapsed since the last refill, capped at burst
+    void refill();
+
+    double rate_per_sec_;
+    double burst_;
+    double tokens_;  ///< May go negative after reserve()
+    std::chrono::steady_clock::time_point last_refill_;
+};
+
+#endif // TOKENBUCKET_H
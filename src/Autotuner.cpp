@@ -0,0 +1,180 @@
+#include "Autotuner.h"
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+// Objective order: feasible runs by p99, then over-budget runs by message rate
+static bool better(const TuningTrial& a, const TuningTrial& b) {
+    if (a.feasible != b.feasible) {
+        return a.feasible;
+    }
+    return a.feasible ? a.p99_latency_ms < b.p99_latency_ms
+                      : a.messages_per_node_per_sec < b.messages_per_node_per_sec;
+}
+
+static bool sameParams(const TuningParameters& a, const TuningParameters& b) {
+    return a.load_threshold == b.load_threshold && a.load_tick_ms == b.load_tick_ms &&
+           a.migration_batch_size == b.migration_batch_size;
+}
+
+// By p99, keep each run with fewer messages than all before it
+static std::vector<TuningTrial> paretoFront(std::vector<TuningTrial> trials) {
+    std::sort(trials.begin(), trials.end(), [](const TuningTrial& a, const TuningTrial& b) {
+        return a.p99_latency_ms != b.p99_latency_ms
+            ? a.p99_latency_ms < b.p99_latency_ms
+            : a.messages_per_node_per_sec < b.messages_per_node_per_sec;
+    });
+    std::vector<TuningTrial> front;
+    for (const auto& trial : trials) {
+        if (front.empty() ||
+            trial.messages_per_node_per_sec < front.back().messages_per_node_per_sec) {
+            front.push_back(trial);
+        }
+    }
+    return front;
+}
+
+// Log-uniform integer in [low, high]: small values matter as much as large ones
+static int sampleLogUniform(int low, int high, std::mt19937& gen) {
+    low = std::max(1, low);
+    high = std::max(low, high);
+    std::uniform_real_distribution<> dist(std::log(low), std::log(high + 1.0));
+    return std::min(high, static_cast<int>(std::exp(dist(gen))));
+}
+
+Autotuner::Autotuner(const SimulationConfig& base, const AutotuneConfig& config)
+    : base_(base), config_(config) {
+    base_.verbose = false;
+}
+
+std::vector<TuningParameters> Autotuner::sampleCandidates() {
+    std::mt19937 gen(config_.seed);
+    std::vector<TuningParameters> candidates;
+    candidates.push_back({base_.node.load_threshold, base_.node.load_tick_ms,
+                          base_.node.migration_batch_size});
+    while (static_cast<int>(candidates.size()) < config_.candidates) {
+        TuningParameters params;
+        params.load_threshold = sampleLogUniform(config_.min_params.load_threshold,
+                                                 config_.max_params.load_threshold, gen);
+        params.load_tick_ms = sampleLogUniform(config_.min_params.load_tick_ms,
+                                               config_.max_params.load_tick_ms, gen);
+        params.migration_batch_size = sampleLogUniform(config_.min_params.migration_batch_size,
+                                                       config_.max_params.migration_batch_size, gen);
+        candidates.push_back(params);
+    }
+    return candidates;
+}
+
+std::vector<TuningTrial> Autotuner::runRung(const std::vector<TuningParameters>& candidates,
+                                            int rung, int duration_seconds) {
+    std::vector<TuningTrial> trials(candidates.size());
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next++; i < candidates.size(); i = next++) {
+            SimulationConfig config = base_;
+            config.duration_seconds = duration_seconds;
+            config.node.load_threshold = candidates[i].load_threshold;
+            config.node.load_tick_ms = candidates[i].load_tick_ms;
+            config.node.migration_batch_size = candidates[i].migration_batch_size;
+            SimulationResult result = Simulation(config).run();
+
+            TuningTrial& trial = trials[i];
+            trial.params = candidates[i];
+            trial.rung = rung;
+            trial.duration_seconds = duration_seconds;
+            trial.p99_latency_ms = result.p99_latency_ms;
+            trial.mean_latency_ms = result.mean_latency_ms;
+            trial.messages_per_node_per_sec = result.messages_per_node_per_sec;
+            trial.goodput = result.goodput;
+            trial.feasible = config_.message_budget <= 0.0 ||
+                             result.messages_per_node_per_sec <= config_.message_budget;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    int parallelism = std::max(1, std::min<int>(config_.parallelism, candidates.size()));
+    for (int t = 0; t < parallelism; ++t) {
+        threads.emplace_back(work);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return trials;
+}
+
+TuningReport Autotuner::run() {
+    TuningReport report;
+    std::vector<TuningParameters> candidates = sampleCandidates();
+    int eta = std::max(2, config_.eta);
+    int duration = std::max(1, config_.min_duration_seconds);
+    std::vector<TuningTrial> first;  // Every candidate, same length
+    std::vector<TuningTrial> last;   // Survivors of the last rung
+
+    for (int rung = 0; rung < config_.max_rungs && !candidates.empty(); ++rung) {
+        std::vector<TuningTrial> trials = runRung(candidates, rung, duration);
+        std::stable_sort(trials.begin(), trials.end(), better);
+        report.trials.insert(report.trials.end(), trials.begin(), trials.end());
+        for (const auto& trial : trials) {
+            Logger::getInstance().log("Autotune rung " + std::to_string(rung) +
+                " threshold=" + std::to_string(trial.params.load_threshold) +
+                " tick=" + std::to_string(trial.params.load_tick_ms) +
+                " batch=" + std::to_string(trial.params.migration_batch_size) +
+                " p99=" + std::to_string(trial.p99_latency_ms) +
+                " msgs=" + std::to_string(trial.messages_per_node_per_sec));
+        }
+
+        if (rung == 0) {
+            first = trials;
+        }
+        last = trials;
+        report.best = trials.front();
+        size_t keep = (trials.size() + eta - 1) / eta;
+        if (rung + 1 == config_.max_rungs || trials.size() == 1) {
+            break;
+        }
+        candidates.clear();
+        for (size_t i = 0; i < keep; ++i) {
+            candidates.push_back(trials[i].params);
+        }
+        duration *= eta;
+    }
+
+    if (last.empty()) {
+        return report;
+    }
+
+    // Rerun the first rung's front and the base settings for the winner's
+    // length (see FINAL EVALUATION), so every reported run is comparable
+    TuningParameters defaults{base_.node.load_threshold, base_.node.load_tick_ms,
+                              base_.node.migration_batch_size};
+    std::vector<TuningParameters> rerun;
+    auto addRerun = [&](const TuningParameters& params) {
+        auto match = [&](const TuningParameters& p) { return sameParams(p, params); };
+        auto matchTrial = [&](const TuningTrial& t) { return sameParams(t.params, params); };
+        if (std::none_of(rerun.begin(), rerun.end(), match) &&
+            std::none_of(last.begin(), last.end(), matchTrial)) {
+            rerun.push_back(params);
+        }
+    };
+    for (const auto& trial : paretoFront(first)) {
+        addRerun(trial.params);
+    }
+    addRerun(defaults);
+    if (!rerun.empty()) {
+        std::vector<TuningTrial> trials = runRung(rerun, last.front().rung,
+                                                  last.front().duration_seconds);
+        report.trials.insert(report.trials.end(), trials.begin(), trials.end());
+        last.insert(last.end(), trials.begin(), trials.end());
+    }
+
+    report.pareto = paretoFront(last);
+    for (const auto& trial : last) {
+        if (sameParams(trial.params, defaults)) {
+            report.baseline = trial;
+        }
+    }
+    return report;
+}
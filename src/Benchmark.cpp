@@ -0,0 +1,1747 @@
+#include "Benchmark.h"
+#include "Simulation.h"
+#include "Logger.h"
+#include "TaskJournal.h"
+#include "TaskAudit.h"
+#include "QueueingModel.h"
+#include "Autotuner.h"
+#include "CapacityTest.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+// Shared benchmark settings: long enough to reach steady state,
+// short enough to compare several modes in a couple of minutes
+const int BENCH_DURATION_SECONDS = 10;
+const int BENCH_DRAIN_SECONDS = 2;
+const unsigned int BENCH_SEED = 42;
+
+/**
+ * Base configuration for all benchmarks: default cluster, fixed seed,
+ * quiet output.
+ */
+static SimulationConfig benchmarkBaseConfig() {
+    SimulationConfig config;
+    config.duration_seconds = BENCH_DURATION_SECONDS;
+    config.drain_seconds = BENCH_DRAIN_SECONDS;
+    config.seed = BENCH_SEED;
+    config.verbose = false;
+    return config;
+}
+
+/**
+ * Overload benchmark: offers 2x the cluster capacity and compares queue
+ * overflow policies and ingress admission control by goodput and latency.
+ */
+static int runOverloadBenchmark() {
+    const double LOAD_FACTOR = 2.0;
+    const int QUEUE_CAPACITY = 20;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+
+    struct Mode {
+        std::string name;
+        NodeConfig node;
+    };
+    std::vector<Mode> modes;
+
+    modes.push_back({"unbounded", base.node});
+
+    for (OverflowPolicy policy : {OverflowPolicy::REJECT, OverflowPolicy::REDIRECT,
+                                  OverflowPolicy::BLOCK}) {
+        NodeConfig node = base.node;
+        node.queue_capacity = QUEUE_CAPACITY;
+        node.overflow_policy = policy;
+        modes.push_back({overflowPolicyName(policy), node});
+    }
+
+    NodeConfig admission = base.node;
+    admission.queue_capacity = QUEUE_CAPACITY;
+    admission.overflow_policy = OverflowPolicy::REJECT;
+    admission.admission_max_avg_load = QUEUE_CAPACITY / 2.0;
+    modes.push_back({"admission", admission});
+
+    std::cout << "Overload benchmark: " << LOAD_FACTOR << "x capacity ("
+              << Simulation::estimateCapacity(base) * LOAD_FACTOR << " tasks/s offered, "
+              << "capacity " << Simulation::estimateCapacity(base) << " tasks/s), "
+              << base.duration_seconds << "s per mode, queue capacity "
+              << QUEUE_CAPACITY << std::endl;
+    std::cout << std::left << std::setw(11) << "mode"
+              << std::right << std::setw(10) << "generated"
+              << std::setw(10) << "rejected"
+              << std::setw(11) << "redirects"
+              << std::setw(10) << "goodput"
+              << std::setw(10) << "p50(ms)"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(11) << "remaining" << std::endl;
+
+    for (const auto& mode : modes) {
+        SimulationConfig config = base;
+        config.node = mode.node;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(11) << mode.name
+                  << std::right << std::setw(10) << r.tasks_generated
+                  << std::setw(10) << (r.admission_rejects + r.overflow_rejects)
+                  << std::setw(11) << r.redirects
+                  << std::setw(10) << std::fixed << std::setprecision(1) << r.goodput
+                  << std::setw(10) << r.p50_latency_ms
+                  << std::setw(10) << r.p99_latency_ms
+                  << std::setw(11) << r.tasks_remaining << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Flow-control benchmark: every arrival lands on nodes 0..N-2 while the last
+ * node idles. Without credits all hot nodes dump their offload batch on the
+ * idle node the moment it advertises load 0; with credits the idle node
+ * bounds the total it can be sent to its free capacity.
+ */
+static int runFlowControlBenchmark() {
+    const double LOAD_FACTOR = 0.95;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+    base.hot_nodes = base.num_nodes - 1;
+    base.hot_node_fraction = 1.0;
+    base.node.load_threshold = 5;
+    base.node.migration_batch_size = 8;
+
+    std::cout << "Flow-control benchmark: " << LOAD_FACTOR << "x capacity, "
+              << "arrivals on nodes 0-" << base.hot_nodes - 1 << " only, threshold "
+              << base.node.load_threshold << ", migration batch "
+              << base.node.migration_batch_size << std::endl;
+    std::cout << std::left << std::setw(11) << "credits"
+              << std::right << std::setw(11) << "transfers"
+              << std::setw(11) << "overshoot"
+              << std::setw(11) << "peak load"
+              << std::setw(10) << "p50(ms)"
+              << std::setw(10) << "p99(ms)" << std::endl;
+
+    for (bool credits : {false, true}) {
+        SimulationConfig config = base;
+        config.node.credit_flow_control = credits;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(11) << (credits ? "on" : "off")
+                  << std::right << std::setw(11) << r.transfers
+                  << std::setw(11) << r.transfer_overshoots
+                  << std::setw(11) << r.peak_node_load
+                  << std::setw(10) << std::fixed << std::setprecision(1) << r.p50_latency_ms
+                  << std::setw(10) << r.p99_latency_ms << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Piggyback benchmark: same hot-set workload as flow-control, so tasks
+ * migrate constantly. Compares how old the peer load entry behind each
+ * routing decision is when views are refreshed by LOAD_UPDATE only versus
+ * by every message header.
+ */
+static int runPiggybackBenchmark() {
+    const double LOAD_FACTOR = 0.95;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+    base.hot_nodes = base.num_nodes - 1;
+    base.hot_node_fraction = 1.0;
+    base.node.load_threshold = 5;
+    base.node.migration_batch_size = 8;
+
+    std::cout << "Piggyback benchmark: " << LOAD_FACTOR << "x capacity, "
+              << "arrivals on nodes 0-" << base.hot_nodes - 1 << " only, threshold "
+              << base.node.load_threshold << ", migration batch "
+              << base.node.migration_batch_size << std::endl;
+    std::cout << std::left << std::setw(11) << "piggyback"
+              << std::right << std::setw(14) << "view age(ms)"
+              << std::setw(14) << "view updates"
+              << std::setw(13) << "from header"
+              << std::setw(11) << "transfers"
+              << std::setw(10) << "p99(ms)" << std::endl;
+
+    for (bool piggyback : {false, true}) {
+        SimulationConfig config = base;
+        config.node.piggyback_load = piggyback;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(11) << (piggyback ? "on" : "off")
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+                  << r.mean_view_age_ms
+                  << std::setw(14) << r.view_updates
+                  << std::setw(13) << r.piggybacked_view_updates
+                  << std::setw(11) << r.transfers
+                  << std::setw(10) << r.p99_latency_ms << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Gossip benchmark: all-to-all LOAD_UPDATE broadcast versus push-pull delta
+ * digests on a larger cluster, comparing control-plane cost per node and the
+ * balancing quality it buys.
+ */
+static int runGossipBenchmark() {
+    const double LOAD_FACTOR = 0.8;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 16;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+    base.hot_nodes = base.num_nodes / 2;
+    base.hot_node_fraction = 1.0;
+    base.node.load_threshold = 5;
+
+    struct Mode {
+        std::string name;
+        GossipMode gossip;
+        int fanout;
+        double staleness_penalty;
+    };
+    // "aged" discounts idle-looking peers by one task per 100ms of entry age,
+    // so relayed (older) reports lose ties to fresher ones
+    std::vector<Mode> modes = {
+        {"broadcast", GossipMode::BROADCAST, 0, 0.0},
+        {"digest f=1", GossipMode::DIGEST, 1, 0.0},
+        {"digest f=2", GossipMode::DIGEST, 2, 0.0},
+        {"aged f=2", GossipMode::DIGEST, 2, 10.0},
+    };
+
+    std::cout << "Gossip benchmark: " << base.num_nodes << " nodes, " << LOAD_FACTOR
+              << "x capacity, arrivals on nodes 0-" << base.hot_nodes - 1 << " only" << std::endl;
+    std::cout << std::left << std::setw(12) << "mode"
+              << std::right << std::setw(12) << "msgs/node/s"
+              << std::setw(13) << "bytes/node/s"
+              << std::setw(13) << "view age(ms)"
+              << std::setw(11) << "transfers"
+              << std::setw(10) << "p99(ms)" << std::endl;
+
+    for (const auto& mode : modes) {
+        SimulationConfig config = base;
+        config.node.gossip_mode = mode.gossip;
+        config.node.gossip_fanout = mode.fanout;
+        config.node.staleness_penalty_per_sec = mode.staleness_penalty;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(12) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << r.messages_per_node_per_sec
+                  << std::setw(13) << r.bytes_per_node_per_sec
+                  << std::setw(13) << r.mean_view_age_ms
+                  << std::setw(11) << r.transfers
+                  << std::setw(10) << r.p99_latency_ms << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Rate-limit benchmark: a 32-node cluster whose all-to-all broadcast wants
+ * ~62 gossip messages/s per node, run under a 50 msg/s gossip budget per
+ * node. Compares policing (drop), shaping (queue) and a digest protocol
+ * that fits the budget by construction.
+ */
+static int runRateLimitBenchmark() {
+    const double LOAD_FACTOR = 0.8;
+    const double GOSSIP_BUDGET = 50.0;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 32;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+    base.hot_nodes = base.num_nodes / 2;
+    base.hot_node_fraction = 1.0;
+    base.node.load_threshold = 5;
+
+    struct Mode {
+        std::string name;
+        GossipMode gossip;
+        bool limited;
+        RateLimitAction action;
+    };
+    std::vector<Mode> modes = {
+        {"unlimited", GossipMode::BROADCAST, false, RateLimitAction::DROP},
+        {"drop", GossipMode::BROADCAST, true, RateLimitAction::DROP},
+        {"queue", GossipMode::BROADCAST, true, RateLimitAction::QUEUE},
+        {"digest f=2", GossipMode::DIGEST, true, RateLimitAction::DROP},
+    };
+
+    std::cout << "Rate-limit benchmark: " << base.num_nodes << " nodes, " << LOAD_FACTOR
+              << "x capacity, gossip budget " << GOSSIP_BUDGET << " msgs/s per node" << std::endl;
+    std::cout << std::left << std::setw(12) << "mode"
+              << std::right << std::setw(12) << "msgs/node/s"
+              << std::setw(10) << "dropped"
+              << std::setw(10) << "delayed"
+              << std::setw(13) << "view age(ms)"
+              << std::setw(11) << "transfers"
+              << std::setw(10) << "p99(ms)" << std::endl;
+
+    for (const auto& mode : modes) {
+        SimulationConfig config = base;
+        config.node.gossip_mode = mode.gossip;
+        config.node.gossip_fanout = 2;
+        if (mode.limited) {
+            RateLimit budget;
+            budget.rate_per_sec = GOSSIP_BUDGET;
+            budget.action = mode.action;
+            config.class_rate_limits[MessageClass::GOSSIP] = budget;
+        }
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(12) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << r.messages_per_node_per_sec
+                  << std::setw(10) << r.messages_dropped
+                  << std::setw(10) << r.messages_delayed
+                  << std::setw(13) << r.mean_view_age_ms
+                  << std::setw(11) << r.transfers
+                  << std::setw(10) << r.p99_latency_ms << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Geo benchmark: three datacenters of four nodes, 0.2ms inside a zone and
+ * 30-80ms between zones, with a hot node in zone 0. Compares a
+ * flat (instant) network, zone-blind least-load routing, and zone-aware
+ * routing that only crosses zones when the queueing gain beats the delay.
+ */
+static int runGeoBenchmark() {
+    const double LOAD_FACTOR = 0.7;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 12;
+    base.num_zones = 3;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+    base.hot_nodes = 1;  // Node 0, in zone 0
+    base.hot_node_fraction = 0.3;
+    base.node.load_threshold = 5;
+    base.node.migration_batch_size = 8;
+
+    std::vector<std::vector<double>> geo_latency = {
+        {0.2, 30.0, 80.0},
+        {30.0, 0.2, 50.0},
+        {80.0, 50.0, 0.2},
+    };
+
+    struct Mode {
+        std::string name;
+        bool geo;
+        bool zone_aware;
+    };
+    std::vector<Mode> modes = {
+        {"flat", false, false},
+        {"zone-blind", true, false},
+        {"zone-aware", true, true},
+    };
+
+    std::cout << "Geo benchmark: " << base.num_nodes << " nodes in " << base.num_zones
+              << " zones (0.2ms intra, 30-80ms inter), " << LOAD_FACTOR
+              << "x capacity, " << base.hot_node_fraction * 100 << "% of arrivals on node 0"
+              << std::endl;
+    std::cout << std::left << std::setw(12) << "mode"
+              << std::right << std::setw(11) << "transfers"
+              << std::setw(12) << "cross-zone"
+              << std::setw(10) << "p50(ms)"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(10) << "goodput" << std::endl;
+
+    for (const auto& mode : modes) {
+        SimulationConfig config = base;
+        if (mode.geo) {
+            config.zone_latency_ms = geo_latency;
+        }
+        config.node.zone_aware_routing = mode.zone_aware;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(12) << mode.name
+                  << std::right << std::setw(11) << r.transfers
+                  << std::setw(12) << r.cross_zone_transfers
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(10) << r.p50_latency_ms
+                  << std::setw(10) << r.p99_latency_ms
+                  << std::setw(10) << r.goodput << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Byzantine benchmark: the last node misbehaves (lies, flaps or black-holes
+ * tasks) while half the cluster is hot and offloading. Measures goodput and
+ * task loss with plain least-load routing versus trust-weighted routing, and
+ * the lowest trust any peer ends with in node 7 and in the honest nodes.
+ * Fails unless, with robust routing on, only the misbehaving node loses trust.
+ */
+static int runByzantineBenchmark() {
+    const double LOAD_FACTOR = 0.9;
+    const double TRUST_LOST = 0.9;  // Below this a node counts as distrusted
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+    base.hot_nodes = base.num_nodes / 2;
+    base.hot_node_fraction = 0.8;
+    base.node.load_threshold = 2;
+    base.node.migration_batch_size = 8;
+    int faulty_node = base.num_nodes - 1;
+
+    std::cout << "Byzantine benchmark: " << base.num_nodes << " nodes, node " << faulty_node
+              << " misbehaving, " << LOAD_FACTOR << "x capacity" << std::endl;
+    std::cout << std::left << std::setw(12) << "behavior"
+              << std::setw(8) << "robust"
+              << std::right << std::setw(10) << "goodput"
+              << std::setw(8) << "lost"
+              << std::setw(11) << "transfers"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(11) << "remaining"
+              << std::setw(9) << "trust7"
+              << std::setw(9) << "honest" << std::endl;
+
+    int failures = 0;
+    for (Misbehavior behavior : {Misbehavior::NONE, Misbehavior::LIAR,
+                                 Misbehavior::FLAPPER, Misbehavior::BLACK_HOLE}) {
+        for (bool robust : {false, true}) {
+            SimulationConfig config = base;
+            config.misbehaving_nodes[faulty_node] = behavior;
+            config.node.robust_routing = robust;
+            SimulationResult r = Simulation(config).run();
+
+            std::cout << std::left << std::setw(12) << misbehaviorName(behavior)
+                      << std::setw(8) << (robust ? "on" : "off")
+                      << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << r.goodput
+                      << std::setw(8) << r.tasks_lost
+                      << std::setw(11) << r.transfers
+                      << std::setw(10) << r.p99_latency_ms
+                      << std::setw(11) << r.tasks_remaining;
+
+            double faulty_trust = r.min_trust_per_node[faulty_node];
+            double honest_trust = 1.0;
+            for (int i = 0; i < faulty_node; ++i) {
+                honest_trust = std::min(honest_trust, r.min_trust_per_node[i]);
+            }
+            std::cout << std::setprecision(2)
+                      << std::setw(9) << faulty_trust
+                      << std::setw(9) << honest_trust << std::endl;
+
+            if (honest_trust < TRUST_LOST ||
+                (robust && behavior != Misbehavior::NONE && faulty_trust >= TRUST_LOST)) {
+                failures++;
+            }
+        }
+    }
+    if (failures > 0) {
+        std::cout << failures << " run(s) distrusted an honest node or trusted node "
+                  << faulty_node << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * DRF benchmark: half the nodes are memory-rich and half I/O-rich, and the
+ * workload mixes CPU-, memory- and I/O-heavy tasks arriving uniformly. A
+ * memory-heavy task on an I/O-rich node can only run alone, so balancing by
+ * queue length misplaces work that dominant-resource routing steers away.
+ */
+static int runDrfBenchmark() {
+    const double LOAD_FACTOR = 0.75;  // Of CPU capacity; memory/io bind first
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+    base.node.load_threshold = 3;
+    base.node.migration_batch_size = 4;
+    base.node_capacities = {
+        {0.0, 16.0, 100.0},  // Memory-rich: 16 GB, 100 MB/s
+        {0.0, 4.0, 400.0},   // I/O-rich: 4 GB, 400 MB/s
+    };
+    base.task_demand_mix = {
+        {1.0, 1.0, 10.0},    // CPU-bound
+        {1.0, 3.5, 10.0},    // Memory-heavy
+        {1.0, 1.0, 95.0},    // I/O-heavy
+    };
+
+    std::cout << "DRF benchmark: " << base.num_nodes << " nodes (memory-rich/I/O-rich), "
+              << "CPU/memory/I/O task mix, " << LOAD_FACTOR << "x CPU capacity" << std::endl;
+    std::cout << std::left << std::setw(10) << "balancing"
+              << std::right << std::setw(10) << "goodput"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(11) << "transfers"
+              << std::setw(8) << "cpu%"
+              << std::setw(8) << "mem%"
+              << std::setw(8) << "io%"
+              << std::setw(11) << "remaining" << std::endl;
+
+    for (bool drf : {false, true}) {
+        SimulationConfig config = base;
+        config.node.drf_balancing = drf;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(10) << (drf ? "drf" : "cpu-only")
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << r.goodput
+                  << std::setw(10) << r.p99_latency_ms
+                  << std::setw(11) << r.transfers
+                  << std::setw(8) << r.mean_utilization[RESOURCE_CPU] * 100
+                  << std::setw(8) << r.mean_utilization[RESOURCE_MEMORY] * 100
+                  << std::setw(8) << r.mean_utilization[RESOURCE_IO] * 100
+                  << std::setw(11) << r.tasks_remaining << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Time-slice benchmark: short tasks (10-50ms) mixed with 10% long 500ms
+ * tasks. Run-to-completion lets a long task pin a worker while short ones
+ * wait behind it; round-robin slicing and MLFQ let short tasks through.
+ * MLFQ's periodic boost bounds how long demoted long tasks can starve.
+ */
+static int runTimeSliceBenchmark() {
+    const double LOAD_FACTOR = 0.8;
+    const int QUANTUM_MS = 20;
+    const int BOOST_MS = 500;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.min_task_complexity = 10;
+    base.max_task_complexity = 50;
+    base.long_task_fraction = 0.1;
+    base.long_task_complexity = 500;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+
+    struct Mode {
+        std::string name;
+        int time_slice_ms;
+        bool mlfq;
+        int boost_ms;
+    };
+    std::vector<Mode> modes = {
+        {"complete", 0, false, 0},
+        {"rr q=20", QUANTUM_MS, false, 0},
+        {"mlfq q=20", QUANTUM_MS, true, 0},
+        {"mlfq+boost", QUANTUM_MS, true, BOOST_MS},
+    };
+
+    std::cout << "Time-slice benchmark: " << LOAD_FACTOR << "x capacity, tasks "
+              << base.min_task_complexity << "-" << base.max_task_complexity << "ms plus "
+              << base.long_task_fraction * 100 << "% " << base.long_task_complexity
+              << "ms tasks" << std::endl;
+    std::cout << std::left << std::setw(11) << "mode"
+              << std::right << std::setw(14) << "all p50(ms)"
+              << std::setw(14) << "short p99(ms)"
+              << std::setw(13) << "long p99(ms)"
+              << std::setw(10) << "goodput" << std::endl;
+
+    for (const auto& mode : modes) {
+        SimulationConfig config = base;
+        config.node.time_slice_ms = mode.time_slice_ms;
+        config.node.mlfq = mode.mlfq;
+        config.node.mlfq_boost_ms = mode.boost_ms;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(11) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << r.p50_latency_ms
+                  << std::setw(14) << r.short_p99_latency_ms
+                  << std::setw(13) << r.long_p99_latency_ms
+                  << std::setw(10) << r.goodput << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * DAG benchmark: every arrival is a split -> 6 maps -> reduce job, and a
+ * task run away from the node that produced an input pays a fixed fetch
+ * cost per input. Released tasks are always placed by the balancer; with
+ * locality on, each candidate's cost also includes fetching the inputs.
+ */
+static int runDagBenchmark() {
+    const double LOAD_FACTOR = 0.6;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.dag_fanout = 6;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+
+    std::cout << "DAG benchmark: split -> " << base.dag_fanout << " maps -> reduce jobs, "
+              << LOAD_FACTOR << "x capacity" << std::endl;
+    std::cout << std::left << std::setw(11) << "placement"
+              << std::right << std::setw(10) << "fetch(ms)"
+              << std::setw(7) << "jobs"
+              << std::setw(15) << "makespan(ms)"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(14) << "crit path(ms)"
+              << std::setw(11) << "fetched(s)"
+              << std::setw(11) << "transfers"
+              << std::setw(8) << "parked" << std::endl;
+
+    for (int fetch_ms : {30, 60}) {
+        for (bool locality : {false, true}) {
+            SimulationConfig config = base;
+            config.dag_input_transfer_ms = fetch_ms;
+            config.node.dag_locality = locality;
+            SimulationResult r = Simulation(config).run();
+
+            std::cout << std::left << std::setw(11) << (locality ? "locality" : "load-only")
+                      << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << fetch_ms
+                      << std::setw(7) << r.jobs_completed
+                      << std::setw(15) << r.mean_makespan_ms
+                      << std::setw(10) << r.p99_makespan_ms
+                      << std::setw(14) << r.mean_critical_path_ms
+                      << std::setw(11) << r.input_fetch_seconds
+                      << std::setw(11) << r.transfers
+                      << std::setw(8) << r.tasks_parked << std::endl;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Deadline benchmark: 1.5x overload with a 1s deadline on every task.
+ * Running everything spends workers on results nobody wants; dropping
+ * expired tasks at dequeue spends them on tasks that can still make it.
+ * The last mode also has clients cancel 20% of tasks after 200ms.
+ */
+static int runDeadlineBenchmark() {
+    const double LOAD_FACTOR = 1.5;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.task_deadline_ms = 1000;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+
+    struct Mode {
+        std::string name;
+        bool drop_expired;
+        double cancel_fraction;
+    };
+    std::vector<Mode> modes = {
+        {"run-all", false, 0.0},
+        {"drop-expired", true, 0.0},
+        {"+cancel 20%", true, 0.2},
+    };
+
+    std::cout << "Deadline benchmark: " << LOAD_FACTOR << "x capacity, "
+              << base.task_deadline_ms << "ms deadline" << std::endl;
+    std::cout << std::left << std::setw(14) << "mode"
+              << std::right << std::setw(10) << "goodput"
+              << std::setw(9) << "on-time"
+              << std::setw(7) << "late"
+              << std::setw(12) << "late work"
+              << std::setw(9) << "expired"
+              << std::setw(11) << "cancelled"
+              << std::setw(10) << "avoided" << std::endl;
+
+    for (const auto& mode : modes) {
+        SimulationConfig config = base;
+        config.node.drop_expired_tasks = mode.drop_expired;
+        config.cancel_fraction = mode.cancel_fraction;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(14) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << r.goodput
+                  << std::setw(9) << r.on_time_goodput
+                  << std::setw(7) << r.late_completions
+                  << std::setw(11) << r.late_work_seconds << "s"
+                  << std::setw(9) << r.tasks_expired
+                  << std::setw(11) << r.tasks_cancelled
+                  << std::setw(9) << r.work_avoided_seconds << "s" << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Dedup benchmark: 1.2x capacity where every task is one of 1000
+ * Zipf-popular requests. Coalescing merges identical tasks queued or
+ * running on the same node; a result cache answers repeats outright, and
+ * cache hints steer repeats to the node that holds the result.
+ */
+static int runDedupBenchmark() {
+    const double LOAD_FACTOR = 1.2;
+    const int CACHE_SIZE = 50;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.key_space = 1000;
+    base.key_zipf_s = 1.0;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+
+    struct Mode {
+        std::string name;
+        bool coalesce;
+        int cache_size;
+        bool hints;
+    };
+    std::vector<Mode> modes = {
+        {"off", false, 0, false},
+        {"coalesce", true, 0, false},
+        {"+cache 50", true, CACHE_SIZE, false},
+        {"+hints", true, CACHE_SIZE, true},
+    };
+
+    std::cout << "Dedup benchmark: " << LOAD_FACTOR << "x capacity, "
+              << base.key_space << " request keys, Zipf s=" << base.key_zipf_s << std::endl;
+    std::cout << std::left << std::setw(11) << "mode"
+              << std::right << std::setw(10) << "goodput"
+              << std::setw(10) << "p50(ms)"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(10) << "executed"
+              << std::setw(11) << "coalesced"
+              << std::setw(7) << "hits"
+              << std::setw(8) << "routed"
+              << std::setw(10) << "saved(s)" << std::endl;
+
+    for (const auto& mode : modes) {
+        SimulationConfig config = base;
+        config.node.coalesce_duplicates = mode.coalesce;
+        config.node.result_cache_size = mode.cache_size;
+        config.node.cache_hints = mode.hints;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(11) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << r.goodput
+                  << std::setw(10) << r.p50_latency_ms
+                  << std::setw(10) << r.p99_latency_ms
+                  << std::setw(10) << r.tasks_processed
+                  << std::setw(11) << r.tasks_coalesced
+                  << std::setw(7) << r.cache_hits
+                  << std::setw(8) << r.hint_routed
+                  << std::setw(10) << r.dedup_saved_seconds << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Bandit benchmark: half the cluster is hot and one node lies about its
+ * load, so the cheapest-looking peer is often the worst one. Compares
+ * greedy least-cost routing, the LinUCB contextual bandit trained on
+ * completion acks, and an oracle that reads every queue exactly. Regret is
+ * the chosen peer's true queue minus the shortest true queue, in tasks.
+ */
+static int runBanditBenchmark() {
+    const double LOAD_FACTOR = 0.8;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD_FACTOR);
+    base.hot_nodes = base.num_nodes / 2;
+    base.hot_node_fraction = 0.6;
+    base.node.load_threshold = 5;
+    base.node.migration_batch_size = 4;
+    int faulty_node = base.num_nodes - 1;
+    base.misbehaving_nodes[faulty_node] = Misbehavior::LIAR;
+    base.node.measure_regret = true;  // Greedy too
+
+    std::cout << "Bandit benchmark: " << base.num_nodes << " nodes, node " << faulty_node
+              << " lying, " << LOAD_FACTOR << "x capacity" << std::endl;
+    std::cout << std::left << std::setw(9) << "policy"
+              << std::right << std::setw(10) << "goodput"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(11) << "transfers"
+              << std::setw(11) << "decisions"
+              << std::setw(13) << "regret/dec"
+              << std::setw(12) << "cum regret" << std::endl;
+
+    for (RoutingPolicy policy : {RoutingPolicy::GREEDY, RoutingPolicy::BANDIT,
+                                 RoutingPolicy::ORACLE}) {
+        SimulationConfig config = base;
+        config.node.routing_policy = policy;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(9) << routingPolicyName(policy)
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << r.goodput
+                  << std::setw(10) << r.p99_latency_ms
+                  << std::setw(11) << r.transfers
+                  << std::setw(11) << r.routing_decisions
+                  << std::setprecision(2) << std::setw(13) << r.mean_regret
+                  << std::setw(12) << r.cumulative_regret << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Dimension-exchange benchmark: 400 one-second tasks land on node 0 of an
+ * idle 8-node cluster with no further arrivals. Reports how long each
+ * balancing scheme takes to bring every queue within 4 tasks of every
+ * other (in ms and in load-monitor rounds), and the transfer-plane
+ * messages (TASK_TRANSFER / TASK_BATCH / EXCHANGE_OFFER) and task moves
+ * spent getting there. Diffusion runs on both the full mesh and the
+ * hypercube overlay that dimension exchange implicitly uses.
+ */
+static int runDimensionExchangeBenchmark() {
+    const double ROUND_MS = 500.0;  // PeerNode load monitor period
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.duration_seconds = 15;
+    base.drain_seconds = 0;
+    base.task_generation_interval_ms = 0.0;
+    base.initial_tasks = 400;
+    base.min_task_complexity = 1000;
+    base.max_task_complexity = 1000;
+    base.node.migration_batch_size = 8;
+
+    struct Mode {
+        BalancingScheme scheme;
+        bool hypercube;
+    };
+    std::vector<Mode> modes = {
+        {BalancingScheme::GREEDY, false},
+        {BalancingScheme::DIFFUSION, false},
+        {BalancingScheme::DIFFUSION, true},
+        {BalancingScheme::DIMENSION_EXCHANGE, false},
+    };
+
+    std::cout << "Dimension-exchange benchmark: " << base.num_nodes << " nodes, "
+              << base.initial_tasks << " tasks on node 0, balanced = spread <= "
+              << base.balance_tolerance << std::endl;
+    std::cout << std::left << std::setw(14) << "scheme"
+              << std::setw(11) << "overlay"
+              << std::right << std::setw(14) << "converge(ms)"
+              << std::setw(8) << "rounds"
+              << std::setw(11) << "messages"
+              << std::setw(8) << "moved"
+              << std::setw(14) << "final spread" << std::endl;
+
+    for (const auto& mode : modes) {
+        SimulationConfig config = base;
+        config.node.balancing_scheme = mode.scheme;
+        config.hypercube_overlay = mode.hypercube;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(14) << balancingSchemeName(mode.scheme)
+                  << std::setw(11) << (mode.hypercube ? "hypercube" : "mesh") << std::right;
+        if (r.convergence_ms >= 0.0) {
+            std::cout << std::fixed << std::setprecision(0)
+                      << std::setw(14) << r.convergence_ms
+                      << std::setw(8) << std::ceil(r.convergence_ms / ROUND_MS)
+                      << std::setw(11) << r.convergence_messages
+                      << std::setw(8) << r.convergence_transfers;
+        } else {
+            std::cout << std::setw(14) << "never" << std::setw(8) << "-"
+                      << std::setw(11) << "-" << std::setw(8) << "-";
+        }
+        std::cout << std::setw(14) << r.final_spread << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * SOS benchmark: a flash crowd of 10,000 one-second tasks hits node 0 of
+ * an idle 16-node cluster. Reports the time until every queue is within
+ * 50 tasks of every other (time-to-absorb) for the tick-driven schemes
+ * and for SOS rumors with steal requests at two rumor TTLs.
+ */
+static int runSosBenchmark() {
+    const int WATERMARK = 50;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 16;
+    base.duration_seconds = 15;
+    base.drain_seconds = 0;
+    base.task_generation_interval_ms = 0.0;
+    base.initial_tasks = 10000;
+    base.balance_tolerance = 50;
+    base.min_task_complexity = 1000;
+    base.max_task_complexity = 1000;
+    base.node.migration_batch_size = 8;
+
+    struct Mode {
+        std::string name;
+        BalancingScheme scheme;
+        int sos_ttl;  // 0 = SOS off
+    };
+    std::vector<Mode> modes = {
+        {"greedy", BalancingScheme::GREEDY, 0},
+        {"dim-exchange", BalancingScheme::DIMENSION_EXCHANGE, 0},
+        {"sos ttl=1", BalancingScheme::GREEDY, 1},
+        {"sos ttl=3", BalancingScheme::GREEDY, 3},
+    };
+
+    std::cout << "SOS benchmark: " << base.num_nodes << " nodes, " << base.initial_tasks
+              << " tasks on node 0, absorbed = spread <= " << base.balance_tolerance
+              << ", watermark " << WATERMARK << ", fanout 2" << std::endl;
+    std::cout << std::left << std::setw(14) << "mode"
+              << std::right << std::setw(12) << "absorb(ms)"
+              << std::setw(7) << "SOS"
+              << std::setw(9) << "rumors"
+              << std::setw(8) << "steals"
+              << std::setw(8) << "moved"
+              << std::setw(14) << "final spread" << std::endl;
+
+    for (const auto& mode : modes) {
+        SimulationConfig config = base;
+        config.node.balancing_scheme = mode.scheme;
+        config.node.sos_watermark = mode.sos_ttl > 0 ? WATERMARK : 0;
+        config.node.sos_ttl = mode.sos_ttl;
+        config.node.sos_fanout = 2;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(14) << mode.name << std::right;
+        if (r.convergence_ms >= 0.0) {
+            std::cout << std::fixed << std::setprecision(0) << std::setw(12) << r.convergence_ms;
+        } else {
+            std::cout << std::setw(12) << "never";
+        }
+        std::cout << std::setw(7) << r.sos_raised
+                  << std::setw(9) << r.rumor_messages
+                  << std::setw(8) << r.steal_requests
+                  << std::setw(8) << r.transfers
+                  << std::setw(14) << r.final_spread << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Consolidation benchmark: a night-time cluster at 10% load for 12 s, then
+ * a step to 60%. Always-on nodes are compared with consolidation, which
+ * packs work onto few nodes and parks the rest. CPU-seconds count the
+ * cores kept powered (awake node-seconds x workers); the wake-up penalty
+ * shows in the latency tail, with each wake costing 300 ms.
+ */
+static int runConsolidationBenchmark() {
+    const double NIGHT_LOAD = 0.1;
+    const double SURGE_FACTOR = 6.0;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.duration_seconds = 20;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, NIGHT_LOAD);
+    base.surge_at_seconds = 12;
+    base.surge_factor = SURGE_FACTOR;
+
+    std::cout << "Consolidation benchmark: " << base.num_nodes << " nodes, "
+              << NIGHT_LOAD << "x capacity, " << NIGHT_LOAD * SURGE_FACTOR
+              << "x from t=" << base.surge_at_seconds << "s" << std::endl;
+    std::cout << std::left << std::setw(15) << "mode"
+              << std::right << std::setw(9) << "awake(s)"
+              << std::setw(8) << "CPU-s"
+              << std::setw(11) << "msgs/n/s"
+              << std::setw(7) << "parks"
+              << std::setw(7) << "wakes"
+              << std::setw(10) << "p50(ms)"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(10) << "goodput" << std::endl;
+
+    for (bool consolidate : {false, true}) {
+        SimulationConfig config = base;
+        config.node.consolidation = consolidate;
+        config.node.sos_watermark = consolidate ? config.node.load_threshold : 0;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(15) << (consolidate ? "consolidation" : "always-on")
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << r.awake_node_seconds
+                  << std::setw(8) << r.cpu_seconds
+                  << std::setw(11) << r.messages_per_node_per_sec
+                  << std::setw(7) << r.parks
+                  << std::setw(7) << r.wakeups
+                  << std::setw(10) << r.p50_latency_ms
+                  << std::setw(10) << r.p99_latency_ms
+                  << std::setw(10) << r.goodput << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Replication benchmark: node 0 carries a third of the arrivals of an
+ * 8-node cluster at 90% load and crashes 6 s in. Without replication its
+ * queue is simply lost; with buddy replication the next node requeues its
+ * mirrored backlog once the crash is detected. "unsaved" is lost minus
+ * recovered; replica B/s is the piggybacked delta volume per node. The
+ * audit shows the at-least-once cost: "dup" tasks ran twice (finished
+ * after the last mirrored delta, or run by a node that came back). In the
+ * restart mode node 0 returns from its journal 3 s later, and "withdrawn"
+ * counts the restored tasks it dropped because they had been recovered.
+ */
+static int runReplicationBenchmark() {
+    const double LOAD = 0.9;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.duration_seconds = 15;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD);
+    base.hot_node_fraction = 0.3;  // Node 0 carries a backlog worth saving
+    base.crash_node = 0;
+    base.crash_at_seconds = 6;
+
+    std::cout << "Replication benchmark: " << base.num_nodes << " nodes, " << LOAD
+              << "x capacity, node " << base.crash_node << " crashes at t="
+              << base.crash_at_seconds << "s" << std::endl;
+    std::error_code ignored;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "load_balancer_replication_bench";
+
+    std::cout << std::left << std::setw(20) << "mode"
+              << std::right << std::setw(7) << "lost"
+              << std::setw(11) << "recovered"
+              << std::setw(11) << "unsaved"
+              << std::setw(5) << "dup"
+              << std::setw(11) << "withdrawn"
+              << std::setw(14) << "recovery(ms)"
+              << std::setw(12) << "replica B/s"
+              << std::setw(10) << "B/n/s"
+              << std::setw(10) << "goodput" << std::endl;
+
+    struct Mode {
+        const char* name;
+        bool replicate;
+        int failure_timeout_ms;
+        bool restart;
+    };
+    for (const Mode& mode : {Mode{"none", false, 3000, false},
+                             Mode{"buddy, 3s", true, 3000, false},
+                             Mode{"buddy, 1.5s", true, 1500, false},
+                             Mode{"buddy, 1.5s, restart", true, 1500, true}}) {
+        SimulationConfig config = base;
+        config.audit = true;
+        config.node.buddy_replication = mode.replicate;
+        config.node.failure_timeout_ms = mode.failure_timeout_ms;
+        if (mode.restart) {
+            std::filesystem::remove_all(dir, ignored);
+            config.restart_after_seconds = 3;
+            config.node.journal_dir = dir.string();
+        }
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(20) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(7) << r.tasks_lost
+                  << std::setw(11) << r.tasks_recovered
+                  << std::setw(11) << std::max(0, r.tasks_lost - r.tasks_recovered)
+                  << std::setw(5) << r.audit.duplicated
+                  << std::setw(11) << r.tasks_withdrawn
+                  << std::setw(14) << r.recovery_ms
+                  << std::setw(12) << r.replica_bytes_per_node_per_sec
+                  << std::setw(10) << r.bytes_per_node_per_sec
+                  << std::setw(10) << r.goodput << std::endl;
+    }
+    std::filesystem::remove_all(dir, ignored);
+    return 0;
+}
+
+/**
+ * Journal benchmark, in two parts. First raw TaskJournal throughput: 1 and
+ * 4 threads append enqueue/dequeue pairs with 1,000 tasks live per thread,
+ * reporting append latency (mean, p99, p999, max), records per group
+ * commit, the file size with and without compaction, and the time to
+ * replay that file. The p999 and max are preemption when appenders plus
+ * the committer outnumber the cores (see TaskJournal.h); the mean includes
+ * them, so it can sit above the p99. Then a 4-node
+ * simulation whose hot node crashes 5 s in and restarts 1 s later, with
+ * and without its journal.
+ */
+static int runJournalBenchmark() {
+    const int ENQUEUES_PER_THREAD = 100000;
+    const int LIVE_PER_THREAD = 1000;
+    const int COMMIT_US = 2000;
+
+    std::error_code ignored;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "load_balancer_journal_bench";
+    std::filesystem::create_directories(dir, ignored);
+    std::string path = (dir / "bench.journal").string();
+
+    std::cout << "Journal throughput: " << ENQUEUES_PER_THREAD << " enqueues per thread, "
+              << LIVE_PER_THREAD << " live, group commit every " << COMMIT_US << "us, "
+              << std::thread::hardware_concurrency() << " core(s)" << std::endl;
+    std::cout << std::left << std::setw(20) << "mode"
+              << std::right << std::setw(11) << "krec/s"
+              << std::setw(10) << "mean(us)"
+              << std::setw(9) << "p99(us)"
+              << std::setw(10) << "p999(us)"
+              << std::setw(10) << "max(us)"
+              << std::setw(10) << "rec/sync"
+              << std::setw(9) << "compact"
+              << std::setw(10) << "file(KB)"
+              << std::setw(12) << "replay(ms)"
+              << std::setw(7) << "live" << std::endl;
+
+    struct Mode {
+        const char* name;
+        int threads;
+        size_t compact_bytes;
+    };
+    for (const Mode& mode : {Mode{"1 thread", 1, 1 << 20},
+                             Mode{"4 threads", 4, 1 << 20},
+                             Mode{"4 threads, no GC", 4, 0}}) {
+        std::filesystem::remove(path, ignored);
+        std::vector<std::vector<double>> samples(mode.threads);
+        double seconds;
+        long long commits;
+        long long records;
+        int compactions;
+        size_t file_bytes;
+        {
+            TaskJournal journal(path, COMMIT_US, mode.compact_bytes);
+            auto timedAppend = [&journal](const JournalRecord& record, std::vector<double>& out) {
+                auto before = std::chrono::steady_clock::now();
+                journal.append(record);
+                out.push_back(std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - before).count());
+            };
+
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> appenders;
+            for (int t = 0; t < mode.threads; ++t) {
+                appenders.emplace_back([&, t] {
+                    std::vector<double>& out = samples[t];
+                    out.reserve(2 * ENQUEUES_PER_THREAD);
+                    int first_id = t * ENQUEUES_PER_THREAD;  // Disjoint IDs per thread
+                    for (int i = 0; i < ENQUEUES_PER_THREAD; ++i) {
+                        JournalRecord enqueue;
+                        enqueue.task_id = first_id + i;
+                        enqueue.work_ms = 100;
+                        enqueue.demand = {1.0, 0.0, 0.0};
+                        timedAppend(enqueue, out);
+                        if (i >= LIVE_PER_THREAD) {
+                            JournalRecord dequeue;
+                            dequeue.type = JournalRecordType::DEQUEUE;
+                            dequeue.task_id = first_id + i - LIVE_PER_THREAD;
+                            timedAppend(dequeue, out);
+                        }
+                    }
+                });
+            }
+            for (auto& appender : appenders) {
+                appender.join();
+            }
+            journal.sync();
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            commits = journal.getCommits();
+            records = journal.getCommittedRecords();
+            compactions = journal.getCompactions();
+            file_bytes = journal.getFileBytes();
+        }
+
+        std::vector<double> latencies;
+        for (const auto& out : samples) {
+            latencies.insert(latencies.end(), out.begin(), out.end());
+        }
+        std::sort(latencies.begin(), latencies.end());
+        double mean = 0.0;
+        for (double latency : latencies) {
+            mean += latency / latencies.size();
+        }
+        double p99 = latencies[static_cast<size_t>(std::ceil(0.99 * latencies.size())) - 1];
+        double p999 = latencies[static_cast<size_t>(std::ceil(0.999 * latencies.size())) - 1];
+
+        TaskJournal reopened(path, COMMIT_US, 0);
+        std::cout << std::left << std::setw(20) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(11) << latencies.size() / seconds / 1000.0
+                  << std::setprecision(2)
+                  << std::setw(10) << mean
+                  << std::setw(9) << p99
+                  << std::setprecision(1)
+                  << std::setw(10) << p999
+                  << std::setw(10) << latencies.back()
+                  << std::setprecision(0)
+                  << std::setw(10) << (commits > 0 ? static_cast<double>(records) / commits : 0.0)
+                  << std::setw(9) << compactions
+                  << std::setw(10) << file_bytes / 1024.0
+                  << std::setprecision(2)
+                  << std::setw(12) << reopened.getReplaySeconds() * 1000.0
+                  << std::setw(7) << reopened.liveTasks().size() << std::endl;
+    }
+    std::filesystem::remove(path, ignored);
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 4;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, 0.9);
+    base.hot_node_fraction = 0.5;
+    base.crash_node = 0;
+    base.crash_at_seconds = 5;
+    base.restart_after_seconds = 1;
+
+    std::cout << std::endl << "Crash/restart: " << base.num_nodes << " nodes, 0.9x capacity, node "
+              << base.crash_node << " down from t=" << base.crash_at_seconds << "s for "
+              << base.restart_after_seconds << "s" << std::endl;
+    std::cout << std::left << std::setw(20) << "mode"
+              << std::right << std::setw(7) << "lost"
+              << std::setw(10) << "restored"
+              << std::setw(13) << "restore(ms)"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(10) << "goodput" << std::endl;
+    for (bool journaled : {false, true}) {
+        SimulationConfig config = base;
+        config.node.journal_dir = journaled ? (dir / "sim").string() : "";
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(20) << (journaled ? "journal" : "no journal")
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(7) << r.tasks_lost
+                  << std::setw(10) << r.tasks_restored
+                  << std::setprecision(2)
+                  << std::setw(13) << r.restore_ms
+                  << std::setprecision(1)
+                  << std::setw(10) << r.p99_latency_ms
+                  << std::setw(10) << r.goodput << std::endl;
+    }
+    std::filesystem::remove_all(dir, ignored);
+    return 0;
+}
+
+/**
+ * Snapshot benchmark: an 8-node cluster at 90% load with a hot node that
+ * migrates in batches, so tasks are always in flight. Once a second a
+ * Chandy-Lamport snapshot counts the tasks in the system; "naive err" is
+ * how far the sum of per-node reads taken at the same moment is from it
+ * (channels missed, instants mixed). "bad" counts snapshots whose channel
+ * counts disagreed with the ledgers. Runs with snapshots off give the
+ * baseline for message volume and goodput.
+ */
+static int runSnapshotBenchmark() {
+    const double LOAD = 0.9;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.duration_seconds = 10;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, LOAD);
+    base.hot_node_fraction = 0.5;
+    base.node.load_threshold = 2;
+    base.node.migration_batch_size = 8;
+
+    std::cout << "Snapshot benchmark: " << base.num_nodes << " nodes, " << LOAD
+              << "x capacity, one snapshot per second" << std::endl;
+    std::cout << std::left << std::setw(18) << "mode"
+              << std::right << std::setw(7) << "taken"
+              << std::setw(5) << "bad"
+              << std::setw(9) << "time(ms)"
+              << std::setw(11) << "in flight"
+              << std::setw(11) << "naive err"
+              << std::setw(9) << "msg/n/s"
+              << std::setw(10) << "goodput" << std::endl;
+
+    struct Mode {
+        const char* name;
+        bool snapshots;
+        double link_latency_ms;
+    };
+    for (const Mode& mode : {Mode{"off", false, 0.0},
+                             Mode{"on", true, 0.0},
+                             Mode{"off, 100ms links", false, 100.0},
+                             Mode{"on, 100ms links", true, 100.0}}) {
+        SimulationConfig config = base;
+        config.snapshots = mode.snapshots;
+        if (mode.link_latency_ms > 0.0) {
+            config.num_zones = 1;
+            config.zone_latency_ms = {{mode.link_latency_ms}};
+        }
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(18) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(7) << r.snapshots_completed
+                  << std::setw(5) << r.snapshots_inconsistent
+                  << std::setw(9) << r.snapshot_ms
+                  << std::setw(11) << r.mean_in_channel
+                  << std::setw(11) << r.mean_naive_error
+                  << std::setw(9) << r.messages_per_node_per_sec
+                  << std::setw(10) << r.goodput << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Audit benchmark, in two parts. First the raw cost of TaskAudit: 1 and 4
+ * threads each take a million task IDs (interleaved, so threads share
+ * bitmap words) through create, two migration hops and completion, and
+ * the report must find every one completed exactly once. Then an 8-node
+ * cluster at 90% load runs with the audit off and on (goodput and p99
+ * show the overhead), and with node 0 crashing at t=5s, without and with
+ * buddy replication, where the audit has to find the lost tasks.
+ */
+static int runAuditBenchmark() {
+    const int TASKS_PER_THREAD = 1000000;
+
+    std::cout << "Audit cost: " << TASKS_PER_THREAD << " tasks per thread, "
+              << "create + 2 hops + completion each" << std::endl;
+    std::cout << std::left << std::setw(12) << "threads"
+              << std::right << std::setw(12) << "ns/task"
+              << std::setw(12) << "bitmap(KB)"
+              << std::setw(11) << "completed"
+              << std::setw(6) << "dup"
+              << std::setw(6) << "lost" << std::endl;
+    for (int threads : {1, 4}) {
+        TaskAudit audit;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> markers;
+        for (int t = 0; t < threads; ++t) {
+            markers.emplace_back([&audit, t, threads] {
+                for (int i = 0; i < TASKS_PER_THREAD; ++i) {
+                    int task_id = i * threads + t;
+                    audit.markCreated(task_id);
+                    audit.markTransit(task_id);  // Sent...
+                    audit.markTransit(task_id);  // ...and received
+                    audit.markCompleted(task_id);
+                }
+            });
+        }
+        for (auto& thread : markers) {
+            thread.join();
+        }
+        double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+        AuditReport report = audit.report();
+
+        std::cout << std::left << std::setw(12) << threads
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << ns / TASKS_PER_THREAD  // Wall time per task per thread
+                  << std::setw(12) << audit.getAllocatedBytes() / 1024
+                  << std::setw(11) << report.completed
+                  << std::setw(6) << report.duplicated
+                  << std::setw(6) << report.lost << std::endl;
+    }
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.duration_seconds = 10;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, 0.9);
+    base.hot_node_fraction = 0.5;
+    base.node.load_threshold = 2;
+    base.node.migration_batch_size = 8;
+
+    std::cout << std::endl << "Cluster: " << base.num_nodes << " nodes, 0.9x capacity" << std::endl;
+    std::cout << std::left << std::setw(16) << "mode"
+              << std::right << std::setw(9) << "created"
+              << std::setw(7) << "done"
+              << std::setw(5) << "dup"
+              << std::setw(6) << "shed"
+              << std::setw(8) << "flight"
+              << std::setw(6) << "lost"
+              << std::setw(9) << "p99(ms)"
+              << std::setw(10) << "goodput" << std::endl;
+
+    struct Mode {
+        const char* name;
+        bool audit;
+        bool crash;
+        bool replicate;
+    };
+    for (const Mode& mode : {Mode{"off", false, false, false},
+                             Mode{"on", true, false, false},
+                             Mode{"on, crash", true, true, false},
+                             Mode{"on, crash+buddy", true, true, true}}) {
+        SimulationConfig config = base;
+        config.audit = mode.audit;
+        if (mode.crash) {
+            config.crash_node = 0;
+            config.crash_at_seconds = 5;
+        }
+        config.node.buddy_replication = mode.replicate;
+        config.node.failure_timeout_ms = 1500;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(16) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << r.audit.created
+                  << std::setw(7) << r.audit.completed
+                  << std::setw(5) << r.audit.duplicated
+                  << std::setw(6) << r.audit.shed
+                  << std::setw(8) << r.audit.in_flight
+                  << std::setw(6) << r.audit.lost
+                  << std::setw(9) << r.p99_latency_ms
+                  << std::setw(10) << r.goodput << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Validation against queueing theory: Poisson arrivals, exponential
+ * 100 ms tasks and no node-to-node balancing, so each case has a known
+ * answer. Random dispatch makes every node M/M/c (Erlang C); JSQ(2) over
+ * single-worker nodes is checked against its mean-field limit; full JSQ
+ * must land between the pooled M/M/N queue (a lower bound) and JSQ(2).
+ * Compares mean and p99 latency and the time-average queue length, and
+ * exits non-zero if any check is out of tolerance, so a change that
+ * breaks timing fidelity fails the run.
+ */
+static int runValidateBenchmark() {
+    const double MEAN_SERVICE_MS = 100.0;
+    // Relative; a 30 s run still varies by about +-8% in the mean between
+    // seeds, and the p99 and queue length (noisier) by about twice that
+    const double MEAN_TOLERANCE = 0.12;
+    const double TAIL_TOLERANCE = 0.20;
+    const double QUEUE_TOLERANCE = 0.20;
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.duration_seconds = 30;
+    base.poisson_arrivals = true;
+    base.exponential_service = true;
+    base.min_task_complexity = 50;
+    base.max_task_complexity = 150;       // Mean (min + max) / 2 = 100 ms
+    base.node.load_threshold = 1000000;   // No offloading: the models have none
+    double service_rate = 1000.0 / MEAN_SERVICE_MS;
+
+    struct Case {
+        const char* name;
+        int nodes;
+        int workers;
+        double load;
+        int choices;  // SimulationConfig::dispatch_choices
+    };
+
+    std::cout << "Queueing-model validation: Poisson arrivals, Exp(" << MEAN_SERVICE_MS
+              << " ms) service, " << base.duration_seconds << "s per case" << std::endl;
+    std::cout << std::left << std::setw(22) << "case"
+              << std::setw(12) << "metric"
+              << std::right << std::setw(11) << "predicted"
+              << std::setw(10) << "measured"
+              << std::setw(8) << "error"
+              << std::setw(7) << "tol"
+              << std::setw(7) << "" << std::endl;
+
+    int failures = 0;
+    auto check = [&](const std::string& name, const char* metric, double predicted,
+                     double measured, double tolerance) {
+        // An overloaded case (rho >= 1) has nothing to compare against
+        if (!std::isfinite(predicted)) {
+            failures++;
+            std::cout << std::left << std::setw(22) << name
+                      << std::setw(12) << metric
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(11) << "unstable"
+                      << std::setw(10) << measured
+                      << std::setw(8) << ""
+                      << std::setw(7) << ""
+                      << std::setw(7) << "FAIL" << std::endl;
+            return;
+        }
+        double error = predicted > 0.0 ? (measured - predicted) / predicted : 0.0;
+        bool ok = std::abs(error) <= tolerance;
+        failures += ok ? 0 : 1;
+        std::cout << std::left << std::setw(22) << name
+                  << std::setw(12) << metric
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(11) << predicted
+                  << std::setw(10) << measured
+                  << std::setprecision(1)
+                  << std::setw(7) << error * 100.0 << "%"
+                  << std::setw(6) << tolerance * 100.0 << "%"
+                  << std::setw(7) << (ok ? "ok" : "FAIL") << std::endl;
+    };
+
+    for (const Case& c : {Case{"M/M/1, random", 32, 1, 0.6, 0},
+                          Case{"M/M/4, random", 16, 4, 0.75, 0},
+                          Case{"JSQ(2), mean-field", 32, 1, 0.8, 2},
+                          Case{"JSQ, bounds", 16, 1, 0.8, 16}}) {
+        SimulationConfig config = base;
+        config.num_nodes = c.nodes;
+        config.node.num_workers = c.workers;
+        config.dispatch_choices = c.choices;
+        config.task_generation_interval_ms = Simulation::intervalForLoad(config, c.load);
+        SimulationResult r = Simulation(config).run();
+
+        // Model evaluated at the realized Poisson count, not the nominal
+        // rate: at rho = 0.8 a 1% rate error moves the mean response by 5%
+        double node_arrival_rate = r.tasks_generated / static_cast<double>(config.duration_seconds) / c.nodes;
+        double utilization = node_arrival_rate / (c.workers * service_rate);
+        if (c.choices == 0) {
+            QueuePrediction p = predictMMc(node_arrival_rate, service_rate, c.workers);
+            check(c.name, "mean(ms)", p.mean_response_s * 1000.0, r.mean_latency_ms, MEAN_TOLERANCE);
+            check(c.name, "p99(ms)", p.p99_response_s * 1000.0, r.p99_latency_ms, TAIL_TOLERANCE);
+            check(c.name, "queued", p.mean_queued, r.mean_queued_per_node, QUEUE_TOLERANCE);
+        } else if (c.choices < c.nodes) {
+            QueuePrediction p = predictPowerOfD(utilization, service_rate, c.choices);
+            check(c.name, "mean(ms)", p.mean_response_s * 1000.0, r.mean_latency_ms, MEAN_TOLERANCE);
+            check(c.name, "p99(ms)", p.p99_response_s * 1000.0, r.p99_latency_ms, TAIL_TOLERANCE);
+            check(c.name, "queued", p.mean_queued, r.mean_queued_per_node, QUEUE_TOLERANCE);
+        } else {
+            // Full JSQ has no closed form at finite N: it cannot beat one
+            // pooled M/M/N queue, nor be worse than sampling two queues
+            QueuePrediction pooled = predictMMc(node_arrival_rate * c.nodes, service_rate, c.nodes);
+            QueuePrediction two = predictPowerOfD(utilization, service_rate, 2);
+            double low = pooled.mean_response_s * 1000.0 * (1.0 - MEAN_TOLERANCE);
+            double high = two.mean_response_s * 1000.0 * (1.0 + MEAN_TOLERANCE);
+            bool ok = pooled.stable && two.stable &&
+                      r.mean_latency_ms >= low && r.mean_latency_ms <= high;
+            failures += ok ? 0 : 1;
+            std::cout << std::left << std::setw(22) << c.name
+                      << std::setw(12) << "mean(ms)"
+                      << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(5) << low << "-" << std::setw(5) << high
+                      << std::setprecision(2)
+                      << std::setw(10) << r.mean_latency_ms
+                      << std::setw(8) << ""
+                      << std::setw(7) << ""
+                      << std::setw(7) << (ok ? "ok" : "FAIL") << std::endl;
+        }
+    }
+
+    std::cout << (failures == 0 ? "All checks passed" : std::to_string(failures) + " check(s) failed")
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * Autotuner: successive halving over load_threshold, gossip interval
+ * (load_tick_ms) and migration batch for a skewed workload, minimizing p99
+ * under a message budget. Prints each rung's leader, the Pareto front over
+ * (p99, messages) and the winner against the default settings.
+ */
+static int runAutotuneBenchmark() {
+    const double MESSAGE_BUDGET = 20.0;  // Messages per node per second
+
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, 0.8);
+    base.hot_nodes = 2;
+    base.hot_node_fraction = 0.5;
+
+    AutotuneConfig tune;
+    tune.message_budget = MESSAGE_BUDGET;
+    Autotuner tuner(base, tune);
+    TuningReport report = tuner.run();
+
+    auto printParams = [](const TuningTrial& t) {
+        std::cout << std::right << std::setw(10) << t.params.load_threshold
+                  << std::setw(9) << t.params.load_tick_ms
+                  << std::setw(7) << t.params.migration_batch_size;
+    };
+    auto printHeader = [](const char* first) {
+        std::cout << std::left << std::setw(10) << first
+                  << std::right << std::setw(10) << "threshold"
+                  << std::setw(9) << "tick(ms)"
+                  << std::setw(7) << "batch"
+                  << std::setw(9) << "run(s)"
+                  << std::setw(10) << "p99(ms)"
+                  << std::setw(11) << "msgs/n/s"
+                  << std::setw(10) << "goodput" << std::endl;
+    };
+    auto printResults = [](const TuningTrial& t) {
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(9) << t.duration_seconds
+                  << std::setw(10) << t.p99_latency_ms
+                  << std::setw(11) << t.messages_per_node_per_sec
+                  << std::setw(10) << t.goodput
+                  << (t.feasible ? "" : "  over budget") << std::endl;
+    };
+
+    std::cout << "Autotune: " << base.num_nodes << " nodes, 0.8x capacity, half the load on 2 nodes; "
+              << tune.candidates << " candidates, eta " << tune.eta
+              << ", budget " << MESSAGE_BUDGET << " msgs/node/s" << std::endl;
+    printHeader("rung lead");
+    int rung = -1;
+    for (const auto& trial : report.trials) {
+        if (trial.rung > rung) {  // Trials of a rung are sorted best first
+            rung = trial.rung;
+            std::cout << std::left << std::setw(10) << rung;
+            printParams(trial);
+            printResults(trial);
+        }
+    }
+
+    std::cout << std::endl << "Pareto front (p99 vs messages, all at the final run length)" << std::endl;
+    printHeader("");
+    for (const auto& trial : report.pareto) {
+        std::cout << std::left << std::setw(10) << "";
+        printParams(trial);
+        printResults(trial);
+    }
+
+    // Same run length as the winner, so the two rows compare
+    std::cout << std::endl;
+    printHeader("");
+    std::cout << std::left << std::setw(10) << "default";
+    printParams(report.baseline);
+    printResults(report.baseline);
+    std::cout << std::left << std::setw(10) << "tuned";
+    printParams(report.best);
+    printResults(report.best);
+    return 0;
+}
+
+/**
+ * Capacity test: open-loop ramp plus bisection to the saturation point of
+ * three policies under a skewed workload (half the arrivals on 2 of 8
+ * nodes). Prints each policy's latency-throughput curve, then the usable
+ * capacity (highest unsaturated load) of each.
+ */
+static int runCapacityBenchmark() {
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.hot_nodes = 2;
+    base.hot_node_fraction = 0.5;
+
+    CapacityTestConfig sweep;
+    sweep.start_load = 0.25;
+    sweep.load_step = 0.25;
+    sweep.resolution = 0.05;
+    sweep.step_seconds = 10;
+
+    struct Policy {
+        const char* name;
+        int threshold;
+        int batch;
+    };
+    std::vector<std::pair<const char*, CapacityReport>> reports;
+    for (const Policy& policy : {Policy{"no balancing", 1000000, 1},
+                                 Policy{"greedy", 10, 1},
+                                 Policy{"greedy, t=2 b=8", 2, 8}}) {
+        SimulationConfig config = base;
+        config.node.load_threshold = policy.threshold;
+        config.node.migration_batch_size = policy.batch;
+        CapacityReport report = CapacityTest(config, sweep).run();
+
+        std::cout << "Capacity sweep: " << policy.name << " (" << base.num_nodes
+                  << " nodes, half the load on " << base.hot_nodes << ")" << std::endl;
+        std::cout << std::right << std::setw(8) << "load"
+                  << std::setw(10) << "offered"
+                  << std::setw(12) << "throughput"
+                  << std::setw(10) << "p50(ms)"
+                  << std::setw(10) << "p99(ms)"
+                  << std::setw(11) << "growth/s" << std::endl;
+        for (const auto& point : report.curve) {
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::setw(8) << point.load_factor
+                      << std::setprecision(1)
+                      << std::setw(10) << point.offered_rate
+                      << std::setw(12) << point.throughput
+                      << std::setw(10) << point.p50_latency_ms
+                      << std::setw(10) << point.p99_latency_ms
+                      << std::setw(11) << point.backlog_growth_per_sec
+                      << (point.saturated ? "  saturated" : "") << std::endl;
+        }
+        std::cout << std::endl;
+        reports.emplace_back(policy.name, report);
+    }
+
+    std::cout << std::left << std::setw(18) << "policy"
+              << std::right << std::setw(10) << "capacity"
+              << std::setw(12) << "throughput"
+              << std::setw(10) << "p99(ms)" << std::endl;
+    for (const auto& [name, report] : reports) {
+        std::cout << std::left << std::setw(18) << name << std::right << std::fixed;
+        if (report.knee.load_factor > 0.0) {
+            std::cout << std::setprecision(2) << std::setw(9) << report.knee.load_factor
+                      << (report.found ? "x" : "+")
+                      << std::setprecision(1)
+                      << std::setw(12) << report.knee.throughput
+                      << std::setw(10) << report.knee.p99_latency_ms << std::endl;
+        } else {
+            std::cout << std::setw(10) << "-" << "  (saturated at the first step)" << std::endl;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Work conservation: ranks balancing policies by how much worker time is
+ * wasted idling while tasks wait on another node (sampled every 50 ms),
+ * under a skewed workload at 0.8x capacity. 100% means no worker was ever
+ * idle while there was queued work anywhere in the cluster.
+ */
+static int runConservationBenchmark() {
+    SimulationConfig base = benchmarkBaseConfig();
+    base.num_nodes = 8;
+    base.task_generation_interval_ms = Simulation::intervalForLoad(base, 0.8);
+    base.hot_nodes = 2;
+    base.hot_node_fraction = 0.5;
+
+    struct Mode {
+        const char* name;
+        BalancingScheme scheme;
+        int threshold;
+        int batch;
+        int sos_watermark;  // 0 = SOS off
+    };
+
+    std::cout << "Work conservation: " << base.num_nodes << " nodes, 0.8x capacity, half the load on "
+              << base.hot_nodes << " nodes" << std::endl;
+    std::cout << std::left << std::setw(18) << "policy"
+              << std::right << std::setw(13) << "conserving"
+              << std::setw(12) << "wasted(s)"
+              << std::setw(10) << "p99(ms)"
+              << std::setw(10) << "goodput"
+              << std::setw(10) << "moved" << std::endl;
+
+    for (const Mode& mode : {Mode{"no balancing", BalancingScheme::GREEDY, 1000000, 1, 0},
+                             Mode{"greedy", BalancingScheme::GREEDY, 10, 1, 0},
+                             Mode{"greedy, t=2 b=8", BalancingScheme::GREEDY, 2, 8, 0},
+                             Mode{"diffusion", BalancingScheme::DIFFUSION, 10, 1, 0},
+                             Mode{"greedy + sos", BalancingScheme::GREEDY, 2, 8, 4}}) {
+        SimulationConfig config = base;
+        config.node.balancing_scheme = mode.scheme;
+        config.node.load_threshold = mode.threshold;
+        config.node.migration_batch_size = mode.batch;
+        config.node.sos_watermark = mode.sos_watermark;
+        SimulationResult r = Simulation(config).run();
+
+        std::cout << std::left << std::setw(18) << mode.name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << r.work_conservation << "%"
+                  << std::setw(12) << r.idle_while_waiting_seconds
+                  << std::setw(10) << r.p99_latency_ms
+                  << std::setw(10) << r.goodput
+                  << std::setw(10) << r.transfers << std::endl;
+    }
+    return 0;
+}
+
+const std::vector<BenchmarkInfo>& getBenchmarks() {
+    static const std::vector<BenchmarkInfo> benchmarks = {
+        {"overload", "Goodput and p99 under 2x overload per queue overflow mode",
+         runOverloadBenchmark},
+        {"flow-control", "Receiver overshoot with and without TASK_TRANSFER credits",
+         runFlowControlBenchmark},
+        {"piggyback", "Peer load view staleness with and without header piggybacking",
+         runPiggybackBenchmark},
+        {"gossip", "Control-plane bytes/messages per node: broadcast vs delta digests",
+         runGossipBenchmark},
+        {"rate-limit", "Broadcast gossip under a 50 msg/s per-node budget: drop vs queue",
+         runRateLimitBenchmark},
+        {"geo", "Three-zone cluster: cross-zone migration and p99, zone-blind vs zone-aware",
+         runGeoBenchmark},
+        {"byzantine", "Goodput/task loss with a lying, flapping or black-hole node, trust on/off",
+         runByzantineBenchmark},
+        {"drf", "Multi-resource tasks on heterogeneous nodes: CPU-only vs DRF balancing",
+         runDrfBenchmark},
+        {"timeslice", "Short-task p99 with run-to-completion vs round-robin vs MLFQ",
+         runTimeSliceBenchmark},
+        {"dag", "Split/map/reduce job makespan: load-only vs input-locality placement",
+         runDagBenchmark},
+        {"deadline", "1.5x overload with 1s deadlines: run everything vs drop expired vs cancel",
+         runDeadlineBenchmark},
+        {"dedup", "Zipf-skewed identical requests: coalescing, result cache, cache hints",
+         runDedupBenchmark},
+        {"bandit", "Hot cluster with a lying node: greedy vs LinUCB bandit vs oracle routing",
+         runBanditBenchmark},
+        {"dim-exchange", "400-task burst on one node: greedy vs diffusion vs hypercube dimension exchange",
+         runDimensionExchangeBenchmark},
+        {"sos", "10k-task flash crowd on one node: time-to-absorb with and without SOS rumors",
+         runSosBenchmark},
+        {"consolidation", "10% night load then a 60% step: always-on vs parking idle nodes",
+         runConsolidationBenchmark},
+        {"replication", "Node crash at 0.9x load: tasks lost and recovery time with and without buddy replication",
+         runReplicationBenchmark},
+        {"journal", "mmap task journal: append latency and group commit, then crash/restart with and without it",
+         runJournalBenchmark},
+        {"snapshot", "Chandy-Lamport snapshots: exact in-system totals vs naive per-node sums, and their cost",
+         runSnapshotBenchmark},
+        {"audit", "Exactly-once audit bitmaps: marking cost, overhead at 0.9x load, lost tasks after a crash",
+         runAuditBenchmark},
+        {"validate", "Queueing-model validation: M/M/c, JSQ(2) mean-field and JSQ bounds; non-zero exit on mismatch",
+         runValidateBenchmark},
+        {"autotune", "Successive-halving search over threshold, gossip interval and batch: p99 under a message budget",
+         runAutotuneBenchmark},
+        {"capacity", "Open-loop load sweep to the saturation point: latency-throughput curve per policy",
+         runCapacityBenchmark},
+        {"conservation", "Work conservation: worker time idle while tasks wait elsewhere, per policy",
+         runConservationBenchmark},
+    };
+    return benchmarks;
+}
+
+int runBenchmark(const std::string& name) {
+    for (const auto& benchmark : getBenchmarks()) {
+        if (benchmark.name == name) {
+            Logger::getInstance().setEnabled(false);
+            return benchmark.run();
+        }
+    }
+    std::cerr << "Unknown benchmark: " << name << std::endl;
+    return 1;
+}
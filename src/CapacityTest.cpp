@@ -0,0 +1,70 @@
+#include "CapacityTest.h"
+#include "Logger.h"
+#include <algorithm>
+
+CapacityTest::CapacityTest(const SimulationConfig& base, const CapacityTestConfig& config)
+    : base_(base), config_(config) {
+    base_.verbose = false;
+}
+
+CapacityPoint CapacityTest::measure(double load_factor) {
+    SimulationConfig config = base_;
+    config.duration_seconds = config_.step_seconds;
+    config.task_generation_interval_ms = Simulation::intervalForLoad(config, load_factor);
+    SimulationResult result = Simulation(config).run();
+
+    CapacityPoint point;
+    point.load_factor = load_factor;
+    point.offered_rate = result.tasks_generated / static_cast<double>(config.duration_seconds);
+    point.throughput = result.goodput;
+    point.p50_latency_ms = result.p50_latency_ms;
+    point.p99_latency_ms = result.p99_latency_ms;
+    point.backlog_growth_per_sec = result.backlog_growth_per_sec;
+    point.saturated = point.backlog_growth_per_sec > config_.growth_tolerance * point.offered_rate;
+
+    Logger::getInstance().log("Capacity step load=" + std::to_string(load_factor) +
+        " offered=" + std::to_string(point.offered_rate) +
+        " throughput=" + std::to_string(point.throughput) +
+        " growth=" + std::to_string(point.backlog_growth_per_sec) +
+        (point.saturated ? " saturated" : ""));
+    return point;
+}
+
+CapacityReport CapacityTest::run() {
+    CapacityReport report;
+    double step = std::max(config_.load_step, config_.resolution);
+
+    // Ramp until the first saturated step
+    double stable = 0.0;
+    double saturated = 0.0;
+    for (double load = config_.start_load; load <= config_.max_load + 1e-9; load += step) {
+        CapacityPoint point = measure(load);
+        report.curve.push_back(point);
+        if (point.saturated) {
+            report.found = true;
+            saturated = load;
+            break;
+        }
+        stable = load;
+        report.knee = point;
+    }
+
+    // Bisect between the last stable and the first saturated step
+    while (report.found && saturated - stable > config_.resolution) {
+        double load = (stable + saturated) / 2.0;
+        CapacityPoint point = measure(load);
+        report.curve.push_back(point);
+        if (point.saturated) {
+            saturated = load;
+        } else {
+            stable = load;
+            report.knee = point;
+        }
+    }
+
+    std::sort(report.curve.begin(), report.curve.end(),
+              [](const CapacityPoint& a, const CapacityPoint& b) {
+                  return a.load_factor < b.load_factor;
+              });
+    return report;
+}
@@ -0,0 +1,99 @@
+#include "GossipDigest.h"
+#include <algorithm>
+
+std::vector<uint8_t> GossipDigest::encode(std::vector<DigestEntry> entries) {
+    std::sort(entries.begin(), entries.end(),
+              [](const DigestEntry& a, const DigestEntry& b) { return a.node_id < b.node_id; });
+
+    std::vector<uint8_t> out;
+    putVarint(out, entries.size());
+
+    int previous_id = 0;
+    for (const auto& entry : entries) {
+        putVarint(out, static_cast<uint64_t>(entry.node_id - previous_id));
+        putVarint(out, static_cast<uint64_t>(entry.version));
+        putVarint(out, static_cast<uint64_t>(entry.load));
+        putVarint(out, static_cast<uint64_t>(entry.age_ms));
+        previous_id = entry.node_id;
+    }
+    return out;
+}
+
+std::vector<DigestEntry> GossipDigest::decode(const std::vector<uint8_t>& bytes) {
+    std::vector<DigestEntry> entries;
+    size_t pos = 0;
+    uint64_t count;
+    if (!getVarint(bytes, pos, count)) {
+        return entries;
+    }
+
+    int node_id = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t id_delta, version, load, age_ms;
+        if (!getVarint(bytes, pos, id_delta) ||
+            !getVarint(bytes, pos, version) ||
+            !getVarint(bytes, pos, load) ||
+            !getVarint(bytes, pos, age_ms)) {
+            return {};  // Truncated payload
+        }
+        node_id += static_cast<int>(id_delta);
+        entries.push_back({node_id, static_cast<long>(version), static_cast<int>(load),
+                           static_cast<int>(age_ms)});
+    }
+    return entries;
+}
+
+std::vector<uint8_t> GossipDigest::encodeKeys(std::vector<uint64_t> keys) {
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint8_t> out;
+    putVarint(out, keys.size());
+
+    uint64_t previous_key = 0;
+    for (uint64_t key : keys) {
+        putVarint(out, key - previous_key);
+        previous_key = key;
+    }
+    return out;
+}
+
+std::vector<uint64_t> GossipDigest::decodeKeys(const std::vector<uint8_t>& bytes) {
+    std::vector<uint64_t> keys;
+    size_t pos = 0;
+    uint64_t count;
+    if (!getVarint(bytes, pos, count)) {
+        return keys;
+    }
+
+    uint64_t key = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t delta;
+        if (!getVarint(bytes, pos, delta)) {
+            return {};  // Truncated payload
+        }
+        key += delta;
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+// LEB128: 7 bits per byte, high bit set on all but the last byte
+void GossipDigest::putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool GossipDigest::getVarint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,51 @@
+#include "LinUCB.h"
+#include <algorithm>
+#include <cmath>
+
+LinUCB::LinUCB(double alpha, const BanditContext& prior)
+    : alpha_(alpha), a_inv_{}, b_(prior), theta_(prior) {
+    for (size_t i = 0; i < BANDIT_DIMS; ++i) {
+        a_inv_[i * BANDIT_DIMS + i] = 1.0;
+    }
+}
+
+double LinUCB::score(const BanditContext& x) const {
+    double mean = 0.0;
+    double width = 0.0;
+    for (size_t i = 0; i < BANDIT_DIMS; ++i) {
+        mean += theta_[i] * x[i];
+        for (size_t j = 0; j < BANDIT_DIMS; ++j) {
+            width += x[i] * a_inv_[i * BANDIT_DIMS + j] * x[j];
+        }
+    }
+    return mean + alpha_ * std::sqrt(std::max(0.0, width));
+}
+
+void LinUCB::update(const BanditContext& x, double reward) {
+    // Sherman-Morrison: (A + x x')^-1 = A^-1 - (A^-1 x)(x' A^-1) / (1 + x' A^-1 x)
+    BanditContext a_inv_x{};
+    for (size_t i = 0; i < BANDIT_DIMS; ++i) {
+        for (size_t j = 0; j < BANDIT_DIMS; ++j) {
+            a_inv_x[i] += a_inv_[i * BANDIT_DIMS + j] * x[j];
+        }
+    }
+    double denom = 1.0;
+    for (size_t i = 0; i < BANDIT_DIMS; ++i) {
+        denom += x[i] * a_inv_x[i];
+    }
+    for (size_t i = 0; i < BANDIT_DIMS; ++i) {
+        for (size_t j = 0; j < BANDIT_DIMS; ++j) {
+            a_inv_[i * BANDIT_DIMS + j] -= a_inv_x[i] * a_inv_x[j] / denom;  // A^-1 is symmetric
+        }
+    }
+
+    for (size_t i = 0; i < BANDIT_DIMS; ++i) {
+        b_[i] += reward * x[i];
+    }
+    for (size_t i = 0; i < BANDIT_DIMS; ++i) {
+        theta_[i] = 0.0;
+        for (size_t j = 0; j < BANDIT_DIMS; ++j) {
+            theta_[i] += a_inv_[i * BANDIT_DIMS + j] * b_[j];
+        }
+    }
+}
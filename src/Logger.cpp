@@ -5,7 +5,7 @@
 #include <chrono>
 #include <ctime>
 
-Logger::Logger() : use_file_(false) {
+Logger::Logger() : use_file_(false), enabled_(true) {
 }
 
 Logger::~Logger() {
@@ -30,7 +30,19 @@ void Logger::setLogFile(const std::string& filename) {
     use_file_ = log_file_.is_open();
 }
 
+void Logger::setEnabled(bool enabled) {
+    enabled_ = enabled;
+}
+
+bool Logger::isEnabled() const {
+    return enabled_.load();
+}
+
 void Logger::log(const std::string& message) {
+    if (!enabled_) {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     
     std::string timestamp = getCurrentTimestamp();
@@ -44,11 +56,17 @@ void Logger::log(const std::string& message) {
 }
 
 void Logger::logNodeEvent(int node_id, const std::string& event) {
+    if (!enabled_) {
+        return;
+    }
     std::string message = "Node[" + std::to_string(node_id) + "] " + event;
     log(message);
 }
 
 void Logger::logMetrics(int node_id, int current_load, int tasks_processed) {
+    if (!enabled_) {
+        return;
+    }
     std::string message = "Node[" + std::to_string(node_id) + "] " +
                          "Load=" + std::to_string(current_load) + " " +
                          "TasksProcessed=" + std::to_string(tasks_processed);
@@ -1,9 +1,17 @@
 #include "Message.h"
 #include <sstream>
+#include <algorithm>
+#include <cmath>
+
+// Resource summary quantization: one byte per resource, 2% per step
+const double SUMMARY_STEP = 0.02;
 
 Message::Message(MessageType type, int sender_id, int receiver_id)
     : type_(type), sender_id_(sender_id), receiver_id_(receiver_id),
-      load_value_(0), task_(nullptr) {
+      sender_load_(0), sender_load_version_(-1), sender_dormant_(false),
+      has_resource_summary_(false), resource_summary_{},
+      load_value_(0), credits_(0), task_(nullptr), task_id_(-1),
+      rumor_origin_(-1), rumor_id_(0), rumor_ttl_(0) {
 }
 
 MessageType Message::getType() const {
@@ -26,6 +34,59 @@ int Message::getLoadValue() const {
     return load_value_;
 }
 
+void Message::setCredits(int credits) {
+    credits_ = credits;
+}
+
+int Message::getCredits() const {
+    return credits_;
+}
+
+void Message::setSenderLoad(int load, long version) {
+    sender_load_ = load;
+    sender_load_version_ = version;
+}
+
+bool Message::hasSenderLoad() const {
+    return sender_load_version_ >= 0;
+}
+
+int Message::getSenderLoad() const {
+    return sender_load_;
+}
+
+long Message::getSenderLoadVersion() const {
+    return sender_load_version_;
+}
+
+void Message::setSenderDormant(bool dormant) {
+    sender_dormant_ = dormant;
+}
+
+bool Message::isSenderDormant() const {
+    return sender_dormant_;
+}
+
+void Message::setResourceSummary(const ResourceVector& pressure) {
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        double steps = std::round(pressure[r] / SUMMARY_STEP);
+        resource_summary_[r] = static_cast<uint8_t>(std::clamp(steps, 0.0, 255.0));
+    }
+    has_resource_summary_ = true;
+}
+
+bool Message::hasResourceSummary() const {
+    return has_resource_summary_;
+}
+
+ResourceVector Message::getResourceSummary() const {
+    ResourceVector pressure{};
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        pressure[r] = resource_summary_[r] * SUMMARY_STEP;
+    }
+    return pressure;
+}
+
 void Message::setTask(std::shared_ptr<Task> task) {
     task_ = task;
 }
@@ -34,6 +95,87 @@ std::shared_ptr<Task> Message::getTask() const {
     return task_;
 }
 
+void Message::setRumor(int origin, int rumor_id, int ttl) {
+    rumor_origin_ = origin;
+    rumor_id_ = rumor_id;
+    rumor_ttl_ = ttl;
+}
+
+int Message::getRumorOrigin() const {
+    return rumor_origin_;
+}
+
+int Message::getRumorId() const {
+    return rumor_id_;
+}
+
+int Message::getRumorTtl() const {
+    return rumor_ttl_;
+}
+
+void Message::setTaskId(int task_id) {
+    task_id_ = task_id;
+}
+
+void Message::setTasks(std::vector<std::shared_ptr<Task>> tasks) {
+    tasks_ = std::move(tasks);
+}
+
+const std::vector<std::shared_ptr<Task>>& Message::getTasks() const {
+    return tasks_;
+}
+
+int Message::getTaskId() const {
+    if (task_) {
+        return task_->getId();
+    }
+    return task_id_;
+}
+
+void Message::setPayload(std::vector<uint8_t> payload) {
+    payload_ = std::move(payload);
+}
+
+const std::vector<uint8_t>& Message::getPayload() const {
+    return payload_;
+}
+
+size_t Message::getWireSize() const {
+    const size_t HEADER_BYTES = 1 + 4 + 4 + 4 + 8 +
+                                (has_resource_summary_ ? RESOURCE_COUNT : 0);
+
+    switch (type_) {
+        case MessageType::LOAD_UPDATE:
+            if (tasks_.empty() && payload_.empty()) {
+                return HEADER_BYTES + 8;
+            }
+            return HEADER_BYTES + 8 + 4 + 12 * tasks_.size() + payload_.size();
+        case MessageType::TASK_TRANSFER:
+            return HEADER_BYTES + 12;
+        case MessageType::TASK_BATCH:
+            return HEADER_BYTES + 4 + 12 * tasks_.size();
+        case MessageType::EXCHANGE_OFFER:
+        case MessageType::TASK_REQUEST:
+        case MessageType::SNAPSHOT_MARKER:
+            return HEADER_BYTES + 4;
+        case MessageType::HELP_WANTED:
+            return HEADER_BYTES + 13;
+        case MessageType::TASK_COMPLETE:
+        case MessageType::TASK_RELEASED:
+        case MessageType::DEPENDENCY_RESOLVED:
+        case MessageType::TASK_CANCEL:
+            return HEADER_BYTES + 4;  // Task ID
+        case MessageType::GOSSIP_DIGEST:
+        case MessageType::GOSSIP_DIGEST_REPLY:
+        case MessageType::TASK_WITHDRAW:
+            return HEADER_BYTES + 4 + payload_.size();
+        case MessageType::CACHE_HINT:
+            return HEADER_BYTES + payload_.size();
+        default:
+            return HEADER_BYTES;
+    }
+}
+
 std::string Message::toString() const {
     std::stringstream ss;
     ss << "Message[";
@@ -51,14 +193,70 @@ std::string Message::toString() const {
         case MessageType::PEER_DISCOVERY:
             ss << "PEER_DISCOVERY";
             break;
+        case MessageType::GOSSIP_DIGEST:
+            ss << "GOSSIP_DIGEST";
+            break;
+        case MessageType::GOSSIP_DIGEST_REPLY:
+            ss << "GOSSIP_DIGEST_REPLY";
+            break;
+        case MessageType::TASK_COMPLETE:
+            ss << "TASK_COMPLETE";
+            break;
+        case MessageType::DEPENDENCY_RESOLVED:
+            ss << "DEPENDENCY_RESOLVED";
+            break;
+        case MessageType::TASK_CANCEL:
+            ss << "TASK_CANCEL";
+            break;
+        case MessageType::CACHE_HINT:
+            ss << "CACHE_HINT";
+            break;
+        case MessageType::TASK_BATCH:
+            ss << "TASK_BATCH";
+            break;
+        case MessageType::EXCHANGE_OFFER:
+            ss << "EXCHANGE_OFFER";
+            break;
+        case MessageType::HELP_WANTED:
+            ss << "HELP_WANTED";
+            break;
+        case MessageType::SNAPSHOT_MARKER:
+            ss << "SNAPSHOT_MARKER";
+            break;
+        case MessageType::TASK_RELEASED:
+            ss << "TASK_RELEASED";
+            break;
+        case MessageType::TASK_WITHDRAW:
+            ss << "TASK_WITHDRAW";
+            break;
     }
     
     ss << " from=" << sender_id_ << " to=" << receiver_id_;
     
     if (type_ == MessageType::LOAD_UPDATE) {
+        ss << " load=" << load_value_ << " credits=" << credits_;
+    } else if (type_ == MessageType::EXCHANGE_OFFER) {
         ss << " load=" << load_value_;
-    } else if (type_ == MessageType::TASK_TRANSFER && task_) {
+    } else if (type_ == MessageType::TASK_REQUEST) {
+        ss << " wanted=" << load_value_;
+    } else if (type_ == MessageType::SNAPSHOT_MARKER) {
+        ss << " snapshot=" << load_value_;
+    } else if (type_ == MessageType::HELP_WANTED) {
+        ss << " origin=" << rumor_origin_ << " rumor=" << rumor_id_
+           << " ttl=" << rumor_ttl_ << " load=" << load_value_;
+    } else if (type_ == MessageType::TASK_BATCH) {
+        ss << " tasks=" << tasks_.size();
+    } else if ((type_ == MessageType::TASK_TRANSFER ||
+                type_ == MessageType::TASK_COMPLETE ||
+                type_ == MessageType::DEPENDENCY_RESOLVED) && task_) {
         ss << " task_id=" << task_->getId();
+    } else if (type_ == MessageType::TASK_CANCEL || type_ == MessageType::TASK_RELEASED) {
+        ss << " task_id=" << task_id_;
+    } else if (type_ == MessageType::GOSSIP_DIGEST ||
+               type_ == MessageType::GOSSIP_DIGEST_REPLY ||
+               type_ == MessageType::CACHE_HINT ||
+               type_ == MessageType::TASK_WITHDRAW) {
+        ss << " digest_bytes=" << payload_.size();
     }
     
     ss << "]";
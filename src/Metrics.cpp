@@ -0,0 +1,395 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+Metrics::Metrics()
+    : completed_(0), admission_rejects_(0), overflow_rejects_(0),
+      redirects_(0), blocked_ns_(0), transfers_(0), transfer_overshoots_(0),
+      view_age_us_sum_(0), view_age_samples_(0), view_updates_(0),
+      piggybacked_view_updates_(0), lost_tasks_(0),
+      input_fetch_ms_(0), cancelled_tasks_(0), expired_tasks_(0), work_avoided_ms_(0),
+      late_completions_(0), late_work_ms_(0), coalesced_tasks_(0), cache_hits_(0),
+      dedup_saved_ms_(0), hint_routed_tasks_(0), routing_decisions_(0), routing_regret_(0),
+      sos_raised_(0), rumor_messages_(0), steal_requests_(0), parks_(0), wakeups_(0),
+      replica_bytes_(0), recovered_tasks_(0), withdrawn_tasks_(0), recovered_at_ns_(0),
+      restored_tasks_(0), restore_ns_(0) {
+}
+
+void Metrics::recordCompletion(std::chrono::steady_clock::time_point created, int work_ms) {
+    double latency_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - created).count();
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex_);
+        latencies_ms_.push_back(latency_ms);
+        latency_work_ms_.push_back(work_ms);
+    }
+    completed_++;
+}
+
+void Metrics::recordAdmissionReject() {
+    admission_rejects_++;
+}
+
+void Metrics::recordOverflowReject() {
+    overflow_rejects_++;
+}
+
+void Metrics::recordRedirect() {
+    redirects_++;
+}
+
+void Metrics::recordTransfer(bool overshoot) {
+    transfers_++;
+    if (overshoot) {
+        transfer_overshoots_++;
+    }
+}
+
+void Metrics::recordViewAge(double age_ms) {
+    view_age_us_sum_ += static_cast<long long>(age_ms * 1000.0);
+    view_age_samples_++;
+}
+
+void Metrics::recordViewUpdate(bool piggybacked) {
+    view_updates_++;
+    if (piggybacked) {
+        piggybacked_view_updates_++;
+    }
+}
+
+void Metrics::recordBlocked(std::chrono::steady_clock::duration waited) {
+    blocked_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count();
+}
+
+void Metrics::recordLostTask() {
+    lost_tasks_++;
+}
+
+void Metrics::recordJobCompletion(std::chrono::steady_clock::time_point created,
+                                  int critical_path_ms) {
+    double makespan_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - created).count();
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    makespans_ms_.push_back(makespan_ms);
+    critical_paths_ms_.push_back(critical_path_ms);
+}
+
+void Metrics::recordInputFetch(int ms) {
+    input_fetch_ms_ += ms;
+}
+
+double Metrics::getInputFetchSeconds() const {
+    return input_fetch_ms_.load() / 1000.0;
+}
+
+void Metrics::recordDiscarded(bool expired, int remaining_work_ms) {
+    if (expired) {
+        expired_tasks_++;
+    } else {
+        cancelled_tasks_++;
+    }
+    work_avoided_ms_ += remaining_work_ms;
+}
+
+void Metrics::recordLateCompletion(int work_ms) {
+    late_completions_++;
+    late_work_ms_ += work_ms;
+}
+
+void Metrics::recordDeduplicated(bool cache_hit, int work_ms) {
+    if (cache_hit) {
+        cache_hits_++;
+    } else {
+        coalesced_tasks_++;
+    }
+    dedup_saved_ms_ += work_ms;
+}
+
+void Metrics::recordHintRouted() {
+    hint_routed_tasks_++;
+}
+
+void Metrics::recordRoutingRegret(int tasks) {
+    routing_decisions_++;
+    routing_regret_ += tasks;
+}
+
+void Metrics::recordSosRaised() {
+    sos_raised_++;
+}
+
+void Metrics::recordRumorMessages(int count) {
+    rumor_messages_ += count;
+}
+
+void Metrics::recordStealRequest() {
+    steal_requests_++;
+}
+
+void Metrics::recordPark() {
+    parks_++;
+}
+
+void Metrics::recordWake() {
+    wakeups_++;
+}
+
+void Metrics::recordReplicaBytes(size_t bytes) {
+    replica_bytes_ += static_cast<long long>(bytes);
+}
+
+void Metrics::recordRecovery(int tasks) {
+    recovered_tasks_ += tasks;
+    recovered_at_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Metrics::recordRecoveryWithdrawn(int tasks) {
+    withdrawn_tasks_ += tasks;
+}
+
+void Metrics::recordRestart(int restored_tasks, double seconds) {
+    restored_tasks_ += restored_tasks;
+    restore_ns_ += static_cast<long long>(seconds * 1e9);
+}
+
+void Metrics::recordLocalSnapshot(const LocalSnapshot& local) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    GlobalSnapshot& global = snapshots_[local.snapshot_id];
+    global.snapshot_id = local.snapshot_id;
+    global.nodes++;
+    global.admitted += local.admitted;
+    global.received += local.received;
+    global.sent += local.sent;
+    global.finished += local.finished;
+    global.held += local.held();
+    global.in_channel += local.channel_tasks;
+    global.queued += local.queued;
+    global.completed_at = std::chrono::steady_clock::now();
+}
+
+bool Metrics::getSnapshot(int snapshot_id, int nodes, GlobalSnapshot& snapshot) const {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    auto it = snapshots_.find(snapshot_id);
+    if (it == snapshots_.end() || it->second.nodes < nodes) {
+        return false;
+    }
+    snapshot = it->second;
+    return true;
+}
+
+int Metrics::getRestoredTasks() const {
+    return restored_tasks_.load();
+}
+
+double Metrics::getRestoreSeconds() const {
+    return restore_ns_.load() / 1e9;
+}
+
+long long Metrics::getReplicaBytes() const {
+    return replica_bytes_.load();
+}
+
+int Metrics::getRecoveredTasks() const {
+    return recovered_tasks_.load();
+}
+
+int Metrics::getWithdrawnTasks() const {
+    return withdrawn_tasks_.load();
+}
+
+std::chrono::steady_clock::time_point Metrics::getLastRecoveryTime() const {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(recovered_at_ns_.load())));
+}
+
+int Metrics::getParks() const {
+    return parks_.load();
+}
+
+int Metrics::getWakeups() const {
+    return wakeups_.load();
+}
+
+int Metrics::getSosRaised() const {
+    return sos_raised_.load();
+}
+
+int Metrics::getRumorMessages() const {
+    return rumor_messages_.load();
+}
+
+int Metrics::getStealRequests() const {
+    return steal_requests_.load();
+}
+
+int Metrics::getRoutingDecisions() const {
+    return routing_decisions_.load();
+}
+
+long long Metrics::getCumulativeRegret() const {
+    return routing_regret_.load();
+}
+
+double Metrics::getMeanRegret() const {
+    int decisions = routing_decisions_.load();
+    return decisions > 0 ? static_cast<double>(routing_regret_.load()) / decisions : 0.0;
+}
+
+int Metrics::getCoalescedTasks() const {
+    return coalesced_tasks_.load();
+}
+
+int Metrics::getCacheHits() const {
+    return cache_hits_.load();
+}
+
+double Metrics::getDedupSavedSeconds() const {
+    return dedup_saved_ms_.load() / 1000.0;
+}
+
+int Metrics::getHintRoutedTasks() const {
+    return hint_routed_tasks_.load();
+}
+
+int Metrics::getCancelledTasks() const {
+    return cancelled_tasks_.load();
+}
+
+int Metrics::getExpiredTasks() const {
+    return expired_tasks_.load();
+}
+
+double Metrics::getWorkAvoidedSeconds() const {
+    return work_avoided_ms_.load() / 1000.0;
+}
+
+int Metrics::getLateCompletions() const {
+    return late_completions_.load();
+}
+
+double Metrics::getLateWorkSeconds() const {
+    return late_work_ms_.load() / 1000.0;
+}
+
+int Metrics::getJobsCompleted() const {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    return static_cast<int>(makespans_ms_.size());
+}
+
+double Metrics::getMeanMakespan() const {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    if (makespans_ms_.empty()) {
+        return 0.0;
+    }
+    return std::accumulate(makespans_ms_.begin(), makespans_ms_.end(), 0.0) /
+           makespans_ms_.size();
+}
+
+double Metrics::getMakespanPercentile(double p) const {
+    std::vector<double> samples;
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex_);
+        samples = makespans_ms_;
+    }
+    return percentile(std::move(samples), p);
+}
+
+double Metrics::getMeanCriticalPath() const {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    if (critical_paths_ms_.empty()) {
+        return 0.0;
+    }
+    return std::accumulate(critical_paths_ms_.begin(), critical_paths_ms_.end(), 0.0) /
+           critical_paths_ms_.size();
+}
+
+int Metrics::getCompleted() const {
+    return completed_.load();
+}
+
+int Metrics::getAdmissionRejects() const {
+    return admission_rejects_.load();
+}
+
+int Metrics::getOverflowRejects() const {
+    return overflow_rejects_.load();
+}
+
+int Metrics::getRedirects() const {
+    return redirects_.load();
+}
+
+double Metrics::getBlockedSeconds() const {
+    return blocked_ns_.load() / 1e9;
+}
+
+int Metrics::getTransfers() const {
+    return transfers_.load();
+}
+
+int Metrics::getTransferOvershoots() const {
+    return transfer_overshoots_.load();
+}
+
+double Metrics::getMeanViewAge() const {
+    int samples = view_age_samples_.load();
+    return samples > 0 ? view_age_us_sum_.load() / 1000.0 / samples : 0.0;
+}
+
+int Metrics::getViewUpdates() const {
+    return view_updates_.load();
+}
+
+int Metrics::getPiggybackedViewUpdates() const {
+    return piggybacked_view_updates_.load();
+}
+
+int Metrics::getLostTasks() const {
+    return lost_tasks_.load();
+}
+
+double Metrics::getLatencyPercentile(double p) const {
+    std::vector<double> samples;
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex_);
+        samples = latencies_ms_;
+    }
+    return percentile(std::move(samples), p);
+}
+
+double Metrics::getLatencyPercentile(double p, int min_work_ms, int max_work_ms) const {
+    std::vector<double> samples;
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex_);
+        for (size_t i = 0; i < latencies_ms_.size(); ++i) {
+            if (latency_work_ms_[i] >= min_work_ms && latency_work_ms_[i] <= max_work_ms) {
+                samples.push_back(latencies_ms_[i]);
+            }
+        }
+    }
+    return percentile(std::move(samples), p);
+}
+
+double Metrics::percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+
+    // Nearest-rank percentile
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    rank = std::clamp<size_t>(rank, 1, samples.size());
+    return samples[rank - 1];
+}
+
+double Metrics::getMeanLatency() const {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    if (latencies_ms_.empty()) {
+        return 0.0;
+    }
+    return std::accumulate(latencies_ms_.begin(), latencies_ms_.end(), 0.0) /
+           latencies_ms_.size();
+}
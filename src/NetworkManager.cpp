@@ -1,11 +1,25 @@
 #include "NetworkManager.h"
 #include "PeerNode.h"
 #include "Logger.h"
+#include <algorithm>
+#include <fstream>
+#include <cmath>
 
-NetworkManager::NetworkManager() {
+NetworkManager::NetworkManager()
+    : messages_sent_(0), bytes_sent_(0),
+      rate_limited_(false), shaping_(false), broadcast_round_(0),
+      cross_zone_transfers_(0),
+      messages_delayed_(0), delay_us_(0) {
+    for (auto& sent : sent_by_class_) {
+        sent = 0;
+    }
+    for (auto& dropped : dropped_by_class_) {
+        dropped = 0;
+    }
 }
 
 NetworkManager::~NetworkManager() {
+    stop();
 }
 
 void NetworkManager::registerNode(int node_id, PeerNode* node) {
@@ -16,8 +30,37 @@ void NetworkManager::registerNode(int node_id, PeerNode* node) {
                               std::to_string(node_id));
 }
 
-void NetworkManager::sendMessage(const Message& message) {
+int NetworkManager::getNodeLoad(int node_id) const {
+    PeerNode* node = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(nodes_mutex_);
+        auto it = nodes_.find(node_id);
+        if (it != nodes_.end()) {
+            node = it->second;
+        }
+    }
+    return node ? node->getCurrentLoad() : -1;  // Nodes outlive the run
+}
+
+size_t NetworkManager::getNodeCount() const {
+    std::lock_guard<std::mutex> lock(nodes_mutex_);
+    return nodes_.size();
+}
+
+std::vector<int> NetworkManager::getLiveNodeIds() const {
+    std::lock_guard<std::mutex> lock(nodes_mutex_);
+    std::vector<int> live;
+    for (const auto& [node_id, node] : nodes_) {
+        if (!node->isCrashed()) {
+            live.push_back(node_id);
+        }
+    }
+    return live;
+}
+
+bool NetworkManager::sendMessage(const Message& message) {
     PeerNode* receiver = nullptr;
+    LinkProfile profile;
     
     {
         std::lock_guard<std::mutex> lock(nodes_mutex_);
@@ -25,39 +68,306 @@ void NetworkManager::sendMessage(const Message& message) {
         if (it != nodes_.end()) {
             receiver = it->second;
         }
+        auto link = links_.find({message.getSenderId(), message.getReceiverId()});
+        if (link != links_.end()) {
+            profile = link->second;
+        }
     }
     
-    if (receiver) {
-        receiver->handleMessage(message);
-        Logger::getInstance().log("NetworkManager: Sent " + message.toString());
-    } else {
+    if (!receiver) {
         Logger::getInstance().log(std::string("NetworkManager: Failed to send message - ") +
                                   "receiver " + std::to_string(message.getReceiverId()) +
                                   " not found");
+        return false;
     }
+    
+    auto hold = std::chrono::steady_clock::duration::zero();
+    if (!admit(message.getSenderId(), message.getReceiverId(), message.getType(), hold)) {
+        Logger::getInstance().log("NetworkManager: Rate limit dropped " + message.toString());
+        return false;
+    }
+    
+    deliver(message.getReceiverId(), receiver, message, profile, hold);
+    messages_sent_++;
+    sent_by_class_[static_cast<size_t>(messageClassOf(message.getType()))]++;
+    bytes_sent_ += message.getWireSize();
+    if (getNodeZone(message.getSenderId()) != getNodeZone(message.getReceiverId())) {
+        if (message.getType() == MessageType::TASK_TRANSFER && message.getTask()) {
+            cross_zone_transfers_++;
+        } else if (message.getType() == MessageType::TASK_BATCH) {
+            cross_zone_transfers_ += static_cast<long long>(message.getTasks().size());
+        }
+    }
+    Logger::getInstance().log("NetworkManager: Sent " + message.toString());
+    return true;
 }
 
-void NetworkManager::broadcastMessage(int sender_id, const Message& message) {
-    std::vector<PeerNode*> receivers;
+void NetworkManager::broadcastMessage(int sender_id, const Message& message, int except_id) {
+    struct Receiver {
+        int node_id;
+        PeerNode* node;
+        LinkProfile profile;
+    };
+    std::vector<Receiver> receivers;
     
     {
         std::lock_guard<std::mutex> lock(nodes_mutex_);
         for (const auto& [node_id, node] : nodes_) {
-            if (node_id != sender_id) {  // Don't send to self
-                receivers.push_back(node);
+            if (node_id != sender_id && node_id != except_id) {  // Don't send to self
+                auto link = links_.find({sender_id, node_id});
+                receivers.push_back({node_id, node,
+                                     link != links_.end() ? link->second : LinkProfile()});
             }
         }
     }
     
-    for (PeerNode* receiver : receivers) {
-        receiver->handleMessage(message);
+    size_t delivered = 0;
+    size_t n = receivers.size();
+    size_t start = n > 0 ? static_cast<size_t>(broadcast_round_++) % n : 0;
+    for (size_t i = 0; i < n; ++i) {
+        const Receiver& receiver = receivers[(start + i) % n];
+        auto hold = std::chrono::steady_clock::duration::zero();
+        if (!admit(sender_id, receiver.node_id, message.getType(), hold)) {
+            continue;
+        }
+        deliver(receiver.node_id, receiver.node, message, receiver.profile, hold);
+        delivered++;
     }
+    messages_sent_ += delivered;
+    sent_by_class_[static_cast<size_t>(messageClassOf(message.getType()))] += delivered;
+    bytes_sent_ += message.getWireSize() * delivered;
     
-    if (!receivers.empty()) {
+    if (delivered > 0) {
         Logger::getInstance().log("NetworkManager: Broadcast from node " + 
                                   std::to_string(sender_id) + " to " +
-                                  std::to_string(receivers.size()) + " peers");
+                                  std::to_string(delivered) + " peers");
+    }
+}
+
+void NetworkManager::setLinkRateLimit(const RateLimit& limit) {
+    {
+        std::lock_guard<std::mutex> lock(limits_mutex_);
+        link_limit_ = limit;
+        link_buckets_.clear();
+        rate_limited_ = true;
+    }
+    if (limit.rate_per_sec > 0.0 && limit.action == RateLimitAction::QUEUE) {
+        shaping_ = true;
+        startDelivery();
+    }
+}
+
+void NetworkManager::setClassRateLimit(MessageClass message_class, const RateLimit& limit) {
+    {
+        std::lock_guard<std::mutex> lock(limits_mutex_);
+        class_limits_[static_cast<size_t>(message_class)] = limit;
+        class_buckets_.clear();
+        rate_limited_ = true;
+    }
+    if (limit.rate_per_sec > 0.0 && limit.action == RateLimitAction::QUEUE) {
+        shaping_ = true;
+        startDelivery();
+    }
+}
+
+void NetworkManager::setNodeZone(int node_id, int zone) {
+    std::lock_guard<std::mutex> lock(nodes_mutex_);
+    zones_[node_id] = zone;
+}
+
+int NetworkManager::getNodeZone(int node_id) const {
+    std::lock_guard<std::mutex> lock(nodes_mutex_);
+    auto it = zones_.find(node_id);
+    return it != zones_.end() ? it->second : 0;
+}
+
+void NetworkManager::setLinkProfile(int from, int to, const LinkProfile& profile) {
+    {
+        std::lock_guard<std::mutex> lock(nodes_mutex_);
+        links_[{from, to}] = profile;
+    }
+    
+    if (profile.latency_ms > 0.0 || profile.bandwidth_bytes_per_sec > 0.0) {
+        startDelivery();
+    }
+}
+
+void NetworkManager::startDelivery() {
+    std::lock_guard<std::mutex> lock(delivery_mutex_);
+    if (!delivering_) {
+        delivering_ = true;
+        delivery_thread_ = std::thread(&NetworkManager::deliveryLoop, this);
+    }
+}
+
+LinkProfile NetworkManager::getLinkProfile(int from, int to) const {
+    std::lock_guard<std::mutex> lock(nodes_mutex_);
+    auto it = links_.find({from, to});
+    return it != links_.end() ? it->second : LinkProfile();
+}
+
+bool NetworkManager::loadLinkMatrix(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<double> values;
+    double value;
+    while (in >> value) {
+        values.push_back(value);
+    }
+    
+    // N*N latencies, optionally followed by N*N bandwidths
+    size_t n = static_cast<size_t>(std::lround(std::sqrt(static_cast<double>(values.size()))));
+    bool with_bandwidth = false;
+    if (n * n != values.size()) {
+        n = static_cast<size_t>(std::lround(std::sqrt(values.size() / 2.0)));
+        with_bandwidth = true;
+        if (2 * n * n != values.size()) {
+            Logger::getInstance().log("NetworkManager: Malformed link matrix " + path);
+            return false;
+        }
+    }
+    if (n == 0) {
+        Logger::getInstance().log("NetworkManager: Empty or missing link matrix " + path);
+        return false;
+    }
+    
+    for (size_t from = 0; from < n; ++from) {
+        for (size_t to = 0; to < n; ++to) {
+            if (from == to) {
+                continue;
+            }
+            LinkProfile profile;
+            profile.latency_ms = values[from * n + to];
+            if (with_bandwidth) {
+                profile.bandwidth_bytes_per_sec = values[n * n + from * n + to];
+            }
+            setLinkProfile(static_cast<int>(from), static_cast<int>(to), profile);
+        }
+    }
+    return true;
+}
+
+void NetworkManager::stop() {
+    {
+        std::lock_guard<std::mutex> lock(delivery_mutex_);
+        if (!delivering_) {
+            return;
+        }
+        delivering_ = false;
+    }
+    delivery_cv_.notify_all();
+    if (delivery_thread_.joinable()) {
+        delivery_thread_.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(delivery_mutex_);
+    pending_ = {};
+}
+
+void NetworkManager::deliver(int receiver_id, PeerNode* receiver, const Message& message,
+                             const LinkProfile& profile,
+                             std::chrono::steady_clock::duration hold) {
+    if (profile.latency_ms <= 0.0 && profile.bandwidth_bytes_per_sec <= 0.0 && !shaping_) {
+        receiver->handleMessage(message);
+        return;
     }
+    
+    // A shaped message may not leave before its token is due
+    auto now = std::chrono::steady_clock::now() + hold;
+    {
+        std::lock_guard<std::mutex> lock(delivery_mutex_);
+        if (!delivering_) {
+            return;  // Network stopped: message is lost in flight
+        }
+        
+        // Serialize behind earlier messages on this link, then propagate
+        auto& link_free_at = link_free_at_[{message.getSenderId(), receiver_id}];
+        auto departure = std::max(now, link_free_at);
+        if (profile.bandwidth_bytes_per_sec > 0.0) {
+            departure += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(message.getWireSize() /
+                                              profile.bandwidth_bytes_per_sec));
+        }
+        link_free_at = departure;
+        auto due = departure + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(profile.latency_ms));
+        
+        pending_.push({due, delivery_sequence_++, receiver, message});
+    }
+    delivery_cv_.notify_one();
+}
+
+void NetworkManager::deliveryLoop() {
+    std::unique_lock<std::mutex> lock(delivery_mutex_);
+    while (delivering_) {
+        if (pending_.empty()) {
+            delivery_cv_.wait(lock);
+            continue;
+        }
+        
+        auto due = pending_.top().due;
+        if (std::chrono::steady_clock::now() < due) {
+            delivery_cv_.wait_until(lock, due);  // Woken early by an earlier arrival or stop()
+            continue;
+        }
+        
+        PendingDelivery next = pending_.top();
+        pending_.pop();
+        lock.unlock();
+        next.receiver->handleMessage(next.message);
+        lock.lock();
+    }
+}
+
+bool NetworkManager::admit(int sender_id, int receiver_id, MessageType type,
+                           std::chrono::steady_clock::duration& hold) {
+    if (!rate_limited_) {
+        return true;
+    }
+    
+    size_t cls = static_cast<size_t>(messageClassOf(type));
+    std::chrono::steady_clock::duration wait = std::chrono::steady_clock::duration::zero();
+    {
+        std::lock_guard<std::mutex> lock(limits_mutex_);
+        
+        struct Charge {
+            TokenBucket* bucket;
+            RateLimitAction action;
+        };
+        std::vector<Charge> charges;
+        auto addCharge = [&](std::map<std::pair<int, int>, TokenBucket>& buckets,
+                             std::pair<int, int> key, const RateLimit& limit) {
+            if (limit.rate_per_sec <= 0.0) {
+                return;
+            }
+            double burst = limit.burst > 0.0 ? limit.burst : limit.rate_per_sec;
+            auto it = buckets.try_emplace(key, limit.rate_per_sec, burst).first;
+            charges.push_back({&it->second, limit.action});
+        };
+        addCharge(link_buckets_, {sender_id, receiver_id}, link_limit_);
+        addCharge(class_buckets_, {sender_id, static_cast<int>(cls)}, class_limits_[cls]);
+        
+        // Police before shaping so a dropped message spends no tokens
+        for (const Charge& charge : charges) {
+            if (charge.action == RateLimitAction::DROP && !charge.bucket->available()) {
+                dropped_by_class_[cls]++;
+                return false;
+            }
+        }
+        for (const Charge& charge : charges) {
+            if (charge.action == RateLimitAction::DROP) {
+                charge.bucket->tryConsume();
+            } else {
+                wait = std::max(wait, charge.bucket->reserve());
+            }
+        }
+    }
+    
+    if (wait > std::chrono::steady_clock::duration::zero()) {
+        messages_delayed_++;
+        delay_us_ += std::chrono::duration_cast<std::chrono::microseconds>(wait).count();
+        hold = wait;  // Waits in the delivery queue, not in the sender
+    }
+    return true;
 }
 
 std::vector<int> NetworkManager::getAllNodeIds() const {
@@ -70,3 +380,39 @@ std::vector<int> NetworkManager::getAllNodeIds() const {
     
     return node_ids;
 }
+
+long long NetworkManager::getMessagesSent() const {
+    return messages_sent_.load();
+}
+
+long long NetworkManager::getMessagesSent(MessageClass message_class) const {
+    return sent_by_class_[static_cast<size_t>(message_class)].load();
+}
+
+long long NetworkManager::getBytesSent() const {
+    return bytes_sent_.load();
+}
+
+long long NetworkManager::getMessagesDropped() const {
+    long long total = 0;
+    for (const auto& dropped : dropped_by_class_) {
+        total += dropped.load();
+    }
+    return total;
+}
+
+long long NetworkManager::getMessagesDropped(MessageClass message_class) const {
+    return dropped_by_class_[static_cast<size_t>(message_class)].load();
+}
+
+long long NetworkManager::getMessagesDelayed() const {
+    return messages_delayed_.load();
+}
+
+double NetworkManager::getRateLimitDelaySeconds() const {
+    return delay_us_.load() / 1e6;
+}
+
+long long NetworkManager::getCrossZoneTransfers() const {
+    return cross_zone_transfers_.load();
+}
@@ -1,12 +1,105 @@
 #include "PeerNode.h"
 #include "NetworkManager.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "GossipDigest.h"
+#include "TaskAudit.h"
 #include <algorithm>
+#include <cmath>
 #include <random>
 
+// Robust routing trust dynamics: fast to lose, slow to regain (AIMD-like)
+const double TRUST_PENALTY = 0.5;   // Multiplier on an inconsistent report
+const double TRUST_REWARD = 0.05;   // Step toward 1.0 per acknowledged task
+// A transfer only counts against a peer's report once it has had this long
+// to land: a report sampled while the task was still on the wire is honest
+const auto OUTSTANDING_GRACE = std::chrono::milliseconds(500);
+
+// Cancellation: how long a tombstone or forwarding record is kept. Longer
+// than any task stays queued or in flight in these experiments.
+const auto CANCEL_STATE_TTL = std::chrono::seconds(10);
+
+// Bandit routing: an ack later than this is scored as a lost task, and
+// feature statistics move 1/8 of the way per observation
+const double BANDIT_ACK_TIMEOUT_S = 5.0;
+const double BANDIT_EWMA_WEIGHT = 1.0 / 8.0;
+
+// Bandit prior (reward = -seconds to ack): a threshold's worth of queue or a
+// second of past ack latency costs about a second, like greedy routing
+const BanditContext BANDIT_PRIOR = {0.0, -1.0, -0.1, -1.0, 0.0};
+
+// SOS: rumor rate cap, how long an origin stays a help target after its
+// last report, and when an unanswered steal request is given up
+const auto SOS_MIN_INTERVAL = std::chrono::milliseconds(50);
+const auto SOS_TARGET_TTL = std::chrono::seconds(2);
+const auto STEAL_TIMEOUT = std::chrono::seconds(1);
+
+// Tasks a message moves to its receiver (lost with it if the receiver crashed)
+static int tasksCarried(const Message& message) {
+    switch (message.getType()) {
+        case MessageType::TASK_TRANSFER:
+            return message.getTask() ? 1 : 0;
+        case MessageType::TASK_BATCH:
+            return static_cast<int>(message.getTasks().size());
+        default:
+            return 0;
+    }
+}
+
+// Flips the in-transit audit bit of every task a message carries
+static void auditTransit(TaskAudit* audit, const Message& message) {
+    if (message.getType() == MessageType::TASK_TRANSFER && message.getTask()) {
+        audit->markTransit(message.getTask()->getId());
+    } else if (message.getType() == MessageType::TASK_BATCH) {
+        for (const auto& task : message.getTasks()) {
+            audit->markTransit(task->getId());
+        }
+    }
+}
+
+// Journal times are wall clock (steady_clock restarts with the process);
+// both conversions go through the current offset between the two clocks
+static int64_t toJournalTime(std::chrono::steady_clock::time_point time) {
+    auto wall = std::chrono::system_clock::now() +
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            time - std::chrono::steady_clock::now());
+    return std::chrono::duration_cast<std::chrono::microseconds>(wall.time_since_epoch()).count();
+}
+
+static std::chrono::steady_clock::time_point fromJournalTime(int64_t micros) {
+    std::chrono::system_clock::time_point wall{std::chrono::microseconds(micros)};
+    return std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            wall - std::chrono::system_clock::now());
+}
+
 PeerNode::PeerNode(int id, int load_threshold, NetworkManager* network_manager)
-    : id_(id), load_threshold_(load_threshold), tasks_processed_(0),
-      running_(false), network_manager_(network_manager) {
+    : PeerNode(id, NodeConfig{}, network_manager) {
+    config_.load_threshold = load_threshold;
+}
+
+PeerNode::PeerNode(int id, const NodeConfig& config, NetworkManager* network_manager,
+                   Metrics* metrics)
+    : id_(id), config_(config), tasks_processed_(0), avg_service_ms_(0.0), queued_tasks_(0),
+      running_tasks_(0),
+      dormant_(false), awake_since_(std::chrono::steady_clock::now()), awake_seconds_(0.0),
+      dormant_ticks_(0), replica_buddy_(-1), snapshot_open_(false),
+      credit_round_(0), lamport_clock_(0), digest_round_(0), balance_round_(0),
+      gossip_rng_(std::random_device{}() + static_cast<unsigned>(id)), key_hint_seq_(0),
+      bandit_(config.bandit_alpha, BANDIT_PRIOR), steal_from_(-1), sos_id_(0), sos_armed_(true),
+      rumor_rng_(std::random_device{}() + static_cast<unsigned>(id)), running_(false),
+      crashed_(false), network_manager_(network_manager), metrics_(metrics), audit_(nullptr) {
+    task_queues_.resize(config_.mlfq ? std::max(1, config_.mlfq_levels) : 1);
+    capacity_ = config_.resource_capacity;
+    if (capacity_[RESOURCE_CPU] <= 0.0) {
+        capacity_[RESOURCE_CPU] = config_.num_workers;
+    }
+    in_use_.fill(0.0);
+    queued_demand_.fill(0.0);
+    if (!config_.journal_dir.empty()) {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        openJournalLocked();
+    }
 }
 
 PeerNode::~PeerNode() {
@@ -20,8 +113,8 @@ void PeerNode::start() {
     
     Logger::getInstance().logNodeEvent(id_, "Starting node");
     
-    // Start worker threads (2 workers per node)
-    for (int i = 0; i < 2; ++i) {
+    // Start worker threads (2 workers per node by default)
+    for (int i = 0; i < config_.num_workers; ++i) {
         worker_threads_.emplace_back(&PeerNode::workerLoop, this);
     }
     
@@ -41,6 +134,7 @@ void PeerNode::stop() {
     
     // Wake up all waiting threads
     queue_cv_.notify_all();
+    space_cv_.notify_all();
     message_cv_.notify_all();
     
     // Join worker threads
@@ -60,218 +154,2588 @@ void PeerNode::stop() {
     }
 }
 
-void PeerNode::addTask(std::shared_ptr<Task> task) {
+void PeerNode::crash() {
+    std::vector<std::shared_ptr<Task>> dropped;
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        task_queue_.push(task);
+        crashed_ = true;
+        if (journal_) {
+            journal_->abandon();  // Uncommitted records die with the process
+            journal_.reset();
+        }
+        while (queued_tasks_ > 0) {
+            dropped.push_back(popTask());
+        }
+        // Followers wait on a leader that is gone; the cache was process memory
+        for (auto& [key, group] : coalesced_) {
+            dropped.insert(dropped.end(), group.followers.begin(), group.followers.end());
+        }
+        coalesced_.clear();
+        result_cache_.clear();
+        cache_lru_.clear();
+        unadvertised_keys_.clear();
+    }
+    int in_flight = 0;
+    {
+        std::lock_guard<std::mutex> lock(message_mutex_);
+        for (; !message_queue_.empty(); message_queue_.pop()) {
+            in_flight += tasksCarried(message_queue_.front());
+            countReceived(message_queue_.front());
+        }
+    }
+    countFinished(static_cast<int>(dropped.size()) + in_flight);
+    for (int i = static_cast<int>(dropped.size()) + in_flight; i > 0 && metrics_; --i) {
+        metrics_->recordLostTask();
+    }
+    {
+        std::lock_guard<std::mutex> lock(ledger_mutex_);
+        snapshot_open_ = false;  // Our part of a snapshot in progress dies with us
     }
-    queue_cv_.notify_one();
-    
     Logger::getInstance().logNodeEvent(id_, 
-        "Added task " + std::to_string(task->getId()) + 
-        " (queue size: " + std::to_string(getCurrentLoad()) + ")");
-}
-
-int PeerNode::getCurrentLoad() const {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    return static_cast<int>(task_queue_.size());
+        "Crashed with " + std::to_string(dropped.size()) + " queued tasks");
 }
 
-int PeerNode::getTasksProcessed() const {
-    return tasks_processed_.load();
+bool PeerNode::isCrashed() const {
+    return crashed_.load();
 }
 
-void PeerNode::handleMessage(const Message& message) {
+void PeerNode::restart() {
+    auto start = std::chrono::steady_clock::now();
+    int restored = 0;
     {
-        std::lock_guard<std::mutex> lock(message_mutex_);
-        message_queue_.push(message);
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!crashed_) {
+            return;
+        }
+        if (!config_.journal_dir.empty()) {
+            restored = openJournalLocked();
+        }
+        crashed_ = false;
     }
-    message_cv_.notify_one();
-}
-
-void PeerNode::addPeer(int peer_id) {
-    std::lock_guard<std::mutex> lock(peers_mutex_);
-    if (std::find(peers_.begin(), peers_.end(), peer_id) == peers_.end()) {
-        peers_.push_back(peer_id);
-        Logger::getInstance().logNodeEvent(id_, 
-            "Added peer " + std::to_string(peer_id));
+    queue_cv_.notify_all();
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (metrics_) {
+        metrics_->recordRestart(restored, seconds);
     }
+    Logger::getInstance().logNodeEvent(id_, 
+        "Restarted with " + std::to_string(restored) + " tasks from the journal");
 }
 
-std::vector<int> PeerNode::getPeers() const {
-    std::lock_guard<std::mutex> lock(peers_mutex_);
-    return peers_;
-}
-
-int PeerNode::getId() const {
-    return id_;
+std::string PeerNode::journalPath(const std::string& dir, int node_id) {
+    return dir + "/node-" + std::to_string(node_id) + ".journal";
 }
 
-// Worker thread: processes tasks from the queue
-void PeerNode::workerLoop() {
-    while (running_) {
-        std::shared_ptr<Task> task;
-        
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_cv_.wait(lock, [this] { 
-                return !task_queue_.empty() || !running_; 
-            });
-            
-            if (!running_ && task_queue_.empty()) {
-                break;
-            }
-            
-            if (!task_queue_.empty()) {
-                task = task_queue_.front();
-                task_queue_.pop();
-            }
+int PeerNode::openJournalLocked() {
+    auto journal = std::make_unique<TaskJournal>(journalPath(config_.journal_dir, id_),
+                                                 config_.journal_commit_us,
+                                                 config_.journal_compact_bytes);
+    if (!journal->isOpen()) {
+        return 0;  // Logged by TaskJournal; run without durability
+    }
+    
+    // Requeued before journal_ is set: they are in the journal already
+    int restored = 0;
+    for (const JournalRecord& record : journal->liveTasks()) {
+        auto task = std::make_shared<Task>(record.task_id, record.work_ms, record.demand);
+        task->setContentKey(record.content_key);
+        if (record.created_us != 0) {
+            task->setCreationTime(fromJournalTime(record.created_us));  // Latency from first admission
         }
-        
-        if (task) {
-            Logger::getInstance().logNodeEvent(id_, 
-                "Processing task " + std::to_string(task->getId()));
-            
-            task->execute();
-            tasks_processed_++;
-            
-            Logger::getInstance().logNodeEvent(id_, 
-                "Completed task " + std::to_string(task->getId()) +
-                " (total processed: " + std::to_string(tasks_processed_.load()) + ")");
+        if (record.deadline_us != 0) {
+            task->setDeadline(fromJournalTime(record.deadline_us));  // Expired ones drop on dequeue
         }
+        pushTask(task);
+        restored++;
     }
+    countAdmitted(restored);  // Counted finished (lost) when the node crashed
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& [task_id, peer_id] : journal->transfers()) {
+        forwarded_to_[task_id] = {peer_id, now};
+    }
+    journal_ = std::move(journal);
+    return restored;
 }
 
-// Load monitor thread: periodically checks load and sends updates
-void PeerNode::loadMonitorLoop() {
-    while (running_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
-        
-        if (!running_) break;
-        
-        int current_load = getCurrentLoad();
-        
-        // Log metrics periodically
-        Logger::getInstance().logMetrics(id_, current_load, tasks_processed_);
-        
-        // Broadcast load update to all peers
-        if (network_manager_) {
-            Message load_msg(MessageType::LOAD_UPDATE, id_, -1);  // -1 means broadcast
-            load_msg.setLoadValue(current_load);
-            network_manager_->broadcastMessage(id_, load_msg);
+bool PeerNode::addTask(std::shared_ptr<Task> task) {
+    countAdmitted(1);
+    if (task->getContentKey() != 0) {
+        bool cache_hit = false;
+        bool absorbed;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            absorbed = absorbDuplicateLocked(task, cache_hit);
         }
-        
-        // If load exceeds threshold, try to offload a task
-        if (current_load > load_threshold_) {
-            std::shared_ptr<Task> task;
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                if (!task_queue_.empty()) {
-                    task = task_queue_.front();
-                    task_queue_.pop();
-                }
-            }
-            
-            if (task) {
-                offloadTask(task);
+        if (absorbed) {
+            if (cache_hit) {
+                completeAbsorbed(task, true);  // Costs no queue slot or worker
             }
+            return true;  // Otherwise completes with its leader
+        }
+        if (config_.cache_hints && routeToCacheHolder(task)) {
+            return true;
         }
     }
-}
-
-// Message processor thread: handles incoming messages
-void PeerNode::messageProcessorLoop() {
-    while (running_) {
-        Message message(MessageType::LOAD_UPDATE, -1, -1);
-        
-        {
-            std::unique_lock<std::mutex> lock(message_mutex_);
-            message_cv_.wait(lock, [this] { 
-                return !message_queue_.empty() || !running_; 
-            });
-            
-            if (!running_ && message_queue_.empty()) {
-                break;
-            }
-            
-            if (!message_queue_.empty()) {
-                message = message_queue_.front();
-                message_queue_.pop();
+    
+    if (config_.consolidation && network_manager_) {
+        int target = packingTarget();
+        if (target != -1 && target != id_ && consumeCredit(target)) {
+            task->recordMigration(id_);
+            Message transfer_msg(MessageType::TASK_TRANSFER, id_, target);
+            transfer_msg.setTask(task);
+            stampLoadHeader(transfer_msg);
+            if (sendTasks(transfer_msg)) {
+                recordOutstanding(target, task->getId());
+                rememberForward(task->getId(), target);
+                std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+                peer_loads_[target].load++;  // Until its next report; avoids herding
+                return true;  // Packed onto an awake node
             }
         }
-        
-        // Process message based on type
-        switch (message.getType()) {
-            case MessageType::LOAD_UPDATE: {
-                int peer_id = message.getSenderId();
-                int load = message.getLoadValue();
+        // No credit at the target, or the transfer was dropped: admit here
+    }
+    
+    if (!admitTask()) {
+        countShed(*task);
+        if (metrics_) {
+            metrics_->recordAdmissionReject();
+        }
+        Logger::getInstance().logNodeEvent(id_, 
+            "Admission control rejected task " + std::to_string(task->getId()));
+        return false;
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (isQueueFull()) {
+            switch (config_.overflow_policy) {
+                case OverflowPolicy::BLOCK: {
+                    auto wait_start = std::chrono::steady_clock::now();
+                    space_cv_.wait(lock, [this] { 
+                        return !isQueueFull() || !running_; 
+                    });
+                    if (metrics_) {
+                        metrics_->recordBlocked(std::chrono::steady_clock::now() - wait_start);
+                    }
+                    if (isQueueFull()) {
+                        // Woken by shutdown with no room left
+                        lock.unlock();
+                        countShed(*task);
+                        if (metrics_) {
+                            metrics_->recordOverflowReject();
+                        }
+                        return false;
+                    }
+                    break;
+                }
                 
-                std::lock_guard<std::mutex> lock(peer_loads_mutex_);
-                peer_loads_[peer_id] = load;
+                case OverflowPolicy::REDIRECT:
+                    lock.unlock();
+                    return redirectTask(task);
                 
-                Logger::getInstance().logNodeEvent(id_, 
-                    "Received load update from node " + std::to_string(peer_id) +
-                    ": load=" + std::to_string(load));
-                break;
-            }
-            
-            case MessageType::TASK_TRANSFER: {
-                auto task = message.getTask();
-                if (task) {
-                    addTask(task);
+                case OverflowPolicy::REJECT:
+                    lock.unlock();
+                    countShed(*task);
+                    if (metrics_) {
+                        metrics_->recordOverflowReject();
+                    }
                     Logger::getInstance().logNodeEvent(id_, 
-                        "Received task " + std::to_string(task->getId()) +
-                        " from node " + std::to_string(message.getSenderId()));
-                }
-                break;
-            }
-            
-            case MessageType::PEER_DISCOVERY: {
-                addPeer(message.getSenderId());
-                break;
+                        "Queue full, rejected task " + std::to_string(task->getId()));
+                    return false;
             }
-            
-            default:
-                break;
         }
+        pushTask(task);
     }
+    queue_cv_.notify_one();
+    raiseSos(false);
+    
+    Logger::getInstance().logNodeEvent(id_, 
+        "Added task " + std::to_string(task->getId()) + 
+        " (queue size: " + std::to_string(getCurrentLoad()) + ")");
+    return true;
 }
 
-// Offload a task to the least-loaded peer
-void PeerNode::offloadTask(std::shared_ptr<Task> task) {
-    int best_peer = selectBestPeer();
+void PeerNode::enqueueTask(std::shared_ptr<Task> task) {
+    bool cache_hit = false;
+    bool absorbed;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        absorbed = absorbDuplicateLocked(task, cache_hit);
+        if (!absorbed) {
+            pushTask(task);
+        }
+    }
+    if (absorbed) {
+        if (cache_hit) {
+            completeAbsorbed(task, true);
+        }
+        return;
+    }
+    queue_cv_.notify_one();
+}
+
+void PeerNode::acceptTransferredTask(std::shared_ptr<Task> task, int sender_id) {
+    if (config_.misbehavior == Misbehavior::BLACK_HOLE) {
+        countFinished(1);
+        if (metrics_) {
+            metrics_->recordLostTask();
+        }
+        return;  // Fault injection: swallow the task without a trace
+    }
     
-    if (best_peer != -1 && network_manager_) {
-        Message transfer_msg(MessageType::TASK_TRANSFER, id_, best_peer);
-        transfer_msg.setTask(task);
-        network_manager_->sendMessage(transfer_msg);
-        
+    bool full;
+    bool overshoot = false;
+    bool dead;
+    bool expired = false;
+    bool absorbed = false;
+    bool cache_hit = false;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        forwarded_to_.erase(task->getId());  // Back here; any old forward is moot
+        dead = reapLocked(*task, expired);
+        if (!dead) {
+            absorbed = absorbDuplicateLocked(task, cache_hit);
+        }
+        full = isQueueFull();
+        if (!dead && !absorbed && !full) {
+            pushTask(task);
+            overshoot = queued_tasks_ > config_.load_threshold;
+        }
+    }
+    
+    if (dead) {
+        recordDiscard(*task, expired);  // Cancelled while in flight
+        return;
+    }
+    if (absorbed) {
+        if (cache_hit) {
+            completeAbsorbed(task, true);
+        }
+        return;
+    }
+    if (!full) {
+        if (metrics_) {
+            metrics_->recordTransfer(overshoot);
+        }
+        queue_cv_.notify_one();
         Logger::getInstance().logNodeEvent(id_, 
-            "Offloaded task " + std::to_string(task->getId()) +
-            " to node " + std::to_string(best_peer));
+            "Received task " + std::to_string(task->getId()) +
+            " from node " + std::to_string(sender_id));
+        return;
+    }
+    
+    if (config_.overflow_policy == OverflowPolicy::REDIRECT) {
+        redirectTask(task);
     } else {
-        // No suitable peer, add back to own queue
-        addTask(task);
+        countShed(*task);
+        if (metrics_) {
+            metrics_->recordOverflowReject();
+        }
+        Logger::getInstance().logNodeEvent(id_, 
+            "Queue full, dropped task " + std::to_string(task->getId()) +
+            " from node " + std::to_string(sender_id));
     }
 }
 
-// Select the least-loaded peer for task routing
-int PeerNode::selectBestPeer() {
-    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+void PeerNode::submitDependentTask(std::shared_ptr<Task> task) {
+    countAdmitted(1);
+    std::lock_guard<std::mutex> lock(dag_mutex_);
+    int pending = static_cast<int>(task->getDependencies().size());
+    for (int predecessor : task->getDependencies()) {
+        waiting_on_[predecessor].push_back(task->getId());
+    }
+    parked_[task->getId()] = {task, pending};
+}
+
+int PeerNode::getParkedTaskCount() const {
+    std::lock_guard<std::mutex> lock(dag_mutex_);
+    return static_cast<int>(parked_.size());
+}
+
+void PeerNode::cancelTask(int task_id) {
+    std::shared_ptr<Task> parked_task;
+    {
+        std::lock_guard<std::mutex> lock(dag_mutex_);
+        auto parked = parked_.find(task_id);
+        if (parked != parked_.end()) {
+            parked_task = parked->second.task;
+            parked_.erase(parked);
+        }
+    }
+    if (parked_task) {
+        recordDiscard(*parked_task, false);  // Never released, so never forwarded
+        return;
+    }
     
-    if (peer_loads_.empty()) {
-        return -1;
+    int forwarded_to = -1;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        tombstones_[task_id] = std::chrono::steady_clock::now();
+        auto forward = forwarded_to_.find(task_id);
+        if (forward != forwarded_to_.end()) {
+            forwarded_to = forward->second.first;
+            forwarded_to_.erase(forward);
+        }
     }
+    queue_cv_.notify_all();  // A cancelled head may be waiting for resources
     
-    int best_peer = -1;
-    int min_load = getCurrentLoad();  // Only offload to peers with less load
+    if (forwarded_to >= 0 && network_manager_) {
+        Message cancel(MessageType::TASK_CANCEL, id_, forwarded_to);
+        cancel.setTaskId(task_id);
+        stampLoadHeader(cancel);
+        network_manager_->sendMessage(cancel);
+        Logger::getInstance().logNodeEvent(id_, 
+            "Forwarded cancel of task " + std::to_string(task_id) +
+            " to node " + std::to_string(forwarded_to));
+    }
+}
+
+bool PeerNode::isDeadLocked(const Task& task) const {
+    if (tombstones_.count(task.getId()) > 0) {
+        return true;
+    }
+    return config_.drop_expired_tasks && task.isExpired(std::chrono::steady_clock::now());
+}
+
+bool PeerNode::reapLocked(const Task& task, bool& expired) {
+    if (tombstones_.erase(task.getId()) > 0) {
+        expired = false;
+        return true;
+    }
+    expired = config_.drop_expired_tasks && task.isExpired(std::chrono::steady_clock::now());
+    return expired;
+}
+
+void PeerNode::recordDiscard(const Task& task, bool expired) {
+    countShed(task);
+    if (metrics_) {
+        metrics_->recordDiscarded(expired, task.getRemainingWork());
+    }
+    Logger::getInstance().logNodeEvent(id_, 
+        (expired ? "Dropped expired task " : "Dropped cancelled task ") +
+        std::to_string(task.getId()));
+}
+
+void PeerNode::rememberForward(int task_id, int peer_id) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    forwarded_to_[task_id] = {peer_id, std::chrono::steady_clock::now()};
+    if (journal_) {
+        JournalRecord record;
+        record.type = JournalRecordType::TRANSFER;
+        record.task_id = task_id;
+        record.peer = peer_id;
+        journal_->append(record);
+    }
+}
+
+void PeerNode::purgeCancellations() {
+    auto cutoff = std::chrono::steady_clock::now() - CANCEL_STATE_TTL;
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    for (auto it = tombstones_.begin(); it != tombstones_.end();) {
+        it = it->second < cutoff ? tombstones_.erase(it) : std::next(it);
+    }
+    for (auto it = forwarded_to_.begin(); it != forwarded_to_.end();) {
+        it = it->second.second < cutoff ? forwarded_to_.erase(it) : std::next(it);
+    }
+}
+
+bool PeerNode::absorbDuplicateLocked(const std::shared_ptr<Task>& task, bool& cache_hit) {
+    uint64_t key = task->getContentKey();
+    if (key == 0) {
+        return false;
+    }
+    auto group = coalesced_.find(key);
+    if (group != coalesced_.end() && group->second.leader_id == task->getId()) {
+        return false;  // A leader being requeued: its followers wait on it
+    }
     
-    for (const auto& [peer_id, load] : peer_loads_) {
-        if (load < min_load) {
-            min_load = load;
-            best_peer = peer_id;
-        }
+    auto cached = result_cache_.find(key);
+    if (cached != result_cache_.end()) {
+        cache_lru_.splice(cache_lru_.begin(), cache_lru_, cached->second);
+        cache_hit = true;
+        return true;
     }
     
-    return best_peer;
+    if (group != coalesced_.end()) {
+        group->second.followers.push_back(task);  // Only exists with coalesce_duplicates
+        cache_hit = false;
+        return true;
+    }
+    return false;
+}
+
+void PeerNode::completeAbsorbed(const std::shared_ptr<Task>& task, bool cache_hit) {
+    countCompleted(*task);
+    if (metrics_) {
+        metrics_->recordCompletion(task->getCreationTime(), task->getComplexity());
+        metrics_->recordDeduplicated(cache_hit, task->getComplexity());
+    }
+    acknowledgeCompletion(task);
+    Logger::getInstance().logNodeEvent(id_, 
+        "Completed task " + std::to_string(task->getId()) +
+        (cache_hit ? " from result cache" : " with an identical task"));
+}
+
+void PeerNode::completeDuplicates(const Task& task) {
+    uint64_t key = task.getContentKey();
+    if (key == 0) {
+        return;
+    }
+    
+    std::vector<std::shared_ptr<Task>> followers;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        auto group = coalesced_.find(key);
+        if (group != coalesced_.end() && group->second.leader_id == task.getId()) {
+            followers = std::move(group->second.followers);
+            coalesced_.erase(group);
+        }
+        
+        if (config_.result_cache_size > 0 && result_cache_.count(key) == 0) {
+            cache_lru_.push_front(key);
+            result_cache_[key] = cache_lru_.begin();
+            if (static_cast<int>(cache_lru_.size()) > config_.result_cache_size) {
+                result_cache_.erase(cache_lru_.back());
+                cache_lru_.pop_back();
+            }
+            if (config_.cache_hints) {
+                unadvertised_keys_.push_back(key);
+            }
+        }
+    }
+    
+    for (const auto& follower : followers) {
+        completeAbsorbed(follower, false);
+    }
+}
+
+void PeerNode::releaseFollowers(const Task& task) {
+    uint64_t key = task.getContentKey();
+    if (key == 0 || !config_.coalesce_duplicates) {
+        return;
+    }
+    
+    std::vector<std::shared_ptr<Task>> followers;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        auto group = coalesced_.find(key);
+        if (group == coalesced_.end() || group->second.leader_id != task.getId()) {
+            return;
+        }
+        followers = std::move(group->second.followers);
+        coalesced_.erase(group);
+    }
+    
+    for (auto& follower : followers) {
+        enqueueTask(follower);  // First one leads, the rest attach to it again
+    }
+}
+
+bool PeerNode::routeToCacheHolder(std::shared_ptr<Task> task) {
+    int holder = -1;
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        auto hint = key_hints_.find(task->getContentKey());
+        if (hint != key_hints_.end()) {
+            holder = hint->second.first;
+        }
+    }
+    if (holder < 0 || !network_manager_ || !consumeCredit(holder)) {
+        return false;
+    }
+    
+    task->recordMigration(id_);
+    Message transfer_msg(MessageType::TASK_TRANSFER, id_, holder);
+    transfer_msg.setTask(task);
+    stampLoadHeader(transfer_msg);
+    if (!sendTasks(transfer_msg)) {
+        return false;
+    }
+    
+    recordOutstanding(holder, task->getId());
+    rememberForward(task->getId(), holder);
+    if (metrics_) {
+        metrics_->recordHintRouted();
+    }
+    Logger::getInstance().logNodeEvent(id_, 
+        "Routed task " + std::to_string(task->getId()) +
+        " to node " + std::to_string(holder) + " (cached result)");
+    return true;
+}
+
+void PeerNode::sendCacheHints() {
+    if (!config_.cache_hints || !network_manager_) {
+        return;
+    }
+    
+    std::vector<uint64_t> keys;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        keys.swap(unadvertised_keys_);
+    }
+    if (keys.empty()) {
+        return;
+    }
+    
+    Message hint_msg(MessageType::CACHE_HINT, id_, -1);
+    hint_msg.setPayload(GossipDigest::encodeKeys(std::move(keys)));
+    stampLoadHeader(hint_msg);
+    network_manager_->broadcastMessage(id_, hint_msg);
+}
+
+void PeerNode::handleCacheHint(const Message& message) {
+    // Enough to remember every peer's whole cache
+    size_t limit = static_cast<size_t>(std::max(1, config_.result_cache_size)) *
+                   std::max<size_t>(1, getPeers().size());
+    
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    for (uint64_t key : GossipDigest::decodeKeys(message.getPayload())) {
+        long seq = key_hint_seq_++;
+        key_hints_[key] = {message.getSenderId(), seq};
+        key_hint_order_.push_back({key, seq});
+    }
+    while (key_hint_order_.size() > limit) {
+        auto [key, seq] = key_hint_order_.front();
+        key_hint_order_.pop_front();
+        auto hint = key_hints_.find(key);
+        if (hint != key_hints_.end() && hint->second.second == seq) {
+            key_hints_.erase(hint);
+        }
+    }
+}
+
+void PeerNode::acknowledgeCompletion(const std::shared_ptr<Task>& task) {
+    bool wanted = config_.robust_routing || config_.routing_policy == RoutingPolicy::BANDIT;
+    if (wanted && task->getLastSender() >= 0 && network_manager_) {
+        Message ack(MessageType::TASK_COMPLETE, id_, task->getLastSender());
+        ack.setTask(task);
+        stampLoadHeader(ack);
+        network_manager_->sendMessage(ack);
+    }
+}
+
+void PeerNode::notifySuccessors(const std::shared_ptr<Task>& task) {
+    std::vector<int> homes;
+    for (const auto& [successor_id, home] : task->getSuccessors()) {
+        if (std::find(homes.begin(), homes.end(), home) == homes.end()) {
+            homes.push_back(home);
+        }
+    }
+    
+    for (int home : homes) {
+        if (home == id_ || !network_manager_) {
+            resolveDependency(*task, id_);
+            continue;
+        }
+        Message resolved(MessageType::DEPENDENCY_RESOLVED, id_, home);
+        resolved.setTask(task);
+        stampLoadHeader(resolved);
+        network_manager_->sendMessage(resolved);
+    }
+}
+
+void PeerNode::resolveDependency(const Task& predecessor, int executed_on) {
+    std::vector<std::shared_ptr<Task>> released;
+    {
+        std::lock_guard<std::mutex> lock(dag_mutex_);
+        auto waiting = waiting_on_.find(predecessor.getId());
+        if (waiting == waiting_on_.end()) {
+            return;  // Successors homed elsewhere
+        }
+        for (int successor_id : waiting->second) {
+            auto parked = parked_.find(successor_id);
+            if (parked == parked_.end()) {
+                continue;
+            }
+            parked->second.task->addInputNode(executed_on);
+            if (--parked->second.pending == 0) {
+                released.push_back(parked->second.task);
+                parked_.erase(parked);
+            }
+        }
+        waiting_on_.erase(waiting);
+    }
+    
+    for (auto& task : released) {
+        placeReleasedTask(task);
+    }
+}
+
+void PeerNode::placeReleasedTask(std::shared_ptr<Task> task) {
+    // Released tasks go through the balancer right away rather than waiting
+    // for the next overload check; with dag_locality its cost includes
+    // pulling the task's inputs to each candidate node
+    int target = network_manager_ ? selectBestPeer(task) : -1;
+    if (target >= 0 && consumeCredit(target)) {
+        task->recordMigration(id_);
+        Message transfer_msg(MessageType::TASK_TRANSFER, id_, target);
+        transfer_msg.setTask(task);
+        stampLoadHeader(transfer_msg);
+        if (sendTasks(transfer_msg)) {
+            recordOutstanding(target, task->getId());
+            rememberForward(task->getId(), target);
+            {
+                // Siblings are usually released together; count this one
+                // against the target so they do not all pick the same peer
+                std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+                peer_loads_[target].load++;
+            }
+            Logger::getInstance().logNodeEvent(id_, 
+                "Released task " + std::to_string(task->getId()) +
+                " to node " + std::to_string(target));
+            return;
+        }
+    }
+    
+    enqueueTask(task);
+    Logger::getInstance().logNodeEvent(id_, 
+        "Released task " + std::to_string(task->getId()) + " locally");
+}
+
+bool PeerNode::redirectTask(std::shared_ptr<Task> task) {
+    int best_peer = -1;
+    if (task->getMigrationCount() < config_.max_redirects) {
+        best_peer = selectBestPeer(task);
+    }
+    
+    if (best_peer == -1 || !network_manager_ || !consumeCredit(best_peer)) {
+        countShed(*task);
+        if (metrics_) {
+            metrics_->recordOverflowReject();
+        }
+        Logger::getInstance().logNodeEvent(id_, 
+            "Queue full and no peer to redirect to, rejected task " + 
+            std::to_string(task->getId()));
+        return false;
+    }
+    
+    task->recordMigration(id_);
+    Message transfer_msg(MessageType::TASK_TRANSFER, id_, best_peer);
+    transfer_msg.setTask(task);
+    stampLoadHeader(transfer_msg);
+    if (!sendTasks(transfer_msg)) {
+        countShed(*task);
+        if (metrics_) {
+            metrics_->recordOverflowReject();
+        }
+        Logger::getInstance().logNodeEvent(id_, 
+            "Queue full and redirect dropped by network, rejected task " + 
+            std::to_string(task->getId()));
+        return false;
+    }
+    
+    recordOutstanding(best_peer, task->getId());
+    rememberForward(task->getId(), best_peer);
+    recordBanditDecision(task->getId(), best_peer);
+    releaseFollowers(*task);
+    if (metrics_) {
+        metrics_->recordRedirect();
+    }
+    Logger::getInstance().logNodeEvent(id_, 
+        "Queue full, redirected task " + std::to_string(task->getId()) +
+        " to node " + std::to_string(best_peer));
+    return true;
+}
+
+bool PeerNode::admitTask() {
+    if (config_.drf_balancing && config_.admission_max_dominant_pressure > 0.0) {
+        ResourceVector own = getResourcePressure();
+        double total = *std::max_element(own.begin(), own.end());
+        size_t known_nodes = 1;
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        for (const auto& [peer_id, entry] : peer_loads_) {
+            if (entry.pressure_version >= 0) {
+                total += *std::max_element(entry.pressure.begin(), entry.pressure.end());
+                known_nodes++;
+            }
+        }
+        return total / known_nodes < config_.admission_max_dominant_pressure;
+    }
+    
+    if (config_.admission_max_avg_load <= 0.0) {
+        return true;
+    }
+    
+    long total_load = getCurrentLoad();
+    size_t known_nodes = 1;
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        for (const auto& [peer_id, entry] : peer_loads_) {
+            total_load += entry.load;
+        }
+        known_nodes += peer_loads_.size();
+    }
+    
+    double avg_load = static_cast<double>(total_load) / known_nodes;
+    return avg_load < config_.admission_max_avg_load;
+}
+
+bool PeerNode::isQueueFull() const {
+    return config_.queue_capacity > 0 &&
+           queued_tasks_ >= config_.queue_capacity;
+}
+
+void PeerNode::pushTask(std::shared_ptr<Task> task) {
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        queued_demand_[r] += task->getDemand()[r];
+    }
+    if (config_.coalesce_duplicates && task->getContentKey() != 0) {
+        // First copy here leads; no-op for a requeued leader
+        coalesced_.try_emplace(task->getContentKey(), CoalescedGroup{task->getId(), {}});
+    }
+    if (config_.buddy_replication) {
+        queued_by_id_[task->getId()] = task;
+    }
+    if (journal_) {
+        JournalRecord record;
+        record.type = JournalRecordType::ENQUEUE;
+        record.task_id = task->getId();
+        record.work_ms = task->getRemainingWork();
+        record.content_key = task->getContentKey();
+        record.demand = task->getDemand();
+        record.created_us = toJournalTime(task->getCreationTime());
+        if (task->hasDeadline()) {
+            record.deadline_us = toJournalTime(task->getDeadline());
+        }
+        journal_->append(record);
+    }
+    size_t level = std::min<size_t>(task->getPriorityLevel(), task_queues_.size() - 1);
+    task_queues_[level].push(std::move(task));
+    queued_tasks_++;
+}
+
+std::shared_ptr<Task> PeerNode::popTask() {
+    for (auto& level : task_queues_) {
+        if (!level.empty()) {
+            std::shared_ptr<Task> task = level.front();
+            level.pop();
+            queued_tasks_--;
+            for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+                queued_demand_[r] -= task->getDemand()[r];
+            }
+            queued_by_id_.erase(task->getId());
+            if (journal_) {
+                JournalRecord record;
+                record.type = JournalRecordType::DEQUEUE;
+                record.task_id = task->getId();
+                journal_->append(record);
+            }
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void PeerNode::boostPriorities() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    for (size_t level = 1; level < task_queues_.size(); ++level) {
+        auto& queue = task_queues_[level];
+        while (!queue.empty()) {
+            queue.front()->resetPriority();
+            task_queues_[0].push(std::move(queue.front()));
+            queue.pop();
+        }
+    }
+}
+
+const std::shared_ptr<Task>& PeerNode::peekTaskLocked() const {
+    for (const auto& level : task_queues_) {
+        if (!level.empty()) {
+            return level.front();
+        }
+    }
+    static const std::shared_ptr<Task> none;
+    return none;
+}
+
+bool PeerNode::fitsLocked(const Task& task) const {
+    bool idle = true;
+    bool fits = true;
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        if (in_use_[r] > 1e-9) {
+            idle = false;
+        }
+        if (capacity_[r] > 0.0 && in_use_[r] + task.getDemand()[r] > capacity_[r] + 1e-9) {
+            fits = false;
+        }
+    }
+    return fits || idle;
+}
+
+ResourceVector PeerNode::pressureLocked() const {
+    ResourceVector pressure{};
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        if (capacity_[r] > 0.0) {
+            pressure[r] = (in_use_[r] + queued_demand_[r]) / capacity_[r];
+        }
+    }
+    return pressure;
+}
+
+ResourceVector PeerNode::getResourcePressure() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return pressureLocked();
+}
+
+ResourceVector PeerNode::getResourceUtilization() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    ResourceVector utilization{};
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        if (capacity_[r] > 0.0) {
+            utilization[r] = std::min(1.0, in_use_[r] / capacity_[r]);
+        }
+    }
+    return utilization;
+}
+
+double PeerNode::getAwakeSeconds() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    double seconds = awake_seconds_;
+    if (!dormant_) {
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - awake_since_).count();
+    }
+    return seconds;
+}
+
+double PeerNode::dominantPressure(const ResourceVector& pressure, const ResourceVector& demand) {
+    double dominant = 0.0;
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        if (demand[r] > 0.0) {
+            dominant = std::max(dominant, pressure[r]);
+        }
+    }
+    return dominant;
+}
+
+int PeerNode::getCurrentLoad() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return queued_tasks_;
+}
+
+int PeerNode::getTasksInSystem() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return queued_tasks_ + running_tasks_;
+}
+
+double PeerNode::getPeerTrust(int peer_id) const {
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    auto trust = peer_trust_.find(peer_id);
+    return trust != peer_trust_.end() ? trust->second.trust : 1.0;
+}
+
+int PeerNode::getRunningTasks() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return running_tasks_;
+}
+
+int PeerNode::getTasksProcessed() const {
+    return tasks_processed_.load();
+}
+
+void PeerNode::setAudit(TaskAudit* audit) {
+    audit_ = audit;
+}
+
+std::vector<int> PeerNode::getHeldTaskIds() const {
+    std::vector<int> ids;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        for (auto queue : task_queues_) {
+            for (; !queue.empty(); queue.pop()) {
+                ids.push_back(queue.front()->getId());
+            }
+        }
+        for (const auto& [key, group] : coalesced_) {
+            for (const auto& follower : group.followers) {
+                ids.push_back(follower->getId());
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(dag_mutex_);
+    for (const auto& [task_id, parked] : parked_) {
+        ids.push_back(task_id);
+    }
+    return ids;
+}
+
+void PeerNode::handleMessage(const Message& message) {
+    if (crashed_) {
+        countReceived(message);
+        countFinished(tasksCarried(message));
+        for (int i = tasksCarried(message); i > 0 && metrics_; --i) {
+            metrics_->recordLostTask();
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(message_mutex_);
+        message_queue_.push(message);
+    }
+    message_cv_.notify_one();
+}
+
+void PeerNode::addPeer(int peer_id) {
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    if (std::find(peers_.begin(), peers_.end(), peer_id) == peers_.end()) {
+        peers_.push_back(peer_id);
+        Logger::getInstance().logNodeEvent(id_, 
+            "Added peer " + std::to_string(peer_id));
+    }
+}
+
+std::vector<int> PeerNode::getPeers() const {
+    std::lock_guard<std::mutex> lock(peers_mutex_);
+    return peers_;
+}
+
+int PeerNode::getId() const {
+    return id_;
+}
+
+const NodeConfig& PeerNode::getConfig() const {
+    return config_;
+}
+
+// Worker thread: processes tasks from the queue
+void PeerNode::workerLoop() {
+    while (running_) {
+        std::shared_ptr<Task> task;
+        bool dead = false;
+        bool expired = false;
+        std::chrono::steady_clock::time_point resume_at;
+        
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            // Head-of-line task must also fit the free resources (always
+            // true unless memory/io capacities are modelled), or be dead:
+            // cancelled/expired tasks are discarded without running
+            queue_cv_.wait(lock, [this] { 
+                return (queued_tasks_ > 0 && (fitsLocked(*peekTaskLocked()) ||
+                                              isDeadLocked(*peekTaskLocked()))) ||
+                       !running_; 
+            });
+            
+            if (!running_ && queued_tasks_ == 0) {
+                break;
+            }
+            
+            if (queued_tasks_ > 0) {
+                task = popTask();
+                if (reapLocked(*task, expired)) {
+                    dead = true;
+                } else {
+                    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+                        in_use_[r] += task->getDemand()[r];
+                    }
+                    running_tasks_++;
+                    if (dormant_) {
+                        wakeLocked("work arrived");
+                    }
+                    resume_at = wake_ready_at_;
+                }
+            }
+        }
+        space_cv_.notify_one();
+        std::this_thread::sleep_until(resume_at);  // Past unless just woken
+        
+        if (dead) {
+            recordDiscard(*task, expired);
+            releaseFollowers(*task);  // Identical requests were not cancelled
+            queue_cv_.notify_all();  // The next head may fit now
+            continue;
+        }
+        
+        if (task) {
+            Logger::getInstance().logNodeEvent(id_, 
+                "Processing task " + std::to_string(task->getId()));
+            
+            int fetch_ms = task->fetchInputs(id_);  // DAG inputs produced elsewhere (first run only)
+            if (fetch_ms > 0 && metrics_) {
+                metrics_->recordInputFetch(fetch_ms);
+            }
+            
+            auto exec_start = std::chrono::steady_clock::now();
+            if (config_.time_slice_ms > 0) {
+                // MLFQ: quantum doubles per level, so long tasks switch less often
+                int level = config_.mlfq ? task->getPriorityLevel() : 0;
+                task->executeSlice(config_.time_slice_ms << std::min(level, 16));
+            } else {
+                task->execute();
+            }
+            double service_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - exec_start).count();
+            
+            bool preempted = !task->isFinished();
+            bool lost = crashed_;
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+                    in_use_[r] -= task->getDemand()[r];
+                }
+                running_tasks_--;
+                if (preempted && !lost) {
+                    if (config_.mlfq && task->getPriorityLevel() + 1 < config_.mlfq_levels) {
+                        task->demote();
+                    }
+                    pushTask(task);  // Back of its level; may also be offloaded from there
+                }
+            }
+            queue_cv_.notify_all();  // Freed resources may unblock the head task
+            if (lost) {
+                countFinished(1);
+                if (metrics_) {
+                    metrics_->recordLostTask();  // Crashed while it ran
+                }
+                continue;
+            }
+            if (preempted) {
+                continue;
+            }
+            tasks_processed_++;
+            countCompleted(*task);
+            
+            // EWMA (alpha = 1/8, as in TCP's RTT estimator); racy updates
+            // between workers only lose a sample, which is harmless here.
+            // Time-sliced tasks ran in pieces, so use their total work.
+            if (config_.time_slice_ms > 0) {
+                service_ms = task->getComplexity();
+            }
+            double avg = avg_service_ms_.load();
+            avg_service_ms_ = avg == 0.0 ? service_ms : avg + (service_ms - avg) / 8.0;
+            if (metrics_) {
+                metrics_->recordCompletion(task->getCreationTime(), task->getComplexity());
+                if (task->isExpired(std::chrono::steady_clock::now())) {
+                    metrics_->recordLateCompletion(task->getComplexity());
+                }
+                if (task->getCriticalPath() > 0) {
+                    metrics_->recordJobCompletion(task->getCreationTime(), task->getCriticalPath());
+                }
+            }
+            completeDuplicates(*task);
+            notifySuccessors(task);
+            acknowledgeCompletion(task);
+            
+            Logger::getInstance().logNodeEvent(id_, 
+                "Completed task " + std::to_string(task->getId()) +
+                " (total processed: " + std::to_string(tasks_processed_.load()) + ")");
+        }
+    }
+}
+
+// Load monitor thread: periodically checks load and sends updates
+void PeerNode::loadMonitorLoop() {
+    while (running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::max(1, config_.load_tick_ms)));
+        
+        if (!running_) break;
+        if (crashed_) continue;
+        
+        int current_load = getCurrentLoad();
+        
+        // Log metrics periodically
+        Logger::getInstance().logMetrics(id_, current_load, tasks_processed_);
+        
+        if (config_.buddy_replication) {
+            detectFailures();
+        }
+        if (config_.mlfq && config_.mlfq_boost_ms > 0) {
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_boost_ >= std::chrono::milliseconds(config_.mlfq_boost_ms)) {
+                last_boost_ = now;
+                boostPriorities();
+            }
+        }
+        if (config_.consolidation && maybePark()) {
+            dormantTick();
+            continue;
+        }
+        
+        // Broadcast load update to all peers
+        sendLoadUpdate(current_load);
+        sendCacheHints();
+        purgeCancellations();
+        expireBanditFeedback();
+        raiseSos(true);
+        
+        if (config_.balancing_scheme == BalancingScheme::DIFFUSION) {
+            diffuseLoad(current_load);
+            continue;
+        }
+        if (config_.balancing_scheme == BalancingScheme::DIMENSION_EXCHANGE) {
+            sendExchangeOffer(current_load);
+            continue;
+        }
+        
+        // If load exceeds threshold, try to offload a batch of tasks
+        for (int sent = 0; sent < config_.migration_batch_size; ++sent) {
+            std::shared_ptr<Task> task;
+            bool dead = false;
+            bool expired = false;
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                if (queued_tasks_ > config_.load_threshold) {
+                    task = popTask();
+                    dead = reapLocked(*task, expired);
+                }
+            }
+            
+            if (!task) {
+                break;
+            }
+            space_cv_.notify_one();
+            if (dead) {
+                recordDiscard(*task, expired);  // Not worth a transfer
+                releaseFollowers(*task);
+                continue;
+            }
+            
+            if (!offloadTask(task)) {
+                break;  // No peer can take more right now
+            }
+        }
+    }
+}
+
+void PeerNode::sendLoadUpdate(int current_load) {
+    if (!network_manager_) {
+        return;
+    }
+    
+    int buddy = config_.buddy_replication ? currentBuddy() : -1;
+    if (config_.gossip_mode == GossipMode::DIGEST) {
+        std::vector<int> peers = getPeers();
+        std::shuffle(peers.begin(), peers.end(), gossip_rng_);
+        
+        bool full_sync = config_.digest_full_sync_rounds > 0 &&
+                         digest_round_ % config_.digest_full_sync_rounds == 0;
+        int fanout = std::min<int>(config_.gossip_fanout, peers.size());
+        for (int i = 0; i < fanout; ++i) {
+            sendDigest(peers[i], MessageType::GOSSIP_DIGEST, full_sync);
+        }
+        digest_round_++;
+        if (buddy != -1) {
+            // Digests reach the buddy only now and then; it gets its own update
+            Message buddy_msg(MessageType::LOAD_UPDATE, id_, buddy);
+            buddy_msg.setLoadValue(stampLoadHeader(buddy_msg));
+            attachReplicaDelta(buddy_msg);
+            network_manager_->sendMessage(buddy_msg);
+        }
+        return;
+    }
+    
+    if (!config_.credit_flow_control) {
+        Message load_msg(MessageType::LOAD_UPDATE, id_, -1);  // -1 means broadcast
+        load_msg.setLoadValue(stampLoadHeader(load_msg));
+        if (buddy != -1) {
+            Message buddy_msg(MessageType::LOAD_UPDATE, id_, buddy);
+            buddy_msg.setLoadValue(stampLoadHeader(buddy_msg));
+            attachReplicaDelta(buddy_msg);
+            network_manager_->sendMessage(buddy_msg);
+        }
+        network_manager_->broadcastMessage(id_, load_msg, buddy);
+        return;
+    }
+    
+    // One LOAD_UPDATE per link so each peer gets its own credit grant
+    std::vector<int> peers = getPeers();
+    if (peers.empty()) {
+        return;
+    }
+    
+    int free_slots = freeTransferSlots(current_load);
+    int n = static_cast<int>(peers.size());
+    int base = free_slots / n;
+    int remainder = free_slots % n;
+    
+    for (int i = 0; i < n; ++i) {
+        // Peers at positions [credit_round_, credit_round_ + remainder) get one extra
+        int offset = (i - credit_round_ % n + n) % n;
+        int grant = base + (offset < remainder ? 1 : 0);
+        
+        Message load_msg(MessageType::LOAD_UPDATE, id_, peers[i]);
+        load_msg.setLoadValue(stampLoadHeader(load_msg));
+        load_msg.setCredits(grant);
+        if (peers[i] == buddy) {
+            attachReplicaDelta(load_msg);
+        }
+        network_manager_->sendMessage(load_msg);
+    }
+    credit_round_++;
+}
+
+int PeerNode::freeTransferSlots(int current_load) const {
+    int target = config_.queue_capacity > 0 ? config_.queue_capacity : config_.load_threshold;
+    double avg_service = avg_service_ms_.load();
+    int expected_drain = avg_service > 0.0
+        ? static_cast<int>(config_.num_workers * static_cast<double>(config_.load_tick_ms) / avg_service)
+        : 0;
+    return std::max(0, target - current_load + expected_drain);
+}
+
+void PeerNode::sendDigest(int peer_id, MessageType type, bool full_sync) {
+    Message digest_msg(type, id_, peer_id);
+    int self_load = stampLoadHeader(digest_msg);
+    long self_version = digest_msg.getSenderLoadVersion();
+    
+    std::vector<DigestEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        std::map<int, long>& known = digest_sent_[peer_id];
+        
+        auto now = std::chrono::steady_clock::now();
+        auto consider = [&](int node_id, long version, int load, int age_ms) {
+            if (node_id == peer_id || version < 0) {
+                return;
+            }
+            auto it = known.find(node_id);
+            if (!full_sync && it != known.end() && it->second >= version) {
+                return;  // Peer already has this version
+            }
+            entries.push_back({node_id, version, load, age_ms});
+            known[node_id] = version;
+        };
+        
+        consider(id_, self_version, self_load, 0);
+        for (const auto& [node_id, entry] : peer_loads_) {
+            int age_ms = static_cast<int>(std::max<long long>(0,
+                std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.sampled).count()));
+            consider(node_id, entry.version, entry.load, age_ms);
+        }
+    }
+    
+    if (config_.credit_flow_control) {
+        // Digest goes to one peer at a time: grant it its even share
+        int peers = std::max<size_t>(1, getPeers().size());
+        digest_msg.setCredits(freeTransferSlots(self_load) / peers);
+    }
+    
+    digest_msg.setPayload(GossipDigest::encode(std::move(entries)));
+    if (!network_manager_->sendMessage(digest_msg)) {
+        // Peer never saw these entries: forget what we think it has
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        digest_sent_.erase(peer_id);
+    }
+}
+
+void PeerNode::handleDigest(const Message& message) {
+    int sender_id = message.getSenderId();
+    std::vector<DigestEntry> entries = GossipDigest::decode(message.getPayload());
+    
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        std::map<int, long>& known = digest_sent_[sender_id];
+        for (const auto& entry : entries) {
+            if (entry.node_id != id_) {
+                updatePeerView(entry.node_id, entry.load, entry.version, entry.age_ms, false);
+            }
+            // The sender holds this version: never echo it back
+            long& sender_version = known[entry.node_id];
+            sender_version = std::max(sender_version, entry.version);
+        }
+        if (config_.credit_flow_control) {
+            peer_credits_[sender_id] = message.getCredits();
+        }
+    }
+    
+    if (message.getType() == MessageType::GOSSIP_DIGEST && network_manager_) {
+        sendDigest(sender_id, MessageType::GOSSIP_DIGEST_REPLY, false);
+    }
+}
+
+int PeerNode::stampLoadHeader(Message& message) {
+    int load;
+    long version;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        load = queued_tasks_;
+        version = ++lamport_clock_;
+        if (config_.drf_balancing) {
+            message.setResourceSummary(pressureLocked());
+        }
+        message.setSenderDormant(dormant_);
+    }
+    load = advertisedLoad(load, version);
+    message.setSenderLoad(load, version);
+    return load;
+}
+
+int PeerNode::advertisedLoad(int true_load, long version) const {
+    switch (config_.misbehavior) {
+        case Misbehavior::LIAR:
+        case Misbehavior::BLACK_HOLE:
+            return 0;
+        case Misbehavior::FLAPPER:
+            return version % 2 == 0 ? 0 : true_load;
+        case Misbehavior::NONE:
+            break;
+    }
+    return true_load;
+}
+
+void PeerNode::recordOutstanding(int peer_id, int task_id) {
+    if (!config_.robust_routing) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    peer_trust_[peer_id].outstanding[task_id] = std::chrono::steady_clock::now();
+}
+
+void PeerNode::checkPeerReport(int peer_id, int load, std::chrono::steady_clock::time_point sampled) {
+    PeerTrust& trust = peer_trust_[peer_id];
+    int landed = 0;
+    for (const auto& [task_id, sent] : trust.outstanding) {
+        if (sent + OUTSTANDING_GRACE < sampled) {
+            landed++;
+        }
+    }
+    if (load + config_.num_workers + 1 < landed) {
+        trust.trust *= TRUST_PENALTY;
+        Logger::getInstance().logNodeEvent(id_, 
+            "Node " + std::to_string(peer_id) + " advertises load " + std::to_string(load) +
+            " with " + std::to_string(landed) + " of our tasks outstanding, trust " +
+            std::to_string(trust.trust));
+    }
+}
+
+void PeerNode::observeLamport(long timestamp) {
+    long current = lamport_clock_.load();
+    while (current < timestamp &&
+           !lamport_clock_.compare_exchange_weak(current, timestamp)) {
+        // current reloaded by compare_exchange_weak; retry
+    }
+}
+
+bool PeerNode::updatePeerView(int peer_id, int load, long version, int age_ms,
+                              bool piggybacked) {
+    if (failed_peers_.count(peer_id) > 0) {
+        return false;  // Relayed news of a node we declared failed
+    }
+    PeerLoadEntry& entry = peer_loads_[peer_id];
+    if (version >= 0 && version <= entry.version) {
+        return false;  // Already hold this report or a newer one
+    }
+    
+    entry.load = load;
+    entry.version = version;
+    entry.sampled = std::chrono::steady_clock::now() - std::chrono::milliseconds(age_ms);
+    if (config_.robust_routing) {
+        checkPeerReport(peer_id, load, entry.sampled);
+    }
+    if (metrics_) {
+        metrics_->recordViewUpdate(piggybacked);
+    }
+    return true;
+}
+
+// Message processor thread: handles incoming messages
+void PeerNode::messageProcessorLoop() {
+    while (running_) {
+        Message message(MessageType::LOAD_UPDATE, -1, -1);
+        
+        {
+            std::unique_lock<std::mutex> lock(message_mutex_);
+            message_cv_.wait(lock, [this] { 
+                return !message_queue_.empty() || !running_; 
+            });
+            
+            if (!running_ && message_queue_.empty()) {
+                break;
+            }
+            
+            if (!message_queue_.empty()) {
+                message = message_queue_.front();
+                message_queue_.pop();
+            }
+        }
+        
+        countReceived(message);  // Before anything can forward its tasks again
+        
+        if (message.hasSenderLoad()) {
+            observeLamport(message.getSenderLoadVersion());
+        }
+        
+        if (config_.consolidation && message.hasSenderLoad()) {
+            std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+            auto entry = peer_loads_.find(message.getSenderId());
+            if (entry != peer_loads_.end()) {
+                entry->second.dormant = message.isSenderDormant();
+            }
+        }
+        
+        if (message.hasResourceSummary()) {
+            std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+            PeerLoadEntry& entry = peer_loads_[message.getSenderId()];
+            if (message.getSenderLoadVersion() > entry.pressure_version) {
+                entry.pressure = message.getResourceSummary();
+                entry.pressure_version = message.getSenderLoadVersion();
+            }
+        }
+        
+        // Any message refreshes our view of its sender (header piggyback)
+        if (config_.piggyback_load && message.hasSenderLoad() &&
+            message.getType() != MessageType::LOAD_UPDATE) {
+            std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+            updatePeerView(message.getSenderId(), message.getSenderLoad(),
+                           message.getSenderLoadVersion(), 0, true);
+        }
+        
+        // Process message based on type
+        switch (message.getType()) {
+            case MessageType::LOAD_UPDATE: {
+                int peer_id = message.getSenderId();
+                int load = message.getLoadValue();
+                bool readmitted;
+                
+                {
+                    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+                    // Heard from it directly: it was slow or has restarted
+                    readmitted = failed_peers_.erase(peer_id) > 0;
+                    updatePeerView(peer_id, load, message.getSenderLoadVersion(), 0, false);
+                    if (config_.credit_flow_control) {
+                        peer_credits_[peer_id] = message.getCredits();
+                    }
+                    if (!message.getTasks().empty() || !message.getPayload().empty()) {
+                        applyReplicaDeltaLocked(message);
+                    }
+                }
+                if (readmitted) {
+                    addPeer(peer_id);
+                    Logger::getInstance().logNodeEvent(id_, 
+                        "Node " + std::to_string(peer_id) + " is back, readmitted");
+                    withdrawRecovered(peer_id);
+                }
+                
+                Logger::getInstance().logNodeEvent(id_, 
+                    "Received load update from node " + std::to_string(peer_id) +
+                    ": load=" + std::to_string(load));
+                break;
+            }
+            
+            case MessageType::TASK_TRANSFER: {
+                auto task = message.getTask();
+                if (task) {
+                    acceptTransferredTask(task, message.getSenderId());
+                }
+                break;
+            }
+            
+            case MessageType::TASK_BATCH: {
+                for (const auto& task : message.getTasks()) {
+                    acceptTransferredTask(task, message.getSenderId());
+                }
+                handleStealReply(message);
+                break;
+            }
+            
+            case MessageType::TASK_REQUEST: {
+                handleTaskRequest(message);
+                break;
+            }
+            
+            case MessageType::HELP_WANTED: {
+                handleHelpWanted(message);
+                break;
+            }
+            
+            case MessageType::EXCHANGE_OFFER: {
+                handleExchangeOffer(message);
+                break;
+            }
+            
+            case MessageType::PEER_DISCOVERY: {
+                addPeer(message.getSenderId());
+                break;
+            }
+            
+            case MessageType::DEPENDENCY_RESOLVED: {
+                auto task = message.getTask();
+                if (task) {
+                    resolveDependency(*task, message.getSenderId());
+                }
+                break;
+            }
+            
+            case MessageType::TASK_CANCEL: {
+                cancelTask(message.getTaskId());
+                break;
+            }
+            
+            case MessageType::CACHE_HINT: {
+                handleCacheHint(message);
+                break;
+            }
+            
+            case MessageType::TASK_COMPLETE: {
+                std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+                auto pending = pending_feedback_.find(message.getTaskId());
+                if (pending != pending_feedback_.end()) {
+                    double completion_s = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - pending->second.sent).count();
+                    applyBanditFeedbackLocked(message.getTaskId(), completion_s, true);
+                }
+                PeerTrust& trust = peer_trust_[message.getSenderId()];
+                if (trust.outstanding.erase(message.getTaskId()) > 0) {
+                    trust.trust += TRUST_REWARD * (1.0 - trust.trust);
+                }
+                break;
+            }
+            
+            case MessageType::TASK_WITHDRAW: {
+                handleWithdraw(message);
+                break;
+            }
+            
+            case MessageType::TASK_RELEASED: {
+                // Passed on or shed: no longer held there, but not run either
+                std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+                peer_trust_[message.getSenderId()].outstanding.erase(message.getTaskId());
+                break;
+            }
+            
+            case MessageType::GOSSIP_DIGEST:
+            case MessageType::GOSSIP_DIGEST_REPLY: {
+                handleDigest(message);
+                break;
+            }
+            
+            case MessageType::SNAPSHOT_MARKER: {
+                handleSnapshotMarker(message);
+                break;
+            }
+            
+            default:
+                break;
+        }
+    }
+}
+
+// Offload a task to the least-loaded peer
+bool PeerNode::offloadTask(std::shared_ptr<Task> task) {
+    int best_peer = selectBestPeer(task);
+    
+    if (best_peer != -1 && network_manager_ && consumeCredit(best_peer)) {
+        task->recordMigration(id_);
+        Message transfer_msg(MessageType::TASK_TRANSFER, id_, best_peer);
+        transfer_msg.setTask(task);
+        stampLoadHeader(transfer_msg);
+        if (sendTasks(transfer_msg)) {
+            recordOutstanding(best_peer, task->getId());
+            rememberForward(task->getId(), best_peer);
+            recordBanditDecision(task->getId(), best_peer);
+            releaseFollowers(*task);
+            Logger::getInstance().logNodeEvent(id_, 
+                "Offloaded task " + std::to_string(task->getId()) +
+                " to node " + std::to_string(best_peer));
+            return true;
+        }
+    }
+    
+    // No suitable peer (or transfer dropped), add back to own queue (slot was ours already)
+    enqueueTask(task);
+    return false;
+}
+
+int PeerNode::sendTaskBatch(int peer_id, int count) {
+    if (!network_manager_ || count <= 0) {
+        return 0;
+    }
+    
+    std::vector<std::shared_ptr<Task>> batch;
+    std::vector<std::pair<std::shared_ptr<Task>, bool>> dead;  // (task, expired)
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        while (static_cast<int>(batch.size()) < count && queued_tasks_ > 0) {
+            auto task = popTask();
+            bool expired = false;
+            if (reapLocked(*task, expired)) {
+                dead.push_back({task, expired});
+            } else {
+                batch.push_back(task);
+            }
+        }
+    }
+    space_cv_.notify_all();
+    for (const auto& [task, expired] : dead) {
+        recordDiscard(*task, expired);  // Not worth a transfer
+        releaseFollowers(*task);
+    }
+    if (batch.empty()) {
+        return 0;
+    }
+    
+    for (const auto& task : batch) {
+        task->recordMigration(id_);
+    }
+    Message batch_msg(MessageType::TASK_BATCH, id_, peer_id);
+    batch_msg.setTasks(batch);
+    stampLoadHeader(batch_msg);
+    if (!sendTasks(batch_msg)) {
+        for (const auto& task : batch) {
+            enqueueTask(task);
+        }
+        return 0;
+    }
+    
+    for (const auto& task : batch) {
+        recordOutstanding(peer_id, task->getId());
+        rememberForward(task->getId(), peer_id);
+        releaseFollowers(*task);
+    }
+    Logger::getInstance().logNodeEvent(id_, 
+        "Sent batch of " + std::to_string(batch.size()) +
+        " tasks to node " + std::to_string(peer_id));
+    return static_cast<int>(batch.size());
+}
+
+void PeerNode::diffuseLoad(int current_load) {
+    std::vector<int> neighbors = getPeers();  // Gossip may know more nodes than these
+    int degree = static_cast<int>(neighbors.size());
+    std::vector<std::pair<int, int>> shares;  // (peer, tasks)
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        for (int peer_id : neighbors) {
+            auto known = peer_loads_.find(peer_id);
+            if (known == peer_loads_.end()) {
+                continue;
+            }
+            PeerLoadEntry& entry = known->second;
+            int share = static_cast<int>(std::lround(
+                static_cast<double>(current_load - entry.load) / (degree + 1)));
+            if (share > 0) {
+                shares.push_back({peer_id, share});
+                entry.load += share;  // Until its next report
+            }
+        }
+    }
+    for (const auto& [peer_id, share] : shares) {
+        sendTaskBatch(peer_id, share);
+    }
+}
+
+void PeerNode::sendExchangeOffer(int current_load) {
+    std::vector<int> peers = getPeers();
+    int dimensions = 0;
+    while ((1 << dimensions) < static_cast<int>(peers.size()) + 1) {
+        dimensions++;
+    }
+    if (dimensions == 0 || !network_manager_) {
+        return;
+    }
+    
+    int partner = id_ ^ (1 << (balance_round_++ % dimensions));
+    if (std::find(peers.begin(), peers.end(), partner) == peers.end()) {
+        return;  // Incomplete hypercube: sit this round out
+    }
+    Message offer(MessageType::EXCHANGE_OFFER, id_, partner);
+    offer.setLoadValue(stampLoadHeader(offer));
+    network_manager_->sendMessage(offer);
+    
+    Logger::getInstance().logNodeEvent(id_, 
+        "Exchange offer to node " + std::to_string(partner) +
+        " (load " + std::to_string(current_load) + ")");
+}
+
+void PeerNode::handleExchangeOffer(const Message& message) {
+    // Both partners send an offer; only the heavier one acts on it, so a
+    // pair settles with one batch
+    int surplus = (getCurrentLoad() - message.getLoadValue()) / 2;
+    if (surplus > 0) {
+        sendTaskBatch(message.getSenderId(), surplus);
+    }
+}
+
+std::vector<int> PeerNode::pickRumorTargets(int exclude_a, int exclude_b) {
+    std::vector<int> peers = getPeers();
+    peers.erase(std::remove_if(peers.begin(), peers.end(), [&](int peer) {
+        return peer == exclude_a || peer == exclude_b;
+    }), peers.end());
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    std::shuffle(peers.begin(), peers.end(), rumor_rng_);
+    peers.resize(std::min<size_t>(peers.size(), std::max(0, config_.sos_fanout)));
+    return peers;
+}
+
+void PeerNode::raiseSos(bool periodic) {
+    if (config_.sos_watermark <= 0 || !network_manager_) {
+        return;
+    }
+    int load = getCurrentLoad();
+    int rumor_id;
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        if (load < config_.sos_watermark) {
+            sos_armed_ = true;
+            return;
+        }
+        if (periodic) {
+            long total_load = load;
+            for (const auto& [peer_id, entry] : peer_loads_) {
+                total_load += entry.load;
+            }
+            double mean_load = static_cast<double>(total_load) / (peer_loads_.size() + 1);
+            if (load - mean_load > config_.load_threshold) {
+                sos_armed_ = true;  // Still well above the cluster: ask again
+            }
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (!sos_armed_ || now - last_sos_ < SOS_MIN_INTERVAL) {
+            return;
+        }
+        sos_armed_ = false;
+        last_sos_ = now;
+        rumor_id = ++sos_id_;
+    }
+    
+    std::vector<int> targets = pickRumorTargets(id_, id_);
+    for (int peer : targets) {
+        Message rumor(MessageType::HELP_WANTED, id_, peer);
+        rumor.setRumor(id_, rumor_id, config_.sos_ttl);
+        rumor.setLoadValue(stampLoadHeader(rumor));
+        network_manager_->sendMessage(rumor);
+    }
+    if (metrics_) {
+        metrics_->recordSosRaised();
+        metrics_->recordRumorMessages(static_cast<int>(targets.size()));
+    }
+    Logger::getInstance().logNodeEvent(id_, 
+        "SOS " + std::to_string(rumor_id) + " at load " + std::to_string(load));
+}
+
+void PeerNode::handleHelpWanted(const Message& message) {
+    int origin = message.getRumorOrigin();
+    if (origin == id_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        int& seen = rumors_seen_[origin];
+        if (message.getRumorId() <= seen) {
+            return;  // Already relayed (rumors overlap once TTL > 1)
+        }
+        seen = message.getRumorId();
+        if (config_.consolidation) {
+            wake("SOS from node " + std::to_string(origin));  // Lock order: peer_loads, queue
+        }
+        HelpTarget& target = help_targets_[origin];
+        target.load = message.getLoadValue();
+        target.expires = std::chrono::steady_clock::now() + SOS_TARGET_TTL;
+    }
+    
+    if (message.getRumorTtl() > 1 && network_manager_) {
+        std::vector<int> targets = pickRumorTargets(origin, message.getSenderId());
+        for (int peer : targets) {
+            Message relay(MessageType::HELP_WANTED, id_, peer);
+            relay.setRumor(origin, message.getRumorId(), message.getRumorTtl() - 1);
+            relay.setLoadValue(message.getLoadValue());
+            stampLoadHeader(relay);
+            network_manager_->sendMessage(relay);
+        }
+        if (metrics_) {
+            metrics_->recordRumorMessages(static_cast<int>(targets.size()));
+        }
+    }
+    requestWork();
+}
+
+void PeerNode::requestWork() {
+    if ((config_.sos_watermark <= 0 && !config_.consolidation) || !network_manager_) {
+        return;
+    }
+    int load = getCurrentLoad();
+    int target_id = -1;
+    int wanted = 0;
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        if (steal_from_ != -1 && now - steal_sent_ < STEAL_TIMEOUT) {
+            return;  // One steal at a time; its reply calls us again
+        }
+        steal_from_ = -1;
+        int target_load = 0;
+        for (auto it = help_targets_.begin(); it != help_targets_.end();) {
+            if (it->second.expires < now) {
+                it = help_targets_.erase(it);
+                continue;
+            }
+            if (it->second.load - load > config_.load_threshold && it->second.load > target_load) {
+                target_id = it->first;
+                target_load = it->second.load;
+            }
+            ++it;
+        }
+        if (target_id == -1) {
+            return;
+        }
+        wanted = (target_load - load) / 2;
+        steal_from_ = target_id;
+        steal_sent_ = now;
+    }
+    
+    Message request(MessageType::TASK_REQUEST, id_, target_id);
+    request.setLoadValue(wanted);
+    stampLoadHeader(request);
+    network_manager_->sendMessage(request);  // Lost: retried after STEAL_TIMEOUT
+    if (metrics_) {
+        metrics_->recordStealRequest();
+    }
+}
+
+void PeerNode::handleTaskRequest(const Message& message) {
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        sos_armed_ = true;  // Someone can help: a later SOS may recruit more
+    }
+    int grant = std::min(message.getLoadValue(),
+                         (getCurrentLoad() - message.getSenderLoad()) / 2);
+    if (grant > 0 && sendTaskBatch(message.getSenderId(), grant) > 0) {
+        return;
+    }
+    if (network_manager_) {
+        Message none(MessageType::TASK_BATCH, id_, message.getSenderId());
+        stampLoadHeader(none);
+        network_manager_->sendMessage(none);
+    }
+}
+
+void PeerNode::handleStealReply(const Message& message) {
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        if (steal_from_ != message.getSenderId()) {
+            return;  // Diffusion or exchange batch, not a steal reply
+        }
+        steal_from_ = -1;
+        auto target = help_targets_.find(message.getSenderId());
+        if (target != help_targets_.end()) {
+            if (message.getTasks().empty()) {
+                help_targets_.erase(target);  // Nothing left to spare
+            } else {
+                target->second.load = message.getSenderLoad();
+                target->second.expires = std::chrono::steady_clock::now() + SOS_TARGET_TTL;
+            }
+        }
+    }
+    requestWork();
+    raiseSos(false);
+}
+
+int PeerNode::packingTarget() {
+    int target = -1;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!dormant_ && queued_tasks_ < config_.num_workers) {
+            target = id_;
+        }
+    }
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    for (const auto& [peer_id, entry] : peer_loads_) {
+        if (peer_id >= target && target != -1) {
+            break;  // Ordered by ID: nothing lower remains
+        }
+        if (!entry.dormant && entry.version >= 0 && entry.load < config_.num_workers) {
+            target = peer_id;
+            break;
+        }
+    }
+    return target;
+}
+
+bool PeerNode::maybePark() {
+    bool lower_awake = false;
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        for (const auto& [peer_id, entry] : peer_loads_) {
+            if (peer_id < id_ && !entry.dormant && entry.version >= 0) {
+                lower_awake = true;  // Someone keeps serving; node 0 never parks
+                break;
+            }
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (dormant_) {
+        return true;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (queued_tasks_ > 0 || in_use_[RESOURCE_CPU] > 0.0) {
+        idle_since_ = std::chrono::steady_clock::time_point();
+        return false;
+    }
+    if (idle_since_ == std::chrono::steady_clock::time_point()) {
+        idle_since_ = now;
+        return false;
+    }
+    if (!lower_awake || now - idle_since_ < std::chrono::milliseconds(config_.dormant_after_ms)) {
+        return false;
+    }
+    
+    dormant_ = true;
+    dormant_ticks_ = 0;
+    awake_seconds_ += std::chrono::duration<double>(now - awake_since_).count();
+    if (metrics_) {
+        metrics_->recordPark();
+    }
+    Logger::getInstance().logNodeEvent(id_, "Parking (idle)");
+    return true;
+}
+
+void PeerNode::wakeLocked(const std::string& reason) {
+    if (!dormant_) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    dormant_ = false;
+    idle_since_ = std::chrono::steady_clock::time_point();
+    awake_since_ = now;
+    wake_ready_at_ = now + std::chrono::milliseconds(config_.wake_latency_ms);
+    if (metrics_) {
+        metrics_->recordWake();
+    }
+    Logger::getInstance().logNodeEvent(id_, "Waking: " + reason);
+}
+
+void PeerNode::wake(const std::string& reason) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    wakeLocked(reason);
+}
+
+void PeerNode::dormantTick() {
+    // Parked is not crashed: beat at least twice per failure timeout
+    int heartbeat_ms = config_.heartbeat_interval_ms;
+    if (config_.buddy_replication) {
+        heartbeat_ms = std::min(heartbeat_ms, config_.failure_timeout_ms / 2);
+    }
+    int heartbeat_ticks = std::max(1, heartbeat_ms / std::max(1, config_.load_tick_ms));
+    if (dormant_ticks_++ % heartbeat_ticks == 0) {
+        sendLoadUpdate(0);
+    }
+    
+    // Steal-back: wake if no awake node has room for new work
+    int heaviest = -1;
+    int heaviest_load = 0;
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        for (const auto& [peer_id, entry] : peer_loads_) {
+            if (entry.dormant || entry.version < 0) {
+                continue;
+            }
+            if (entry.load < config_.num_workers) {
+                return;
+            }
+            if (entry.load > heaviest_load) {
+                heaviest = peer_id;
+                heaviest_load = entry.load;
+            }
+        }
+    }
+    if (heaviest == -1) {
+        return;
+    }
+    
+    wake("steal-back from node " + std::to_string(heaviest));
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        help_targets_[heaviest] = {heaviest_load, std::chrono::steady_clock::now() + SOS_TARGET_TTL};
+    }
+    sendLoadUpdate(getCurrentLoad());  // Peers route to us again from now on
+    requestWork();
+}
+
+int PeerNode::currentBuddy() const {
+    std::vector<int> peers = getPeers();
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    int lowest = -1;
+    int next = -1;
+    for (int peer_id : peers) {
+        if (failed_peers_.count(peer_id) > 0) {
+            continue;
+        }
+        if (peer_id > id_ && (next == -1 || peer_id < next)) {
+            next = peer_id;
+        }
+        if (lowest == -1 || peer_id < lowest) {
+            lowest = peer_id;
+        }
+    }
+    return next != -1 ? next : lowest;
+}
+
+void PeerNode::attachReplicaDelta(Message& message) {
+    std::vector<std::shared_ptr<Task>> added;
+    std::vector<uint64_t> removed;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (message.getReceiverId() != replica_buddy_) {
+            replica_buddy_ = message.getReceiverId();
+            replicated_ids_.clear();  // New buddy (old one failed): full copy
+        }
+        for (const auto& [task_id, task] : queued_by_id_) {
+            if (replicated_ids_.count(task_id) == 0) {
+                added.push_back(std::make_shared<Task>(*task));  // Snapshot, not the live task
+            }
+        }
+        for (int task_id : replicated_ids_) {
+            if (queued_by_id_.count(task_id) == 0) {
+                removed.push_back(static_cast<uint64_t>(task_id));
+            }
+        }
+        replicated_ids_.clear();
+        for (const auto& entry : queued_by_id_) {
+            replicated_ids_.insert(replicated_ids_.end(), entry.first);
+        }
+    }
+    if (added.empty() && removed.empty()) {
+        return;
+    }
+    
+    size_t plain_size = message.getWireSize();
+    message.setTasks(std::move(added));
+    if (!removed.empty()) {
+        message.setPayload(GossipDigest::encodeKeys(std::move(removed)));
+    }
+    if (metrics_) {
+        metrics_->recordReplicaBytes(message.getWireSize() - plain_size);
+    }
+}
+
+void PeerNode::applyReplicaDeltaLocked(const Message& message) {
+    std::map<int, std::shared_ptr<Task>>& mirror = replicas_[message.getSenderId()];
+    for (const auto& task : message.getTasks()) {
+        mirror[task->getId()] = task;
+    }
+    if (!message.getPayload().empty()) {
+        for (uint64_t task_id : GossipDigest::decodeKeys(message.getPayload())) {
+            mirror.erase(static_cast<int>(task_id));
+        }
+    }
+}
+
+void PeerNode::detectFailures() {
+    auto now = std::chrono::steady_clock::now();
+    auto timeout = std::chrono::milliseconds(config_.failure_timeout_ms);
+    std::vector<std::pair<int, std::vector<std::shared_ptr<Task>>>> failed;  // (peer, mirrored backlog)
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        for (auto it = peer_loads_.begin(); it != peer_loads_.end();) {
+            if (it->second.version < 0 || now - it->second.sampled <= timeout) {
+                ++it;
+                continue;
+            }
+            int peer_id = it->first;
+            std::vector<std::shared_ptr<Task>> backlog;
+            auto mirror = replicas_.find(peer_id);
+            if (mirror != replicas_.end()) {
+                for (const auto& entry : mirror->second) {
+                    backlog.push_back(entry.second);
+                }
+                replicas_.erase(mirror);
+            }
+            failed_peers_.insert(peer_id);
+            for (const auto& task : backlog) {
+                recovered_ids_[peer_id].push_back(task->getId());
+            }
+            peer_credits_.erase(peer_id);
+            help_targets_.erase(peer_id);
+            it = peer_loads_.erase(it);
+            failed.push_back({peer_id, std::move(backlog)});
+        }
+    }
+    
+    for (auto& [peer_id, backlog] : failed) {
+        {
+            std::lock_guard<std::mutex> lock(peers_mutex_);
+            peers_.erase(std::remove(peers_.begin(), peers_.end(), peer_id), peers_.end());
+        }
+        Logger::getInstance().logNodeEvent(id_, 
+            "Node " + std::to_string(peer_id) + " silent for " +
+            std::to_string(config_.failure_timeout_ms) + "ms, declared failed");
+        closeSnapshotChannel(peer_id);  // Its marker is not coming
+        if (!backlog.empty()) {
+            recoverBacklog(peer_id, std::move(backlog));
+        }
+    }
+}
+
+void PeerNode::withdrawRecovered(int origin) {
+    std::vector<int> task_ids;
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        auto recovered = recovered_ids_.find(origin);
+        if (recovered == recovered_ids_.end()) {
+            return;
+        }
+        task_ids = std::move(recovered->second);
+        recovered_ids_.erase(recovered);
+    }
+    if (!network_manager_) {
+        return;
+    }
+    
+    std::vector<uint64_t> keys(task_ids.begin(), task_ids.end());
+    Message withdraw(MessageType::TASK_WITHDRAW, id_, origin);
+    withdraw.setPayload(GossipDigest::encodeKeys(std::move(keys)));
+    stampLoadHeader(withdraw);
+    network_manager_->sendMessage(withdraw);
+    Logger::getInstance().logNodeEvent(id_, 
+        "Asked node " + std::to_string(origin) + " to drop " +
+        std::to_string(task_ids.size()) + " tasks recovered for it");
+}
+
+void PeerNode::handleWithdraw(const Message& message) {
+    int withdrawn = 0;
+    {
+        // Tombstone only what is queued here now: it is reaped on dequeue,
+        // so no tombstone outlives it to drop the recovered copy later
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        for (uint64_t key : GossipDigest::decodeKeys(message.getPayload())) {
+            int task_id = static_cast<int>(key);
+            if (queued_by_id_.count(task_id) > 0 && tombstones_.count(task_id) == 0) {
+                tombstones_[task_id] = now;
+                withdrawn++;
+            }
+        }
+    }
+    queue_cv_.notify_all();  // A withdrawn head may be waiting for resources
+    if (metrics_) {
+        metrics_->recordRecoveryWithdrawn(withdrawn);
+    }
+    Logger::getInstance().logNodeEvent(id_, 
+        "Node " + std::to_string(message.getSenderId()) + " recovered " +
+        std::to_string(withdrawn) + " of our queued tasks, dropping them");
+}
+
+void PeerNode::recoverBacklog(int origin, std::vector<std::shared_ptr<Task>> tasks) {
+    countAdmitted(static_cast<int>(tasks.size()));  // The originals were counted lost
+    std::vector<std::pair<int, int>> targets;  // (load, node), least loaded first
+    targets.push_back({getCurrentLoad(), id_});
+    {
+        std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+        for (const auto& [peer_id, entry] : peer_loads_) {
+            if (!entry.dormant && entry.version >= 0) {
+                targets.push_back({entry.load, peer_id});
+            }
+        }
+    }
+    std::sort(targets.begin(), targets.end());
+    
+    std::map<int, std::vector<std::shared_ptr<Task>>> shares;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        shares[targets[i % targets.size()].second].push_back(tasks[i]);
+    }
+    for (auto& [node_id, share] : shares) {
+        if (node_id != id_ && network_manager_) {
+            for (const auto& task : share) {
+                task->recordMigration(id_);
+            }
+            Message batch_msg(MessageType::TASK_BATCH, id_, node_id);
+            batch_msg.setTasks(share);
+            stampLoadHeader(batch_msg);
+            if (sendTasks(batch_msg)) {
+                continue;
+            }
+        }
+        for (const auto& task : share) {
+            enqueueTask(task);
+        }
+    }
+    
+    if (metrics_) {
+        metrics_->recordRecovery(static_cast<int>(tasks.size()));
+    }
+    Logger::getInstance().logNodeEvent(id_, 
+        "Recovered " + std::to_string(tasks.size()) + " tasks of failed node " +
+        std::to_string(origin) + " across " + std::to_string(shares.size()) + " nodes");
+}
+
+bool PeerNode::sendTasks(const Message& message) {
+    {
+        std::lock_guard<std::mutex> cut(cut_mutex_);
+        if (!network_manager_->sendMessage(message)) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(ledger_mutex_);
+        ledger_.sent += tasksCarried(message);
+        if (audit_) {
+            auditTransit(audit_, message);
+        }
+    }
+    
+    // Passed on: the hop before us stops counting these as ours
+    if (message.getType() == MessageType::TASK_TRANSFER && message.getTask()) {
+        releaseUpstream(message.getTask()->getId(), message.getTask()->getPreviousSender());
+    } else if (message.getType() == MessageType::TASK_BATCH) {
+        for (const auto& task : message.getTasks()) {
+            releaseUpstream(task->getId(), task->getPreviousSender());
+        }
+    }
+    return true;
+}
+
+void PeerNode::releaseUpstream(int task_id, int upstream) {
+    if (!config_.robust_routing || upstream < 0 || upstream == id_ || !network_manager_) {
+        return;
+    }
+    Message release(MessageType::TASK_RELEASED, id_, upstream);
+    release.setTaskId(task_id);
+    stampLoadHeader(release);
+    network_manager_->sendMessage(release);
+}
+
+void PeerNode::countAdmitted(int tasks) {
+    std::lock_guard<std::mutex> lock(ledger_mutex_);
+    ledger_.admitted += tasks;
+}
+
+void PeerNode::countFinished(int tasks) {
+    std::lock_guard<std::mutex> lock(ledger_mutex_);
+    ledger_.finished += tasks;
+}
+
+void PeerNode::countCompleted(const Task& task) {
+    countFinished(1);
+    if (audit_) {
+        audit_->markCompleted(task.getId());
+    }
+}
+
+void PeerNode::countShed(const Task& task) {
+    countFinished(1);
+    if (audit_) {
+        audit_->markShed(task.getId());
+    }
+    // A failed re-send already stamped us as the last sender
+    releaseUpstream(task.getId(), task.getLastSender() == id_ ? task.getPreviousSender()
+                                                              : task.getLastSender());
+}
+
+void PeerNode::countReceived(const Message& message) {
+    int tasks = tasksCarried(message);
+    if (tasks == 0) {
+        return;
+    }
+    if (audit_) {
+        auditTransit(audit_, message);
+    }
+    std::lock_guard<std::mutex> lock(ledger_mutex_);
+    ledger_.received += tasks;
+    if (snapshot_open_ && markers_from_.count(message.getSenderId()) == 0) {
+        snapshot_.channel_tasks += tasks;  // Sent before the sender's cut
+    }
+}
+
+LocalSnapshot PeerNode::getLedger() const {
+    std::lock_guard<std::mutex> lock(ledger_mutex_);
+    LocalSnapshot ledger = ledger_;
+    ledger.node_id = id_;
+    return ledger;
+}
+
+void PeerNode::initiateSnapshot(int snapshot_id) {
+    if (crashed_) {
+        return;
+    }
+    std::set<int> others = snapshotChannels();
+    std::lock_guard<std::mutex> cut(cut_mutex_);
+    int queued = getCurrentLoad();  // Sampled outside ledger_mutex_, a leaf
+    {
+        std::lock_guard<std::mutex> lock(ledger_mutex_);
+        if (snapshot_id <= snapshot_.snapshot_id) {
+            return;
+        }
+        recordSnapshotLocked(snapshot_id, queued, std::move(others));
+        finishSnapshotLocked();  // Alone in the network: nothing to wait for
+    }
+    sendMarkers(snapshot_id);
+}
+
+std::set<int> PeerNode::snapshotChannels() const {
+    std::set<int> channels;
+    if (!network_manager_) {
+        return channels;
+    }
+    std::vector<int> live = network_manager_->getLiveNodeIds();
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    for (int node_id : live) {
+        if (node_id != id_ && failed_peers_.count(node_id) == 0) {
+            channels.insert(node_id);
+        }
+    }
+    return channels;
+}
+
+void PeerNode::closeSnapshotChannel(int peer_id) {
+    std::lock_guard<std::mutex> lock(ledger_mutex_);
+    if (snapshot_open_) {
+        markers_pending_.erase(peer_id);
+        finishSnapshotLocked();
+    }
+}
+
+void PeerNode::recordSnapshotLocked(int snapshot_id, int queued, std::set<int> others) {
+    snapshot_ = ledger_;
+    snapshot_.snapshot_id = snapshot_id;
+    snapshot_.node_id = id_;
+    snapshot_.channel_tasks = 0;
+    snapshot_.queued = queued;
+    markers_from_.clear();
+    markers_pending_ = std::move(others);
+    snapshot_open_ = true;
+}
+
+void PeerNode::finishSnapshotLocked() {
+    if (!snapshot_open_ || !markers_pending_.empty()) {
+        return;
+    }
+    snapshot_open_ = false;
+    if (metrics_) {
+        metrics_->recordLocalSnapshot(snapshot_);
+    }
+}
+
+void PeerNode::sendMarkers(int snapshot_id) {
+    if (!network_manager_) {
+        return;
+    }
+    Message marker(MessageType::SNAPSHOT_MARKER, id_, -1);
+    marker.setLoadValue(snapshot_id);
+    stampLoadHeader(marker);
+    network_manager_->broadcastMessage(id_, marker);
+}
+
+void PeerNode::handleSnapshotMarker(const Message& message) {
+    int snapshot_id = message.getLoadValue();
+    std::set<int> others = snapshotChannels();
+    std::lock_guard<std::mutex> cut(cut_mutex_);
+    int queued = getCurrentLoad();
+    bool first;
+    {
+        std::lock_guard<std::mutex> lock(ledger_mutex_);
+        if (snapshot_id < snapshot_.snapshot_id) {
+            return;  // Superseded; a newer snapshot is being taken
+        }
+        first = snapshot_id > snapshot_.snapshot_id;
+        if (first) {
+            recordSnapshotLocked(snapshot_id, queued, std::move(others));  // The sender's channel is empty
+        }
+        markers_from_.insert(message.getSenderId());
+        markers_pending_.erase(message.getSenderId());
+        finishSnapshotLocked();
+    }
+    if (first) {
+        sendMarkers(snapshot_id);
+        Logger::getInstance().logNodeEvent(id_, 
+            "Recorded snapshot " + std::to_string(snapshot_id));
+    }
+}
+
+// Select the least-loaded peer for task routing
+int PeerNode::selectBestPeer(const std::shared_ptr<Task>& task) {
+    // The oracle reads each peer's queue_mutex_; never under our view lock
+    bool oracle = config_.routing_policy == RoutingPolicy::ORACLE && network_manager_;
+    std::map<int, int> true_loads;
+    if (oracle) {
+        for (int peer_id : getPeers()) {
+            true_loads[peer_id] = network_manager_->getNodeLoad(peer_id);
+        }
+    }
+    
+    std::unique_lock<std::mutex> lock(peer_loads_mutex_);
+    
+    if (peer_loads_.empty()) {
+        return -1;
+    }
+    
+    // Zone-aware routing and DAG input locality compare expected completion
+    // times (ms); otherwise the cost of a task slot is 1 and the latency and
+    // input-fetch terms are dropped
+    bool locality = config_.dag_locality && task && !task->getInputNodes().empty();
+    double ms_per_task = 1.0;
+    if ((config_.zone_aware_routing || locality) && avg_service_ms_.load() > 0.0) {
+        ms_per_task = avg_service_ms_.load() / config_.num_workers;
+    }
+    
+    // DRF: compare dominant pressure on the task's resources, with the
+    // task's own share added to the peer side (it is no longer queued here)
+    bool drf = config_.drf_balancing && task;
+    double own_load = drf ? dominantPressure(getResourcePressure(), task->getDemand())
+                          : getCurrentLoad();
+    double task_share = drf ? dominantShare(task->getDemand(), capacity_) : 0.0;
+    
+    int best_peer = -1;
+    double min_cost = own_load * ms_per_task;  // Only offload to peers that are better
+    if (locality) {
+        min_cost += task->inputFetchCost(id_);
+    }
+    double own_cost = min_cost;
+    double best_score = 0.0;
+    bool bandit = config_.routing_policy == RoutingPolicy::BANDIT;
+    double best_age_ms = 0.0;
+    auto now = std::chrono::steady_clock::now();
+    
+    for (const auto& [peer_id, entry] : peer_loads_) {
+        if (entry.dormant) {
+            continue;  // Parked: consolidation keeps work off it
+        }
+        if (config_.credit_flow_control) {
+            auto credit = peer_credits_.find(peer_id);
+            if (credit == peer_credits_.end() || credit->second <= 0) {
+                continue;  // Receiver has not granted us room
+            }
+        }
+        
+        double age_ms = std::chrono::duration<double, std::milli>(now - entry.sampled).count();
+        if (config_.max_view_age_ms > 0 && age_ms > config_.max_view_age_ms) {
+            continue;  // Too old to trust
+        }
+        
+        double base_load = entry.load;
+        if (drf && entry.pressure_version >= 0) {
+            base_load = dominantPressure(entry.pressure, task->getDemand()) + task_share;
+        }
+        if (oracle) {
+            auto true_load = true_loads.find(peer_id);
+            if (true_load == true_loads.end() || true_load->second < 0) {
+                continue;  // Not a peer (any more)
+            }
+            base_load = true_load->second;
+            age_ms = 0.0;  // Exact as of just before the lock
+        }
+        double effective_load = base_load + config_.staleness_penalty_per_sec * age_ms / 1000.0;
+        if (config_.robust_routing) {
+            auto trust = peer_trust_.find(peer_id);
+            if (trust != peer_trust_.end()) {
+                if (trust->second.trust < config_.min_peer_trust) {
+                    continue;  // Caught misreporting too often
+                }
+                effective_load = (effective_load + 1.0) / trust->second.trust - 1.0;
+            }
+        }
+        double cost = effective_load * ms_per_task;
+        if (config_.zone_aware_routing && network_manager_) {
+            cost += network_manager_->getLinkProfile(id_, peer_id).latency_ms;
+        }
+        if (locality) {
+            cost += task->inputFetchCost(peer_id);
+        }
+        if (bandit) {
+            // The load test only decides eligibility; the learned model ranks
+            if (cost < own_cost) {
+                double score = bandit_.score(banditContextLocked(peer_id, entry.load, age_ms));
+                if (best_peer == -1 || score > best_score) {
+                    best_score = score;
+                    best_peer = peer_id;
+                    best_age_ms = age_ms;
+                }
+            }
+            continue;
+        }
+        if (cost < min_cost) {
+            min_cost = cost;
+            best_peer = peer_id;
+            best_age_ms = age_ms;
+        }
+    }
+    
+    if (best_peer == -1 || !metrics_) {
+        return best_peer;
+    }
+    metrics_->recordViewAge(best_age_ms);
+    if (!network_manager_ ||
+        !(bandit || config_.routing_policy == RoutingPolicy::ORACLE || config_.measure_regret)) {
+        return best_peer;
+    }
+    
+    // Regret against an oracle that sees every queue exactly. Reading the
+    // queues takes each peer's queue_mutex_, so do it without our view lock
+    std::vector<int> peers;
+    peers.reserve(peer_loads_.size());
+    for (const auto& peer : peer_loads_) {
+        peers.push_back(peer.first);
+    }
+    lock.unlock();
+    int chosen = network_manager_->getNodeLoad(best_peer);
+    int lowest = chosen;
+    for (int peer_id : peers) {
+        int load = network_manager_->getNodeLoad(peer_id);
+        if (load >= 0) {
+            lowest = std::min(lowest, load);
+        }
+    }
+    metrics_->recordRoutingRegret(chosen - lowest);
+    return best_peer;
+}
+
+BanditContext PeerNode::banditContextLocked(int peer_id, int load, double age_ms) const {
+    PeerFeedback feedback;
+    auto known = peer_feedback_.find(peer_id);
+    if (known != peer_feedback_.end()) {
+        feedback = known->second;
+    }
+    return {
+        1.0,
+        std::min(5.0, static_cast<double>(load) / std::max(1, config_.load_threshold)),
+        std::min(5.0, age_ms / 1000.0),
+        std::min(BANDIT_ACK_TIMEOUT_S, feedback.ack_latency_s),
+        feedback.ack_rate,
+    };
+}
+
+void PeerNode::recordBanditDecision(int task_id, int peer_id) {
+    if (config_.routing_policy != RoutingPolicy::BANDIT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    auto entry = peer_loads_.find(peer_id);
+    if (entry == peer_loads_.end()) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    double age_ms = std::chrono::duration<double, std::milli>(now - entry->second.sampled).count();
+    pending_feedback_[task_id] = {peer_id, banditContextLocked(peer_id, entry->second.load, age_ms), now};
+}
+
+void PeerNode::applyBanditFeedbackLocked(int task_id, double completion_s, bool acked) {
+    auto pending = pending_feedback_.find(task_id);
+    if (pending == pending_feedback_.end()) {
+        return;
+    }
+    PeerFeedback& feedback = peer_feedback_[pending->second.peer];
+    feedback.ack_latency_s += BANDIT_EWMA_WEIGHT * (completion_s - feedback.ack_latency_s);
+    feedback.ack_rate += BANDIT_EWMA_WEIGHT * ((acked ? 1.0 : 0.0) - feedback.ack_rate);
+    bandit_.update(pending->second.context, -completion_s);  // Reward: faster is better
+    pending_feedback_.erase(pending);
+}
+
+void PeerNode::expireBanditFeedback() {
+    if (config_.routing_policy != RoutingPolicy::BANDIT) {
+        return;
+    }
+    auto cutoff = std::chrono::steady_clock::now() -
+                  std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                      std::chrono::duration<double>(BANDIT_ACK_TIMEOUT_S));
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    std::vector<int> overdue;
+    for (const auto& [task_id, pending] : pending_feedback_) {
+        if (pending.sent < cutoff) {
+            overdue.push_back(task_id);
+        }
+    }
+    for (int task_id : overdue) {
+        applyBanditFeedbackLocked(task_id, BANDIT_ACK_TIMEOUT_S, false);
+    }
+}
+
+// Spend one transfer credit on the link to peer_id
+bool PeerNode::consumeCredit(int peer_id) {
+    if (!config_.credit_flow_control) {
+        return true;
+    }
+    
+    std::lock_guard<std::mutex> lock(peer_loads_mutex_);
+    auto it = peer_credits_.find(peer_id);
+    if (it == peer_credits_.end() || it->second <= 0) {
+        return false;
+    }
+    it->second--;
+    return true;
 }
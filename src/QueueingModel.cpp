@@ -0,0 +1,120 @@
+#include "QueueingModel.h"
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// Mean-field queue tails are summed until s_k drops below this
+const double TAIL_EPSILON = 1e-12;
+
+// Smallest t with tail(t) <= 1 - p, by bisection (tail is decreasing)
+static double percentileOf(const std::function<double(double)>& tail, double p) {
+    double target = 1.0 - p;
+    double high = 1.0;
+    while (tail(high) > target) {
+        high *= 2.0;
+    }
+    double low = 0.0;
+    for (int i = 0; i < 100; ++i) {
+        double mid = (low + high) / 2.0;
+        if (tail(mid) > target) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return high;
+}
+
+// rho >= 1: no steady state to predict
+static QueuePrediction unstablePrediction() {
+    const double INF = std::numeric_limits<double>::infinity();
+    QueuePrediction prediction;
+    prediction.stable = false;
+    prediction.mean_response_s = INF;
+    prediction.p99_response_s = INF;
+    prediction.mean_queued = INF;
+    return prediction;
+}
+
+double erlangC(int servers, double offered_load) {
+    if (offered_load >= servers) {
+        return 1.0;
+    }
+    // Erlang B by its recurrence, then C from B (no factorials to overflow)
+    double b = 1.0;
+    for (int k = 1; k <= servers; ++k) {
+        b = offered_load * b / (k + offered_load * b);
+    }
+    double rho = offered_load / servers;
+    return b / (1.0 - rho * (1.0 - b));
+}
+
+QueuePrediction predictMMc(double arrival_rate, double service_rate, int servers) {
+    if (arrival_rate >= servers * service_rate) {
+        return unstablePrediction();
+    }
+    double c_wait = erlangC(servers, arrival_rate / service_rate);
+    double drain_rate = servers * service_rate - arrival_rate;  // Wait ~ Exp(drain_rate) given a wait
+    double mean_wait = c_wait / drain_rate;
+
+    // Response = wait + Exp(service_rate) service
+    auto tail = [=](double t) {
+        double serve = std::exp(-service_rate * t);
+        double both = std::abs(drain_rate - service_rate) < 1e-9
+            ? (1.0 + service_rate * t) * serve
+            : (drain_rate * serve - service_rate * std::exp(-drain_rate * t)) /
+              (drain_rate - service_rate);
+        return (1.0 - c_wait) * serve + c_wait * both;
+    };
+
+    QueuePrediction prediction;
+    prediction.mean_response_s = mean_wait + 1.0 / service_rate;
+    prediction.p99_response_s = percentileOf(tail, 0.99);
+    prediction.mean_queued = arrival_rate * mean_wait;  // Little's law
+    return prediction;
+}
+
+QueuePrediction predictPowerOfD(double utilization, double service_rate, int choices) {
+    if (utilization >= 1.0) {
+        return unstablePrediction();  // s_k stays at 1: the tail sum never ends
+    }
+    // s[k]: fraction of queues with at least k tasks (s[0] = 1)
+    std::vector<double> s = {1.0};
+    double exponent = 0.0;
+    while (s.back() > TAIL_EPSILON) {
+        exponent = choices * exponent + 1.0;
+        s.push_back(std::pow(utilization, exponent));
+    }
+    s.push_back(0.0);
+
+    // sees[k]: probability an arrival joins a queue holding k tasks
+    std::vector<double> sees(s.size() - 1);
+    for (size_t k = 0; k + 1 < s.size(); ++k) {
+        sees[k] = std::pow(s[k], choices) - std::pow(s[k + 1], choices);
+    }
+
+    // Response given k ahead = k + 1 exponential services (Erlang k + 1)
+    auto tail = [&](double t) {
+        double mt = service_rate * t;
+        double term = std::exp(-mt);  // e^-mt (mt)^n / n!
+        double erlang_tail = 0.0;
+        double total = 0.0;
+        for (size_t k = 0; k < sees.size(); ++k) {
+            erlang_tail += term;
+            total += sees[k] * erlang_tail;
+            term *= mt / (k + 1);
+        }
+        return total;
+    };
+
+    QueuePrediction prediction;
+    for (size_t k = 0; k < sees.size(); ++k) {
+        prediction.mean_response_s += sees[k] * (k + 1) / service_rate;
+    }
+    for (size_t k = 2; k < s.size(); ++k) {
+        prediction.mean_queued += s[k];
+    }
+    prediction.p99_response_s = percentileOf(tail, 0.99);
+    return prediction;
+}
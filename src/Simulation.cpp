@@ -0,0 +1,714 @@
+#include "Simulation.h"
+#include "PeerNode.h"
+#include "NetworkManager.h"
+#include "Metrics.h"
+#include "Task.h"
+#include "Logger.h"
+#include <iostream>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <deque>
+#include <cmath>
+#include <filesystem>
+
+// Sampling period for SimulationResult::mean_queued_per_node and the
+// work-conservation figures
+const int QUEUE_SAMPLE_MS = 50;
+
+// Least-squares slope of evenly spaced samples (per sample interval)
+static double leastSquaresSlope(const std::vector<int>& samples) {
+    size_t n = samples.size();
+    if (n < 2) {
+        return 0.0;
+    }
+    double mean_x = (n - 1) / 2.0;
+    double mean_y = 0.0;
+    for (int sample : samples) {
+        mean_y += sample;
+    }
+    mean_y /= n;
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        covariance += (i - mean_x) * (samples[i] - mean_y);
+        variance += (i - mean_x) * (i - mean_x);
+    }
+    return covariance / variance;
+}
+
+Simulation::Simulation(const SimulationConfig& config)
+    : config_(config) {
+}
+
+double Simulation::estimateCapacity(const SimulationConfig& config) {
+    double mean_task_ms = (1.0 - config.long_task_fraction) *
+                          (config.min_task_complexity + config.max_task_complexity) / 2.0 +
+                          config.long_task_fraction * config.long_task_complexity;
+    if (config.dag_fanout > 0) {
+        mean_task_ms *= config.dag_fanout + 2;  // One arrival = split + maps + reduce
+    }
+    return config.num_nodes * config.node.num_workers * 1000.0 / mean_task_ms;
+}
+
+double Simulation::intervalForLoad(const SimulationConfig& config, double load_factor) {
+    return 1000.0 / (estimateCapacity(config) * load_factor);
+}
+
+SimulationResult Simulation::run() {
+    Metrics metrics;
+
+    // Create network manager
+    auto network_manager = std::make_shared<NetworkManager>();
+    if (config_.link_rate_limit.rate_per_sec > 0.0) {
+        network_manager->setLinkRateLimit(config_.link_rate_limit);
+    }
+    for (const auto& [message_class, limit] : config_.class_rate_limits) {
+        network_manager->setClassRateLimit(message_class, limit);
+    }
+
+    // Every run starts from empty journals (a leftover one would be replayed)
+    if (!config_.node.journal_dir.empty()) {
+        std::error_code ignored;
+        std::filesystem::create_directories(config_.node.journal_dir, ignored);
+        for (int i = 0; i < config_.num_nodes; ++i) {
+            std::filesystem::remove(PeerNode::journalPath(config_.node.journal_dir, i), ignored);
+        }
+    }
+
+    // Declared before the nodes, which point at it until they are destroyed
+    std::unique_ptr<TaskAudit> audit;
+    if (config_.audit) {
+        audit = std::make_unique<TaskAudit>();
+    }
+
+    // Create peer nodes
+    std::vector<std::shared_ptr<PeerNode>> nodes;
+    for (int i = 0; i < config_.num_nodes; ++i) {
+        NodeConfig node_config = config_.node;
+        auto faulty = config_.misbehaving_nodes.find(i);
+        if (faulty != config_.misbehaving_nodes.end()) {
+            node_config.misbehavior = faulty->second;
+        }
+        if (!config_.node_capacities.empty()) {
+            node_config.resource_capacity = config_.node_capacities[i % config_.node_capacities.size()];
+        }
+        auto node = std::make_shared<PeerNode>(i, node_config, network_manager.get(), &metrics);
+        node->setAudit(audit.get());
+        nodes.push_back(node);
+        network_manager->registerNode(i, node.get());
+    }
+
+    // Zones and link profiles (geo-distributed cluster model)
+    int zones = std::max(1, config_.num_zones);
+    for (int i = 0; i < config_.num_nodes; ++i) {
+        network_manager->setNodeZone(i, i % zones);
+    }
+    if (!config_.link_matrix_file.empty()) {
+        network_manager->loadLinkMatrix(config_.link_matrix_file);
+    } else if (!config_.zone_latency_ms.empty() || config_.link_bandwidth_bytes_per_sec > 0.0) {
+        for (int i = 0; i < config_.num_nodes; ++i) {
+            for (int j = 0; j < config_.num_nodes; ++j) {
+                if (i == j) {
+                    continue;
+                }
+                size_t zi = network_manager->getNodeZone(i);
+                size_t zj = network_manager->getNodeZone(j);
+                LinkProfile profile;
+                if (zi < config_.zone_latency_ms.size() && zj < config_.zone_latency_ms[zi].size()) {
+                    profile.latency_ms = config_.zone_latency_ms[zi][zj];
+                }
+                profile.bandwidth_bytes_per_sec = config_.link_bandwidth_bytes_per_sec;
+                network_manager->setLinkProfile(i, j, profile);
+            }
+        }
+    }
+
+    // Setup peer connections (fully connected mesh, or hypercube edges)
+    for (int i = 0; i < config_.num_nodes; ++i) {
+        for (int j = 0; j < config_.num_nodes; ++j) {
+            bool one_bit = ((i ^ j) & ((i ^ j) - 1)) == 0;
+            if (i != j && (!config_.hypercube_overlay || one_bit)) {
+                nodes[i]->addPeer(j);
+            }
+        }
+    }
+
+    // Start all nodes
+    if (config_.verbose) {
+        std::cout << "Starting " << config_.num_nodes << " nodes..." << std::endl;
+    }
+    for (auto& node : nodes) {
+        node->start();
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    if (config_.verbose) {
+        std::cout << "All nodes started successfully!" << std::endl;
+        std::cout << std::endl;
+    }
+
+    // Random number generation for task creation
+    std::mt19937 gen(config_.seed != 0 ? config_.seed : std::random_device{}());
+    std::uniform_int_distribution<> node_dist(0, config_.num_nodes - 1);
+    std::uniform_int_distribution<> complexity_dist(config_.min_task_complexity,
+                                                    config_.max_task_complexity);
+    std::bernoulli_distribution hot_dist(config_.hot_node_fraction);
+    std::bernoulli_distribution long_dist(config_.long_task_fraction);
+    std::uniform_int_distribution<> hot_node_dist(0, std::max(1, config_.hot_nodes) - 1);
+    std::uniform_int_distribution<size_t> demand_dist(
+        0, std::max<size_t>(1, config_.task_demand_mix.size()) - 1);
+    std::bernoulli_distribution cancel_dist(config_.cancel_fraction);
+    std::vector<double> key_weights;
+    for (int k = 1; k <= config_.key_space; ++k) {
+        key_weights.push_back(1.0 / std::pow(k, config_.key_zipf_s));
+    }
+    std::discrete_distribution<int> key_dist(key_weights.begin(), key_weights.end());
+    std::exponential_distribution<> service_dist(
+        2.0 / (config_.min_task_complexity + config_.max_task_complexity));
+    std::exponential_distribution<> gap_dist(1.0);  // Poisson arrivals, in mean intervals
+
+    // Task generation thread
+    std::atomic<bool> generating(true);
+    std::atomic<int> task_counter(0);
+    auto queueSpread = [&]() {
+        int lowest = nodes[0]->getCurrentLoad();
+        int highest = lowest;
+        for (const auto& node : nodes) {
+            int load = node->getCurrentLoad();
+            lowest = std::min(lowest, load);
+            highest = std::max(highest, load);
+        }
+        return highest - lowest;
+    };
+
+    // Balancing convergence: burst onto node 0, then watch the spread
+    std::atomic<double> convergence_ms(-1.0);
+    long long transfer_messages_at_burst = network_manager->getMessagesSent(MessageClass::TRANSFER);
+    long long convergence_messages = 0;
+    int convergence_transfers = 0;
+    std::thread convergence_monitor;
+    if (config_.initial_tasks > 0) {
+        auto burst_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < config_.initial_tasks; ++i) {
+            int task_id = task_counter++;
+            if (audit) {
+                audit->markCreated(task_id);
+            }
+            nodes[0]->addTask(std::make_shared<Task>(task_id, complexity_dist(gen)));
+        }
+        convergence_monitor = std::thread([&, burst_start]() {
+            while (generating) {
+                if (queueSpread() <= config_.balance_tolerance) {
+                    convergence_messages = network_manager->getMessagesSent(MessageClass::TRANSFER) -
+                                           transfer_messages_at_burst;
+                    convergence_transfers = metrics.getTransfers();
+                    convergence_ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - burst_start).count();
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+        });
+    }
+    auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(config_.task_generation_interval_ms));
+
+    auto generate = [&]() {
+        struct PendingCancel {
+            std::chrono::steady_clock::time_point due;
+            int task_id;
+            int node;
+        };
+        std::deque<PendingCancel> pending_cancels;  // Due times are increasing
+        auto cancel_after = std::chrono::milliseconds(config_.cancel_after_ms);
+        
+        auto next_arrival = std::chrono::steady_clock::now();
+        auto arrival_interval = interval;
+        auto surge_at = next_arrival + std::chrono::seconds(config_.surge_at_seconds);
+        bool surged = config_.surge_at_seconds <= 0;
+        while (generating) {
+            auto now = std::chrono::steady_clock::now();
+            if (!surged && now >= surge_at) {
+                arrival_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    interval / config_.surge_factor);
+                surged = true;
+            }
+            while (!pending_cancels.empty() && pending_cancels.front().due <= now) {
+                nodes[pending_cancels.front().node]->cancelTask(pending_cancels.front().task_id);
+                pending_cancels.pop_front();
+            }
+            
+            // Generate a task (or a DAG job) and assign it to a random node
+            int target_node = hot_dist(gen) ? hot_node_dist(gen) : node_dist(gen);
+            if (nodes[target_node]->isCrashed()) {
+                target_node = (target_node + 1) % config_.num_nodes;  // Clients fail over
+            }
+            if (config_.dispatch_choices > 0) {
+                // JSQ(d): fewest tasks in system among d sampled nodes
+                bool all = config_.dispatch_choices >= config_.num_nodes;
+                int best = -1;
+                int best_load = 0;
+                for (int c = 0; c < (all ? config_.num_nodes : config_.dispatch_choices); ++c) {
+                    int candidate = all ? (target_node + c) % config_.num_nodes : node_dist(gen);
+                    if (nodes[candidate]->isCrashed()) {
+                        continue;
+                    }
+                    int load = nodes[candidate]->getTasksInSystem();
+                    if (best == -1 || load < best_load) {
+                        best = candidate;
+                        best_load = load;
+                    }
+                }
+                target_node = best != -1 ? best : target_node;
+            }
+            auto make_task = [&]() {
+                int task_id = task_counter++;
+                if (audit) {
+                    audit->markCreated(task_id);
+                }
+                int complexity = long_dist(gen) ? config_.long_task_complexity
+                               : config_.exponential_service
+                                   ? std::max(1, static_cast<int>(std::lround(service_dist(gen))))
+                                   : complexity_dist(gen);
+                uint64_t key = 0;
+                if (config_.key_space > 0) {
+                    // Same key, same work: size is a fixed hash of the key
+                    key = static_cast<uint64_t>(key_dist(gen)) + 1;
+                    int range = config_.max_task_complexity - config_.min_task_complexity + 1;
+                    complexity = config_.min_task_complexity +
+                                 static_cast<int>((key * 2654435761u) % range);
+                }
+                auto task = config_.task_demand_mix.empty()
+                    ? std::make_shared<Task>(task_id, complexity)
+                    : std::make_shared<Task>(task_id, complexity,
+                                             config_.task_demand_mix[demand_dist(gen)]);
+                task->setInputTransferMs(config_.dag_input_transfer_ms);
+                task->setContentKey(key);
+                if (config_.task_deadline_ms > 0) {
+                    task->setDeadline(task->getCreationTime() +
+                                      std::chrono::milliseconds(config_.task_deadline_ms));
+                }
+                return task;
+            };
+
+            auto task = make_task();
+            if (config_.dag_fanout > 0) {
+                // split -> maps -> reduce, all homed (tracked) at the target
+                // node. Successors are parked before the split is submitted,
+                // so no completion can arrive for an unknown task.
+                auto reduce = make_task();
+                int longest_map = 0;
+                for (int m = 0; m < config_.dag_fanout; ++m) {
+                    auto map = make_task();
+                    map->addDependency(task->getId());
+                    task->addSuccessor(map->getId(), target_node);
+                    reduce->addDependency(map->getId());
+                    map->addSuccessor(reduce->getId(), target_node);
+                    longest_map = std::max(longest_map, map->getComplexity());
+                    nodes[target_node]->submitDependentTask(map);
+                }
+                reduce->setCriticalPath(task->getComplexity() + longest_map + reduce->getComplexity());
+                nodes[target_node]->submitDependentTask(reduce);
+            }
+            nodes[target_node]->addTask(task);
+            if (config_.dag_fanout == 0 && cancel_dist(gen)) {
+                pending_cancels.push_back({task->getCreationTime() + cancel_after,
+                                           task->getId(), target_node});
+            }
+
+            // Fixed-rate schedule (sleep_until avoids drift at high rates).
+            // If the producer fell behind (e.g., blocked by backpressure),
+            // restart the schedule instead of bursting to catch up.
+            if (config_.poisson_arrivals) {
+                next_arrival += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    arrival_interval * gap_dist(gen));
+            } else {
+                next_arrival += arrival_interval;
+            }
+            now = std::chrono::steady_clock::now();
+            if (next_arrival + arrival_interval < now) {
+                next_arrival = now;
+            }
+            std::this_thread::sleep_until(next_arrival);
+        }
+    };
+    std::thread task_generator;
+    if (config_.task_generation_interval_ms > 0.0) {
+        task_generator = std::thread(generate);
+    }
+
+    // Time-average queue length (the per-second progress samples are too
+    // sparse to compare against queueing models) and work conservation:
+    // worker time spent idle while another node had tasks waiting
+    long long queued_sum = 0;
+    long long queue_samples = 0;
+    long long busy_worker_samples = 0;
+    long long wasted_worker_samples = 0;
+    std::thread queue_sampler([&]() {
+        std::vector<int> queued(nodes.size());
+        std::vector<int> idle(nodes.size());
+        while (generating) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(QUEUE_SAMPLE_MS));
+            int total_queued = 0;
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                queued[i] = nodes[i]->getCurrentLoad();
+                idle[i] = 0;
+                if (!nodes[i]->isCrashed()) {
+                    int running = nodes[i]->getRunningTasks();
+                    busy_worker_samples += running;
+                    idle[i] = std::max(0, nodes[i]->getConfig().num_workers - running);
+                }
+                total_queued += queued[i];
+                queued_sum += queued[i];
+                queue_samples++;
+            }
+            // An idle worker is wasted only while another node has a task
+            // waiting, and each waiting task can occupy one idle worker
+            int idle_elsewhere = 0;
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (total_queued > queued[i]) {
+                    idle_elsewhere += idle[i];
+                }
+            }
+            wasted_worker_samples += std::min(idle_elsewhere, total_queued);
+        }
+    });
+
+    // Run simulation
+    if (config_.verbose) {
+        std::cout << "Running simulation for " << config_.duration_seconds << " seconds..." << std::endl;
+        std::cout << "Generating tasks every " << config_.task_generation_interval_ms << "ms" << std::endl;
+        std::cout << std::endl;
+    }
+
+    // Progress updates
+    long long messages_at_start = network_manager->getMessagesSent();
+    long long bytes_at_start = network_manager->getBytesSent();
+    int peak_node_load = 0;
+    std::vector<int> backlog;  // Generated - completed, per second; the second half gives the trend
+    ResourceVector utilization_sum{};
+    int utilization_samples = 0;
+    std::chrono::steady_clock::time_point crash_time;
+
+    // Snapshots: one per second, read back a second later. The naive
+    // total sums each node's ledger in turn as the snapshot starts
+    struct SnapshotProbe {
+        std::chrono::steady_clock::time_point started;
+        long long naive_total;
+        int participants;  // Nodes live at the cut
+    };
+    std::map<int, SnapshotProbe> snapshot_probes;
+    int snapshots_completed = 0;
+    int snapshots_inconsistent = 0;
+    double snapshot_ms_sum = 0.0;
+    long long in_channel_sum = 0;
+    long long naive_error_sum = 0;
+    auto collectSnapshots = [&]() {
+        for (auto probe = snapshot_probes.begin(); probe != snapshot_probes.end();) {
+            GlobalSnapshot snapshot;
+            if (!metrics.getSnapshot(probe->first, probe->second.participants, snapshot)) {
+                ++probe;
+                continue;
+            }
+            snapshots_completed++;
+            if (!snapshot.consistent()) {
+                snapshots_inconsistent++;
+            }
+            snapshot_ms_sum += std::chrono::duration<double, std::milli>(
+                snapshot.completed_at - probe->second.started).count();
+            in_channel_sum += snapshot.in_channel;
+            naive_error_sum += std::abs(probe->second.naive_total - snapshot.inSystem());
+            if (config_.verbose) {
+                std::cout << "  Snapshot " << probe->first << ": " << snapshot.inSystem()
+                          << " tasks in system (" << snapshot.held << " held, "
+                          << snapshot.in_channel << " in flight)"
+                          << (snapshot.consistent() ? "" : " INCONSISTENT") << std::endl;
+            }
+            probe = snapshot_probes.erase(probe);
+        }
+    };
+
+    for (int i = 0; i < config_.duration_seconds; ++i) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (config_.crash_node >= 0 && i + 1 == config_.crash_at_seconds) {
+            crash_time = std::chrono::steady_clock::now();
+            nodes[config_.crash_node]->crash();
+        }
+        if (config_.crash_node >= 0 && config_.restart_after_seconds > 0 &&
+            i + 1 == config_.crash_at_seconds + config_.restart_after_seconds) {
+            nodes[config_.crash_node]->restart();
+        }
+
+        int total_load = 0;
+        int total_processed = 0;
+
+        for (const auto& node : nodes) {
+            int load = node->getCurrentLoad();
+            peak_node_load = std::max(peak_node_load, load);
+            ResourceVector utilization = node->getResourceUtilization();
+            for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+                utilization_sum[r] += utilization[r];
+            }
+            utilization_samples++;
+            total_load += load;
+            total_processed += node->getTasksProcessed();
+        }
+        if (i >= config_.duration_seconds / 2) {
+            backlog.push_back(task_counter.load() - metrics.getCompleted());  // First half: warm-up
+        }
+
+        if (config_.verbose) {
+            std::cout << "Time: " << (i + 1) << "s - ";
+            std::cout << "Total queue: " << total_load
+                      << ", Total processed: " << total_processed << std::endl;
+        }
+
+        if (config_.snapshots) {
+            collectSnapshots();
+            auto initiator = std::find_if(nodes.begin(), nodes.end(),
+                [](const auto& node) { return !node->isCrashed(); });
+            if (initiator != nodes.end()) {
+                SnapshotProbe probe{std::chrono::steady_clock::now(), 0,
+                    static_cast<int>(std::count_if(nodes.begin(), nodes.end(),
+                        [](const auto& node) { return !node->isCrashed(); }))};
+                (*initiator)->initiateSnapshot(i + 1);
+                for (const auto& node : nodes) {
+                    probe.naive_total += node->getLedger().held();
+                }
+                snapshot_probes[i + 1] = probe;
+            }
+        }
+    }
+
+    int completed_in_window = metrics.getCompleted();
+    int late_in_window = metrics.getLateCompletions();
+    long long window_messages = network_manager->getMessagesSent() - messages_at_start;
+    int final_spread = queueSpread();
+    double awake_node_seconds = 0.0;
+    for (const auto& node : nodes) {
+        awake_node_seconds += node->getAwakeSeconds();
+    }
+    long long window_bytes = network_manager->getBytesSent() - bytes_at_start;
+
+    // Stop task generation
+    generating = false;
+    if (task_generator.joinable()) {
+        task_generator.join();
+    }
+    if (convergence_monitor.joinable()) {
+        convergence_monitor.join();
+    }
+    queue_sampler.join();
+
+    // Allow some time for remaining tasks to be processed
+    if (config_.verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping task generation, processing remaining tasks..." << std::endl;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(config_.drain_seconds));
+
+    // Collect final statistics
+    SimulationResult result;
+    result.tasks_generated = task_counter.load();
+    for (const auto& node : nodes) {
+        int processed = node->getTasksProcessed();
+        int remaining = node->getCurrentLoad();
+
+        result.tasks_processed += processed;
+        result.tasks_remaining += remaining;
+        result.processed_per_node.push_back(processed);
+        result.remaining_per_node.push_back(remaining);
+
+        double min_trust = 1.0;
+        for (const auto& peer : nodes) {
+            if (peer != node) {
+                min_trust = std::min(min_trust, peer->getPeerTrust(node->getId()));
+            }
+        }
+        result.min_trust_per_node.push_back(min_trust);
+    }
+    result.admission_rejects = metrics.getAdmissionRejects();
+    result.overflow_rejects = metrics.getOverflowRejects();
+    result.redirects = metrics.getRedirects();
+    result.blocked_seconds = metrics.getBlockedSeconds();
+    result.transfers = metrics.getTransfers();
+    result.transfer_overshoots = metrics.getTransferOvershoots();
+    result.peak_node_load = peak_node_load;
+    result.backlog_growth_per_sec = leastSquaresSlope(backlog);
+    if (queue_samples > 0) {
+        result.mean_queued_per_node = static_cast<double>(queued_sum) / queue_samples;
+    }
+    result.idle_while_waiting_seconds = wasted_worker_samples * QUEUE_SAMPLE_MS / 1000.0;
+    if (busy_worker_samples + wasted_worker_samples > 0) {
+        result.work_conservation = 100.0 * busy_worker_samples /
+                                   (busy_worker_samples + wasted_worker_samples);
+    }
+    result.mean_view_age_ms = metrics.getMeanViewAge();
+    result.view_updates = metrics.getViewUpdates();
+    result.piggybacked_view_updates = metrics.getPiggybackedViewUpdates();
+    result.goodput = config_.duration_seconds > 0
+        ? static_cast<double>(completed_in_window) / config_.duration_seconds
+        : 0.0;
+    if (config_.duration_seconds > 0) {
+        double node_seconds = static_cast<double>(config_.num_nodes) * config_.duration_seconds;
+        result.messages_per_node_per_sec = window_messages / node_seconds;
+        result.bytes_per_node_per_sec = window_bytes / node_seconds;
+    }
+    result.tasks_lost = metrics.getLostTasks();
+    result.jobs_completed = metrics.getJobsCompleted();
+    result.mean_makespan_ms = metrics.getMeanMakespan();
+    result.p99_makespan_ms = metrics.getMakespanPercentile(99);
+    result.mean_critical_path_ms = metrics.getMeanCriticalPath();
+    result.input_fetch_seconds = metrics.getInputFetchSeconds();
+    result.tasks_cancelled = metrics.getCancelledTasks();
+    result.tasks_expired = metrics.getExpiredTasks();
+    result.work_avoided_seconds = metrics.getWorkAvoidedSeconds();
+    result.late_completions = metrics.getLateCompletions();
+    result.late_work_seconds = metrics.getLateWorkSeconds();
+    result.tasks_coalesced = metrics.getCoalescedTasks();
+    result.cache_hits = metrics.getCacheHits();
+    result.hint_routed = metrics.getHintRoutedTasks();
+    result.dedup_saved_seconds = metrics.getDedupSavedSeconds();
+    result.routing_decisions = metrics.getRoutingDecisions();
+    result.cumulative_regret = metrics.getCumulativeRegret();
+    result.mean_regret = metrics.getMeanRegret();
+    result.convergence_ms = convergence_ms.load();
+    result.convergence_messages = convergence_messages;  // Written before the monitor exits
+    result.convergence_transfers = convergence_transfers;
+    result.final_spread = final_spread;
+    result.sos_raised = metrics.getSosRaised();
+    result.rumor_messages = metrics.getRumorMessages();
+    result.steal_requests = metrics.getStealRequests();
+    result.awake_node_seconds = awake_node_seconds;
+    result.cpu_seconds = awake_node_seconds * config_.node.num_workers;
+    result.parks = metrics.getParks();
+    result.wakeups = metrics.getWakeups();
+    result.tasks_recovered = metrics.getRecoveredTasks();
+    result.tasks_withdrawn = metrics.getWithdrawnTasks();
+    result.tasks_restored = metrics.getRestoredTasks();
+    result.restore_ms = metrics.getRestoreSeconds() * 1000.0;
+    if (crash_time != std::chrono::steady_clock::time_point() &&
+        metrics.getLastRecoveryTime() > crash_time) {
+        result.recovery_ms = std::chrono::duration<double, std::milli>(
+            metrics.getLastRecoveryTime() - crash_time).count();
+    }
+    collectSnapshots();  // Drained by now unless a crash cut one short
+    result.snapshots_completed = snapshots_completed;
+    result.snapshots_inconsistent = snapshots_inconsistent;
+    if (snapshots_completed > 0) {
+        result.snapshot_ms = snapshot_ms_sum / snapshots_completed;
+        result.mean_in_channel = static_cast<double>(in_channel_sum) / snapshots_completed;
+        result.mean_naive_error = static_cast<double>(naive_error_sum) / snapshots_completed;
+    }
+    if (config_.duration_seconds > 0) {
+        result.replica_bytes_per_node_per_sec = metrics.getReplicaBytes() /
+            (static_cast<double>(config_.num_nodes) * config_.duration_seconds);
+    }
+    result.on_time_goodput = config_.duration_seconds > 0
+        ? static_cast<double>(completed_in_window - late_in_window) / config_.duration_seconds
+        : 0.0;
+    for (const auto& node : nodes) {
+        result.tasks_parked += node->getParkedTaskCount();
+    }
+    for (size_t r = 0; r < RESOURCE_COUNT && utilization_samples > 0; ++r) {
+        result.mean_utilization[r] = utilization_sum[r] / utilization_samples;
+    }
+    result.cross_zone_transfers = static_cast<int>(network_manager->getCrossZoneTransfers());
+    result.messages_dropped = network_manager->getMessagesDropped();
+    result.messages_delayed = network_manager->getMessagesDelayed();
+    result.rate_limit_delay_seconds = network_manager->getRateLimitDelaySeconds();
+    result.mean_latency_ms = metrics.getMeanLatency();
+    result.p50_latency_ms = metrics.getLatencyPercentile(50);
+    result.p99_latency_ms = metrics.getLatencyPercentile(99);
+    result.short_p99_latency_ms = metrics.getLatencyPercentile(99, 0, config_.max_task_complexity);
+    if (config_.long_task_fraction > 0.0) {
+        result.long_p99_latency_ms = metrics.getLatencyPercentile(
+            99, config_.max_task_complexity + 1, config_.long_task_complexity);
+    }
+
+    if (config_.verbose) {
+        std::cout << std::endl;
+        std::cout << "==================================================" << std::endl;
+        std::cout << "Final Statistics:" << std::endl;
+        std::cout << "==================================================" << std::endl;
+
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            std::cout << "Node " << nodes[i]->getId() << ": "
+                      << "Processed=" << result.processed_per_node[i] << ", "
+                      << "Remaining=" << result.remaining_per_node[i] << std::endl;
+        }
+
+        std::cout << "--------------------------------------------------" << std::endl;
+        std::cout << "Total tasks generated: " << result.tasks_generated << std::endl;
+        std::cout << "Total tasks processed: " << result.tasks_processed << std::endl;
+        std::cout << "Total tasks remaining: " << result.tasks_remaining << std::endl;
+        if (result.admission_rejects + result.overflow_rejects > 0) {
+            std::cout << "Total tasks rejected: "
+                      << (result.admission_rejects + result.overflow_rejects) << std::endl;
+        }
+        std::cout << "Latency p50/p99: " << result.p50_latency_ms << "ms / "
+                  << result.p99_latency_ms << "ms" << std::endl;
+        std::cout << "Work conservation: " << result.work_conservation << "% ("
+                  << result.idle_while_waiting_seconds
+                  << " worker-seconds idle while tasks waited elsewhere)" << std::endl;
+        std::cout << "==================================================" << std::endl;
+    }
+
+    Logger::getInstance().log("=== Final Statistics ===");
+    Logger::getInstance().log("Total tasks generated: " + std::to_string(result.tasks_generated));
+    Logger::getInstance().log("Total tasks processed: " + std::to_string(result.tasks_processed));
+    Logger::getInstance().log("Total tasks remaining: " + std::to_string(result.tasks_remaining));
+    Logger::getInstance().log("Work conservation: " + std::to_string(result.work_conservation) + "%");
+
+    // Stop all nodes
+    if (config_.verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping all nodes..." << std::endl;
+    }
+    network_manager->stop();  // No deliveries into nodes being torn down
+    for (auto& node : nodes) {
+        node->stop();
+    }
+
+    // Audit once quiescent: whatever is still held counts as in flight
+    if (audit) {
+        for (const auto& node : nodes) {
+            for (int task_id : node->getHeldTaskIds()) {
+                audit->markHeld(task_id);
+            }
+        }
+        result.audit = audit->report();
+        auto idList = [](const std::vector<int>& ids) {
+            std::string list;
+            for (int id : ids) {
+                list += (list.empty() ? "" : ", ") + std::to_string(id);
+            }
+            return list;
+        };
+        Logger::getInstance().log("Audit: " + std::to_string(result.audit.created) + " created, " +
+                                  std::to_string(result.audit.completed) + " completed, " +
+                                  std::to_string(result.audit.duplicated) + " duplicated, " +
+                                  std::to_string(result.audit.shed) + " shed, " +
+                                  std::to_string(result.audit.in_flight) + " in flight, " +
+                                  std::to_string(result.audit.lost) + " lost");
+        if (!result.audit.lost_ids.empty()) {
+            Logger::getInstance().log("Audit: lost task IDs include " + idList(result.audit.lost_ids));
+        }
+        if (!result.audit.duplicated_ids.empty()) {
+            Logger::getInstance().log("Audit: duplicated task IDs include " +
+                                      idList(result.audit.duplicated_ids));
+        }
+        if (config_.verbose) {
+            std::cout << "Exactly-once audit: " << result.audit.completed << " completed ("
+                      << result.audit.duplicated << " more than once), " << result.audit.shed
+                      << " shed, " << result.audit.in_flight << " in flight, "
+                      << result.audit.lost << " lost" << std::endl;
+        }
+    }
+
+    return result;
+}
@@ -1,9 +1,17 @@
 #include "Task.h"
 #include <thread>
+#include <algorithm>
 
 Task::Task(int id, int complexity)
-    : id_(id), complexity_(complexity), 
-      creation_time_(std::chrono::steady_clock::now()) {
+    : Task(id, complexity, ResourceVector{1.0, 0.0, 0.0}) {
+}
+
+Task::Task(int id, int complexity, const ResourceVector& demand)
+    : id_(id), complexity_(complexity), migrations_(0), last_sender_(-1), previous_sender_(-1),
+      demand_(demand), remaining_ms_(complexity), priority_level_(0), content_key_(0),
+      input_transfer_ms_(0), inputs_fetched_(false), critical_path_ms_(0),
+      creation_time_(std::chrono::steady_clock::now()),
+      deadline_(std::chrono::steady_clock::time_point::max()) {
 }
 
 int Task::getId() const {
@@ -18,7 +26,140 @@ std::chrono::steady_clock::time_point Task::getCreationTime() const {
     return creation_time_;
 }
 
+void Task::setCreationTime(std::chrono::steady_clock::time_point created) {
+    creation_time_ = created;
+}
+
+const ResourceVector& Task::getDemand() const {
+    return demand_;
+}
+
 void Task::execute() {
     // Simulate task execution with sleep
-    std::this_thread::sleep_for(std::chrono::milliseconds(complexity_));
+    std::this_thread::sleep_for(std::chrono::milliseconds(remaining_ms_));
+    remaining_ms_ = 0;
+}
+
+int Task::executeSlice(int quantum_ms) {
+    int slice = std::min(quantum_ms, remaining_ms_);
+    std::this_thread::sleep_for(std::chrono::milliseconds(slice));
+    remaining_ms_ -= slice;
+    return slice;
+}
+
+int Task::getRemainingWork() const {
+    return remaining_ms_;
+}
+
+bool Task::isFinished() const {
+    return remaining_ms_ <= 0;
+}
+
+int Task::getPriorityLevel() const {
+    return priority_level_;
+}
+
+void Task::demote() {
+    priority_level_++;
+}
+
+void Task::resetPriority() {
+    priority_level_ = 0;
+}
+
+void Task::addDependency(int predecessor_id) {
+    dependencies_.push_back(predecessor_id);
+}
+
+const std::vector<int>& Task::getDependencies() const {
+    return dependencies_;
+}
+
+void Task::addSuccessor(int successor_id, int home_node) {
+    successors_.emplace_back(successor_id, home_node);
+}
+
+const std::vector<std::pair<int, int>>& Task::getSuccessors() const {
+    return successors_;
+}
+
+void Task::addInputNode(int node_id) {
+    input_nodes_.push_back(node_id);
+}
+
+const std::vector<int>& Task::getInputNodes() const {
+    return input_nodes_;
+}
+
+void Task::setInputTransferMs(int ms) {
+    input_transfer_ms_ = ms;
+}
+
+int Task::inputFetchCost(int node_id) const {
+    int remote = static_cast<int>(std::count_if(input_nodes_.begin(), input_nodes_.end(),
+                                                [node_id](int n) { return n != node_id; }));
+    return remote * input_transfer_ms_;
+}
+
+int Task::fetchInputs(int node_id) {
+    if (inputs_fetched_) {
+        return 0;
+    }
+    inputs_fetched_ = true;
+    
+    int fetch_ms = inputFetchCost(node_id);
+    if (fetch_ms > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(fetch_ms));
+    }
+    return fetch_ms;
+}
+
+void Task::setContentKey(uint64_t key) {
+    content_key_ = key;
+}
+
+uint64_t Task::getContentKey() const {
+    return content_key_;
+}
+
+void Task::setDeadline(std::chrono::steady_clock::time_point deadline) {
+    deadline_ = deadline;
+}
+
+bool Task::hasDeadline() const {
+    return deadline_ != std::chrono::steady_clock::time_point::max();
+}
+
+std::chrono::steady_clock::time_point Task::getDeadline() const {
+    return deadline_;
+}
+
+bool Task::isExpired(std::chrono::steady_clock::time_point now) const {
+    return now > deadline_;
+}
+
+void Task::setCriticalPath(int ms) {
+    critical_path_ms_ = ms;
+}
+
+int Task::getCriticalPath() const {
+    return critical_path_ms_;
+}
+
+void Task::recordMigration(int from_node) {
+    migrations_++;
+    previous_sender_ = last_sender_;
+    last_sender_ = from_node;
+}
+
+int Task::getMigrationCount() const {
+    return migrations_;
+}
+
+int Task::getLastSender() const {
+    return last_sender_;
+}
+
+int Task::getPreviousSender() const {
+    return previous_sender_;
 }
@@ -0,0 +1,123 @@
+#include "TaskAudit.h"
+
+const size_t REPORT_SAMPLE_IDS = 10;  // Lost/duplicated IDs kept for the log
+
+TaskAudit::TaskAudit()
+    : chunks_(new std::atomic<Chunk*>[MAX_CHUNKS]), allocated_chunks_(0) {
+    for (size_t i = 0; i < MAX_CHUNKS; ++i) {
+        chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+TaskAudit::~TaskAudit() {
+    for (size_t i = 0; i < MAX_CHUNKS; ++i) {
+        delete chunks_[i].load();
+    }
+}
+
+TaskAudit::Chunk* TaskAudit::chunkFor(int task_id) {
+    if (task_id < 0) {
+        return nullptr;
+    }
+    std::atomic<Chunk*>& slot = chunks_[static_cast<size_t>(task_id) >> CHUNK_SHIFT];
+    Chunk* chunk = slot.load(std::memory_order_acquire);
+    if (chunk) {
+        return chunk;
+    }
+
+    // Value-initialized: every word starts at zero
+    Chunk* fresh = new Chunk();
+    if (slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+        allocated_chunks_++;
+        return fresh;
+    }
+    delete fresh;  // Another thread won the race; chunk holds its pointer
+    return chunk;
+}
+
+std::atomic<uint64_t>* TaskAudit::wordFor(Bitmap bitmap, int task_id, uint64_t& bit) {
+    Chunk* chunk = chunkFor(task_id);
+    if (!chunk) {
+        return nullptr;
+    }
+    size_t offset = static_cast<size_t>(task_id) & ((size_t(1) << CHUNK_SHIFT) - 1);
+    bit = uint64_t(1) << (offset % 64);
+    return &chunk->words[bitmap][offset / 64];
+}
+
+bool TaskAudit::setBit(Bitmap bitmap, int task_id) {
+    uint64_t bit;
+    std::atomic<uint64_t>* word = wordFor(bitmap, task_id, bit);
+    return word && (word->fetch_or(bit, std::memory_order_relaxed) & bit) != 0;
+}
+
+void TaskAudit::markCreated(int task_id) {
+    setBit(CREATED, task_id);
+}
+
+void TaskAudit::markCompleted(int task_id) {
+    if (setBit(COMPLETED, task_id)) {
+        setBit(DUPLICATED, task_id);
+    }
+}
+
+void TaskAudit::markShed(int task_id) {
+    setBit(SHED, task_id);
+}
+
+void TaskAudit::markTransit(int task_id) {
+    uint64_t bit;
+    std::atomic<uint64_t>* word = wordFor(TRANSIT, task_id, bit);
+    if (word) {
+        word->fetch_xor(bit, std::memory_order_relaxed);  // Send and receipt cancel out
+    }
+}
+
+void TaskAudit::markHeld(int task_id) {
+    setBit(HELD, task_id);
+}
+
+AuditReport TaskAudit::report() const {
+    AuditReport report;
+    auto sample = [](uint64_t word, size_t base, std::vector<int>& ids) {
+        for (; word != 0 && ids.size() < REPORT_SAMPLE_IDS; word &= word - 1) {
+            ids.push_back(static_cast<int>(base + __builtin_ctzll(word)));
+        }
+    };
+
+    for (size_t c = 0; c < MAX_CHUNKS; ++c) {
+        const Chunk* chunk = chunks_[c].load(std::memory_order_acquire);
+        if (!chunk) {
+            continue;
+        }
+        for (size_t w = 0; w < CHUNK_WORDS; ++w) {
+            uint64_t created = chunk->words[CREATED][w].load(std::memory_order_relaxed);
+            if (created == 0) {
+                continue;
+            }
+            uint64_t completed = created & chunk->words[COMPLETED][w].load(std::memory_order_relaxed);
+            uint64_t duplicated = created & chunk->words[DUPLICATED][w].load(std::memory_order_relaxed);
+            uint64_t open = created & ~completed;
+            uint64_t shed = open & chunk->words[SHED][w].load(std::memory_order_relaxed);
+            open &= ~shed;
+            uint64_t in_flight = open & (chunk->words[TRANSIT][w].load(std::memory_order_relaxed) |
+                                         chunk->words[HELD][w].load(std::memory_order_relaxed));
+            uint64_t lost = open & ~in_flight;
+
+            report.created += __builtin_popcountll(created);
+            report.completed += __builtin_popcountll(completed);
+            report.duplicated += __builtin_popcountll(duplicated);
+            report.shed += __builtin_popcountll(shed);
+            report.in_flight += __builtin_popcountll(in_flight);
+            report.lost += __builtin_popcountll(lost);
+            size_t base = (c << CHUNK_SHIFT) + w * 64;
+            sample(lost, base, report.lost_ids);
+            sample(duplicated, base, report.duplicated_ids);
+        }
+    }
+    return report;
+}
+
+size_t TaskAudit::getAllocatedBytes() const {
+    return allocated_chunks_.load() * sizeof(Chunk);
+}
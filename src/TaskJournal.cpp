@@ -0,0 +1,399 @@
+#include "TaskJournal.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char JOURNAL_MAGIC[8] = {'L', 'B', 'J', 'R', 'N', 'L', '0', '2'};
+const size_t INITIAL_FILE_BYTES = 64 * 1024;
+const size_t MAX_GROUP_BYTES = 64 * 1024;  // Commit early once a group is this big
+
+// FNV-1a, enough to tell a torn or never-written record from a valid one
+static uint32_t checksum(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// A rename is only durable once the directory entry itself is on disk
+static bool syncParentDirectory(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int dir_fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd < 0) {
+        return false;
+    }
+    bool synced = fsync(dir_fd) == 0;
+    close(dir_fd);
+    return synced;
+}
+
+TaskJournal::TaskJournal(const std::string& path, int commit_interval_us, size_t compact_bytes)
+    : path_(path), commit_interval_us_(std::max(1, commit_interval_us)),
+      compact_bytes_(compact_bytes), fd_(-1), map_(nullptr), mapped_bytes_(0), used_bytes_(0),
+      flush_requested_(false), stopping_(false), abandoned_(false), appended_(0), committed_(0),
+      replayed_records_(0), replay_seconds_(0.0), commits_(0), compactions_(0) {
+    auto start = std::chrono::steady_clock::now();
+    if (openAndReplay()) {
+        committer_ = std::thread(&TaskJournal::commitLoop, this);
+    } else {
+        stopping_ = true;
+    }
+    replay_seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+TaskJournal::~TaskJournal() {
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        stopping_ = true;
+    }
+    commit_cv_.notify_one();
+    if (committer_.joinable()) {
+        committer_.join();  // Commits the last group unless abandoned
+    }
+    if (map_) {
+        munmap(map_, mapped_bytes_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+bool TaskJournal::isOpen() const {
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    return !stopping_;
+}
+
+void TaskJournal::append(const JournalRecord& record) {
+    uint8_t bytes[RECORD_BYTES];
+    encode(record, bytes);
+
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        if (stopping_) {
+            return;
+        }
+        buffer_.insert(buffer_.end(), bytes, bytes + RECORD_BYTES);
+        applyLocked(record);
+        appended_++;
+        full = buffer_.size() >= MAX_GROUP_BYTES;
+    }
+    if (full) {
+        commit_cv_.notify_one();
+    }
+}
+
+void TaskJournal::abandon() {
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        stopping_ = true;
+        abandoned_ = true;
+        buffer_.clear();
+    }
+    commit_cv_.notify_one();
+    synced_cv_.notify_all();
+    if (committer_.joinable()) {
+        committer_.join();
+    }
+}
+
+void TaskJournal::sync() {
+    std::unique_lock<std::mutex> lock(buffer_mutex_);
+    long long target = appended_;
+    flush_requested_ = true;
+    commit_cv_.notify_one();
+    synced_cv_.wait(lock, [this, target] { return committed_ >= target || stopping_; });
+}
+
+std::vector<JournalRecord> TaskJournal::liveTasks() const {
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    std::vector<JournalRecord> tasks;
+    tasks.reserve(live_.size());
+    for (const auto& entry : live_) {
+        tasks.push_back(entry.second);
+    }
+    return tasks;
+}
+
+std::map<int, int> TaskJournal::transfers() const {
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    return transfers_;
+}
+
+int TaskJournal::getReplayedRecords() const {
+    return replayed_records_;
+}
+
+double TaskJournal::getReplaySeconds() const {
+    return replay_seconds_;
+}
+
+long long TaskJournal::getCommits() const {
+    return commits_.load();
+}
+
+long long TaskJournal::getCommittedRecords() const {
+    return committed_.load();
+}
+
+int TaskJournal::getCompactions() const {
+    return compactions_.load();
+}
+
+size_t TaskJournal::getFileBytes() const {
+    return used_bytes_.load();
+}
+
+bool TaskJournal::openAndReplay() {
+    fd_ = open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat info;
+    if (fd_ < 0 || fstat(fd_, &info) != 0) {
+        Logger::getInstance().log("TaskJournal: cannot open " + path_ + ": " + std::strerror(errno));
+        return false;
+    }
+    size_t file_bytes = static_cast<size_t>(info.st_size);
+    if (!ensureCapacity(std::max(file_bytes, INITIAL_FILE_BYTES))) {
+        return false;
+    }
+
+    if (file_bytes < HEADER_BYTES) {
+        std::memset(map_, 0, HEADER_BYTES);
+        std::memcpy(map_, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    } else if (std::memcmp(map_, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        Logger::getInstance().log("TaskJournal: " + path_ + " is not a task journal");
+        return false;
+    }
+
+    size_t offset = HEADER_BYTES;
+    JournalRecord record;
+    while (offset + RECORD_BYTES <= mapped_bytes_ && decode(map_ + offset, record)) {
+        applyLocked(record);
+        offset += RECORD_BYTES;
+        replayed_records_++;
+    }
+    // Anything past the last valid record is a torn tail or never written;
+    // zero it so a later replay cannot resume into stale bytes
+    std::memset(map_ + offset, 0, mapped_bytes_ - offset);
+    used_bytes_ = offset;
+    return true;
+}
+
+bool TaskJournal::ensureCapacity(size_t bytes) {
+    if (map_ && bytes <= mapped_bytes_) {
+        return true;
+    }
+    size_t new_size = std::max(mapped_bytes_, INITIAL_FILE_BYTES);
+    while (new_size < bytes) {
+        new_size *= 2;
+    }
+
+    if (ftruncate(fd_, static_cast<off_t>(new_size)) != 0) {
+        Logger::getInstance().log("TaskJournal: cannot grow " + path_ + ": " + std::strerror(errno));
+        return false;
+    }
+    if (map_) {
+        munmap(map_, mapped_bytes_);
+        map_ = nullptr;
+    }
+    void* mapping = mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        Logger::getInstance().log("TaskJournal: cannot map " + path_ + ": " + std::strerror(errno));
+        mapped_bytes_ = 0;
+        return false;
+    }
+    map_ = static_cast<uint8_t*>(mapping);
+    mapped_bytes_ = new_size;
+    return true;
+}
+
+void TaskJournal::commitLoop() {
+    std::vector<uint8_t> group;
+    while (true) {
+        bool stop;
+        long long appended;
+        size_t live_bytes;
+        {
+            std::unique_lock<std::mutex> lock(buffer_mutex_);
+            commit_cv_.wait_for(lock, std::chrono::microseconds(commit_interval_us_), [this] {
+                return stopping_ || flush_requested_ || buffer_.size() >= MAX_GROUP_BYTES;
+            });
+            if (abandoned_) {
+                return;  // Crash: the buffered group is gone
+            }
+            stop = stopping_;
+            flush_requested_ = false;
+            group.swap(buffer_);
+            appended = appended_;
+            live_bytes = HEADER_BYTES + live_.size() * RECORD_BYTES;
+        }
+
+        if (!group.empty()) {
+            commitGroup(group);
+            group.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(buffer_mutex_);
+            committed_ = appended;
+        }
+        synced_cv_.notify_all();
+
+        if (!stop && compact_bytes_ > 0 && used_bytes_ >= compact_bytes_ &&
+            live_bytes * 2 <= used_bytes_) {
+            compact();
+        }
+        if (stop) {
+            return;
+        }
+    }
+}
+
+void TaskJournal::commitGroup(const std::vector<uint8_t>& group) {
+    size_t offset = used_bytes_;
+    if (!ensureCapacity(offset + group.size())) {
+        return;
+    }
+    std::memcpy(map_ + offset, group.data(), group.size());
+
+    // msync wants a page-aligned start
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = offset / page * page;
+    msync(map_ + start, offset + group.size() - start, MS_SYNC);
+    used_bytes_ = offset + group.size();
+    commits_++;
+}
+
+void TaskJournal::compact() {
+    std::vector<JournalRecord> live;
+    std::vector<uint8_t> superseded;
+    std::map<int, int> transfers;
+    long long appended;
+    {
+        // Buffered records are already folded into live_, so the image
+        // supersedes them; forwarding records start over. Both are set
+        // aside, not dropped, until the new file is in place
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        live.reserve(live_.size());
+        for (const auto& entry : live_) {
+            live.push_back(entry.second);
+        }
+        superseded.swap(buffer_);
+        transfers.swap(transfers_);
+        appended = appended_;
+    }
+
+    // Encoded without the lock: appenders only wait for the copy above
+    std::vector<uint8_t> image(HEADER_BYTES + live.size() * RECORD_BYTES, 0);
+    std::memcpy(image.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    for (size_t i = 0; i < live.size(); ++i) {
+        encode(live[i], image.data() + HEADER_BYTES + i * RECORD_BYTES);
+    }
+
+    std::string tmp_path = path_ + ".compact";
+    int tmp_fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    bool written = tmp_fd >= 0 &&
+                   write(tmp_fd, image.data(), image.size()) == static_cast<ssize_t>(image.size()) &&
+                   fsync(tmp_fd) == 0;
+    if (tmp_fd >= 0) {
+        close(tmp_fd);
+    }
+    if (!written || rename(tmp_path.c_str(), path_.c_str()) != 0) {
+        // The old file stays valid: put the set-aside records back in
+        // front of anything appended since, in their original order
+        Logger::getInstance().log("TaskJournal: compaction of " + path_ + " failed");
+        unlink(tmp_path.c_str());
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        superseded.insert(superseded.end(), buffer_.begin(), buffer_.end());
+        buffer_.swap(superseded);
+        transfers_.insert(transfers.begin(), transfers.end());  // Newer entries win
+        return;
+    }
+    if (!syncParentDirectory(path_)) {
+        Logger::getInstance().log("TaskJournal: cannot sync the directory of " + path_ + ": " +
+                                  std::strerror(errno));
+    }
+
+    munmap(map_, mapped_bytes_);
+    close(fd_);
+    map_ = nullptr;
+    mapped_bytes_ = 0;
+    fd_ = open(path_.c_str(), O_RDWR);
+    if (fd_ < 0 || !ensureCapacity(std::max(image.size(), INITIAL_FILE_BYTES))) {
+        Logger::getInstance().log("TaskJournal: cannot reopen " + path_ + " after compaction");
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        stopping_ = true;
+        return;
+    }
+    used_bytes_ = image.size();
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        committed_ = std::max(committed_.load(), appended);
+    }
+    synced_cv_.notify_all();
+    compactions_++;
+}
+
+void TaskJournal::applyLocked(const JournalRecord& record) {
+    switch (record.type) {
+        case JournalRecordType::ENQUEUE:
+            live_[record.task_id] = record;
+            break;
+        case JournalRecordType::DEQUEUE:
+            live_.erase(record.task_id);
+            break;
+        case JournalRecordType::TRANSFER:
+            live_.erase(record.task_id);
+            transfers_[record.task_id] = record.peer;
+            break;
+    }
+}
+
+void TaskJournal::encode(const JournalRecord& record, uint8_t* out) {
+    std::memset(out, 0, RECORD_BYTES);
+    int32_t fields[3] = {record.task_id, record.work_ms, record.peer};
+    float demand[RESOURCE_COUNT];
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        demand[r] = static_cast<float>(record.demand[r]);
+    }
+    out[4] = static_cast<uint8_t>(record.type);
+    std::memcpy(out + 8, fields, sizeof(fields));
+    std::memcpy(out + 24, &record.content_key, sizeof(record.content_key));
+    std::memcpy(out + 32, demand, sizeof(demand));
+    std::memcpy(out + 48, &record.created_us, sizeof(record.created_us));
+    std::memcpy(out + 56, &record.deadline_us, sizeof(record.deadline_us));
+    uint32_t sum = checksum(out + 4, RECORD_BYTES - 4);
+    std::memcpy(out, &sum, sizeof(sum));
+}
+
+bool TaskJournal::decode(const uint8_t* in, JournalRecord& record) {
+    uint32_t sum;
+    std::memcpy(&sum, in, sizeof(sum));
+    if (in[4] < static_cast<uint8_t>(JournalRecordType::ENQUEUE) ||
+        in[4] > static_cast<uint8_t>(JournalRecordType::TRANSFER) ||
+        sum != checksum(in + 4, RECORD_BYTES - 4)) {
+        return false;
+    }
+
+    int32_t fields[3];
+    float demand[RESOURCE_COUNT];
+    record.type = static_cast<JournalRecordType>(in[4]);
+    std::memcpy(fields, in + 8, sizeof(fields));
+    std::memcpy(&record.content_key, in + 24, sizeof(record.content_key));
+    std::memcpy(demand, in + 32, sizeof(demand));
+    std::memcpy(&record.created_us, in + 48, sizeof(record.created_us));
+    std::memcpy(&record.deadline_us, in + 56, sizeof(record.deadline_us));
+    record.task_id = fields[0];
+    record.work_ms = fields[1];
+    record.peer = fields[2];
+    for (size_t r = 0; r < RESOURCE_COUNT; ++r) {
+        record.demand[r] = demand[r];
+    }
+    return true;
+}
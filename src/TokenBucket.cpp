@@ -0,0 +1,40 @@
+#include "TokenBucket.h"
+#include <algorithm>
+
+TokenBucket::TokenBucket(double rate_per_sec, double burst)
+    : rate_per_sec_(rate_per_sec),
+      burst_(std::max(1.0, burst)),
+      tokens_(std::max(1.0, burst)),
+      last_refill_(std::chrono::steady_clock::now()) {
+}
+
+bool TokenBucket::tryConsume() {
+    refill();
+    if (tokens_ < 1.0) {
+        return false;
+    }
+    tokens_ -= 1.0;
+    return true;
+}
+
+std::chrono::steady_clock::duration TokenBucket::reserve() {
+    refill();
+    tokens_ -= 1.0;
+    if (tokens_ >= 0.0) {
+        return std::chrono::steady_clock::duration::zero();
+    }
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(-tokens_ / rate_per_sec_));
+}
+
+bool TokenBucket::available() {
+    refill();
+    return tokens_ >= 1.0;
+}
+
+void TokenBucket::refill() {
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+    tokens_ = std::min(burst_, tokens_ + elapsed * rate_per_sec_);
+    last_refill_ = now;
+}